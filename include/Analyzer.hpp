@@ -25,6 +25,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <string>
 
 #include "Graph.hpp"
+#include "FrozenGraph.hpp"
 
 namespace inlining {
 
@@ -38,7 +39,7 @@ class Infos;
 struct LibraryIssue {
     Function src;                               /*!< The function that initiates the heavy call site  */
     Function dest;                              /*!< The target function  */
-    std::vector<std::vector<CallSite>> paths;   /*!< All the problematic paths from dest to src  */
+    std::vector<std::vector<FrozenCallSite>> paths;   /*!< All the problematic paths from dest to src  */
     std::vector<std::string> solutions;         /*!< The proposed solutions for this issue  */
     unsigned long benefit;                      /*!< The benefit */
 
@@ -50,7 +51,7 @@ struct LibraryIssue {
      * \param p_solutions The proposed solutions for this issue
      * \param b The benefit
     */
-    LibraryIssue(Function p_src, Function p_dest, std::vector<std::vector<CallSite>> p_paths, std::vector<std::string> p_solutions, unsigned long b) : src(p_src), dest(p_dest), paths(p_paths), solutions(p_solutions), benefit(b) {}
+    LibraryIssue(Function p_src, Function p_dest, std::vector<std::vector<FrozenCallSite>> p_paths, std::vector<std::string> p_solutions, unsigned long b) : src(p_src), dest(p_dest), paths(p_paths), solutions(p_solutions), benefit(b) {}
 };
 
 /*!
@@ -58,7 +59,7 @@ struct LibraryIssue {
  * \brief Structure containing the information about a cluster
 */
 struct Cluster {
-    std::vector<CallSite> callSites;        /*!< The call sites of the cluster  */
+    std::vector<FrozenCallSite> callSites;        /*!< The call sites of the cluster  */
     double temperature;                     /*!< The temperature of this cluster  */
 
     /*!
@@ -66,7 +67,7 @@ struct Cluster {
      * \param cs The call sites of the cluster
      * \param t The temperature of this cluster
     */
-    Cluster(std::vector<CallSite> cs, double t) : callSites(cs), temperature(t) {}
+    Cluster(std::vector<FrozenCallSite> cs, double t) : callSites(cs), temperature(t) {}
 };
 
 /*!
@@ -96,12 +97,21 @@ struct HierarchyIssue {
 class Analyzer {
     public:
         /**
-         * Construct an analyzer for th given call graph
+         * Construct an analyzer for th given call graph. The call graph is frozen, it must not be modified afterwards.
          *
          * \param g The call graph to analyze.
          * \param i The infos to use for the analysis.
          */
-        Analyzer(CallGraph& g, Infos& i) : graph(g), infos(i), filterDuplicates(false) {}
+        Analyzer(CallGraph& g, Infos& i);
+
+        /*!
+         * \brief Return the fields of the functions and call sites read by the analysis. The temperatures only depend
+         * on the calls, through the frequencies.
+         * \return The fields used by the analyzer (a combination of GraphField)
+         */
+        static unsigned int requiredFields() {
+            return FUNCTION_CALLS | CALL_SITE_CALLS;
+        }
 
         /**
          * \brief launch the analyze on the call graph
@@ -123,16 +133,16 @@ class Analyzer {
         /**
          * \brief Find every call site between two different libraries
          *
-         * \return a vector containing all the call sites between two different libraries
+         * \return a vector containing all the call sites between two different libraries, as call sites of the frozen graph
          */
-        std::vector<CallSite> findInterLibraryCalls() const;
+        std::vector<FrozenCallSite> findInterLibraryCalls() const;
 
         /**
          * \brief Find every virtual call sites.
          *
-         * \return a vector containing all the virtual call sites
+         * \return a vector containing all the virtual call sites, as call sites of the frozen graph
          */
-        std::vector<CallSite> findVirtualCalls() const;
+        std::vector<FrozenCallSite> findVirtualCalls() const;
 
         /**
          * \brief Find all the function called only once
@@ -158,7 +168,7 @@ class Analyzer {
         /**
          * \brief Find hot clusters.
          *
-         * \return A vector containing all the clusters (vector of CallSite)
+         * \return A vector containing all the clusters (vector of FrozenCallSite)
          */
         std::vector<Cluster> findClusters() const;
 
@@ -188,20 +198,21 @@ class Analyzer {
         /**
          * \brief Compute the temperature of the given call site.
          *
-         * \param  site The call site descriptor.
+         * \param  site The call site of the frozen graph.
          *
          * \return The temperature of the call site.
          */
-        void computeCallSiteTemperature(CallSite site);
+        void computeCallSiteTemperature(FrozenCallSite site);
 
     private:
         CallGraph& graph;
+        FrozenGraph& frozen;
         Infos& infos;
 
         std::set<std::string> protectedLibraries;
         bool filterDuplicates;
 
-        unsigned long computeSolutions(Function src, Function dest, const std::vector<std::vector<CallSite>>& paths, std::vector<std::string>& solutions) const;
+        unsigned long computeSolutions(Function src, Function dest, const std::vector<std::vector<FrozenCallSite>>& paths, std::vector<std::string>& solutions) const;
         void computeSolution(std::vector<std::string>& solutions, std::set<std::string>& libraryFilters, const std::string& function, const std::string& library, unsigned long benefit, unsigned long& total) const;
 };
 
@@ -0,0 +1,111 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+namespace inlining {
+
+/*!
+ * \class BoundedQueue
+ * \brief A blocking queue with a maximum capacity to connect the stages of a pipeline.
+ *
+ * The producer is blocked when the queue is full, the consumer is blocked when the queue is empty. Once the producer
+ * closes the queue, the consumer gets the remaining elements and is then notified of the end of the stream.
+ */
+template<typename T>
+class BoundedQueue {
+    public:
+        /*!
+         * \brief Construct a new queue.
+         * \param c The maximum number of elements in the queue
+         */
+        explicit BoundedQueue(size_t c) : capacity(c == 0 ? 1 : c), closed(false) {}
+
+        /*!
+         * \brief Add an element at the end of the queue, waiting for free space if necessary.
+         * \param value The element to add
+         */
+        void push(T value) {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            notFull.wait(lock, [this](){ return elements.size() < capacity; });
+
+            elements.push_back(std::move(value));
+
+            notEmpty.notify_one();
+        }
+
+        /*!
+         * \brief Remove the first element of the queue, waiting for an element if necessary.
+         * \param value The element to fill
+         * \return true if an element has been removed, false if the queue is closed and empty
+         */
+        bool pop(T& value) {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            notEmpty.wait(lock, [this](){ return !elements.empty() || closed; });
+
+            if (elements.empty()) {
+                return false;
+            }
+
+            value = std::move(elements.front());
+            elements.pop_front();
+
+            notFull.notify_one();
+
+            return true;
+        }
+
+        /*!
+         * \brief Indicate that no more elements will be added.
+         */
+        void close() {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            closed = true;
+
+            notEmpty.notify_all();
+        }
+
+    private:
+        const size_t capacity;
+        bool closed;
+
+        std::deque<T> elements;
+
+        std::mutex mutex;
+        std::condition_variable notFull;
+        std::condition_variable notEmpty;
+
+        //Not copyable
+        BoundedQueue(const BoundedQueue&);
+        BoundedQueue& operator=(const BoundedQueue&);
+};
+
+} //end of inlining
+
+#endif
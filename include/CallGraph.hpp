@@ -22,22 +22,41 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define CALL_GRAPH_H
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include "Graph.hpp"
+#include "CallSiteTable.hpp"
+#include "CompressedNames.hpp"
 
 namespace inlining {
 
+class FrozenGraph;
+
+/*!
+ * \struct RawLabel
+ * \brief The position of a label in the label buffer of a call graph.
+ */
+struct RawLabel {
+    size_t offset;      /*!< The position of the first character in the buffer */
+    size_t size;        /*!< The number of characters */
+};
+
 /*!
  * \class CallGraph
  * \brief A call graph
+ *
+ * The functions are the vertices of a Graph, the call sites are stored in a call site table. The call sites of the graph
+ * given to the constructor are moved in the table, the graph then only keeps the functions.
  */
 class CallGraph {
     public:
         /*!
-         * \brief Create a new call graph from a Graph
-         * \param g The graph to create the call graph from
+         * \brief Create a new call graph from a Graph. The call sites of the graph are moved in the call site table, with
+         * their labels.
+         * \param g The graph to create the call graph from, it belongs to the call graph
         */
-        explicit CallGraph(Graph* g) : graph(g) {}
+        explicit CallGraph(Graph* g);
 
         /*!
          * \brief Destroy the call graph and release the resources
@@ -57,16 +76,20 @@ class CallGraph {
         std::pair<FunctionIterator, FunctionIterator> functions() const;
 
         /*!
-         * \brief Return iterators to the call sites of the call graph
-         * \return a pair of iterators to the call sites, the first element of the pair is the begin iterator and the second one is the end iterator
+         * \brief Return the call sites of the call graph
+         * \return The call site table of the call graph
         */
-        std::pair<CallSiteIterator, CallSiteIterator> callSites();
+        CallSiteTable& callSites() {
+            return table;
+        }
 
         /*!
-         * \brief Return iterators to the call sites of the call graph
-         * \return a pair of iterators to the call sites, the first element of the pair is the begin iterator and the second one is the end iterator
+         * \brief Return the call sites of the call graph
+         * \return The call site table of the call graph
         */
-        std::pair<CallSiteIterator, CallSiteIterator> callSites() const;
+        const CallSiteTable& callSites() const {
+            return table;
+        }
 
         /*!
          * \brief Return the intern graph
@@ -89,7 +112,7 @@ class CallGraph {
          * \param callSite the call site to get the description for
          * \return The description of the given call site
         */
-        std::string getDescription(CallSite callSite) const;
+        std::string getDescription(FrozenCallSite callSite) const;
 
         /*!
          * \brief Set the total number of calls of the call graph
@@ -132,8 +155,8 @@ class CallGraph {
          * \param callSite The call site to search the source of
          * \return The source function of the call site
         */
-        Function source(CallSite callSite) const {
-            return boost::source(callSite, *graph);
+        Function source(FrozenCallSite callSite) const {
+            return table.source(callSite);
         }
 
         /*!
@@ -141,8 +164,8 @@ class CallGraph {
          * \param callSite The call site to search the target of
          * \return The target function of the call site
         */
-        Function target(CallSite callSite) const {
-            return boost::target(callSite, *graph);
+        Function target(FrozenCallSite callSite) const {
+            return table.target(callSite);
         }
 
         /*!
@@ -164,28 +187,177 @@ class CallGraph {
         }
 
         /*!
-         * \brief Return the call site information from the call site descriptor
-         * \param c the call site descriptor
-         * \return The call site information
+         * \brief Return the interned strings of the call graph (the modules and the file names of the functions).
+         * \return The strings of the graph
+        */
+        StringPool& strings() {
+            return stringsOf(*graph);
+        }
+
+        /*!
+         * \brief Return the interned strings of the call graph (the modules and the file names of the functions).
+         * \return The strings of the graph
+        */
+        const StringPool& strings() const {
+            return stringsOf(*graph);
+        }
+
+        /*!
+         * \brief Return the arena storing the names and the labels of the functions. The arena is freed at once with the
+         * graph.
+         * \return The arena of the graph
+        */
+        StringArena& arena() {
+            return arenaOf(*graph);
+        }
+
+        /*!
+         * \brief Return the name of a function, decoded from the name table if the names are compressed.
+         * \param f the function descriptor
+         * \return The name of the function
+        */
+        std::string nameOf(Function f) const {
+            return names.empty() ? (*graph)[f].name.str() : names[f];
+        }
+
+        /*!
+         * \brief Return the compressed names of the functions, empty if the names are not compressed.
+         * \return The name table of the graph
+        */
+        const CompressedNames& compressedNames() const {
+            return names;
+        }
+
+        /*!
+         * \brief Return the module of a function.
+         * \param f the function descriptor
+         * \return The shared object of the function
+        */
+        const std::string& moduleOf(Function f) const {
+            return stringsOf(*graph)[(*graph)[f].module];
+        }
+
+        /*!
+         * \brief Return the file name of a function.
+         * \param f the function descriptor
+         * \return The file the function has been defined in
+        */
+        const std::string& fileNameOf(Function f) const {
+            return stringsOf(*graph)[(*graph)[f].file_name];
+        }
+
+        /*!
+         * \brief Set the fields that have been decoded by the reader. The other fields are decoded on demand by
+         * decodeLabels(), from the raw labels or from the labels of the functions.
+         * \param fields The decoded fields (a combination of GraphField)
         */
-        edge_info& operator[](CallSite c) {
-            return (*graph)[c];
+        void setDecodedFields(unsigned int fields) {
+            decodedFields = fields;
         }
 
         /*!
-         * \brief Return the call site information from the call site descriptor
-         * \param c the call site descriptor
-         * \return The call site information
+         * \brief Return the fields that have been decoded.
+         * \return The decoded fields (a combination of GraphField)
         */
-        const edge_info& operator[](CallSite c) const {
-            return (*graph)[c];
+        unsigned int getDecodedFields() const {
+            return decodedFields;
+        }
+
+        /*!
+         * \brief Keep the labels of a graph read without copying them in the functions. The columns are consumed, they
+         * can be mapped from temporary files.
+         * \param buffer The characters of all the labels
+         * \param functions The label of each function, indexed by function, empty if the labels are kept in the functions
+         * \param callSites The label of each call site, indexed by call site
+        */
+        void setRawLabels(Column<char>& buffer, Column<RawLabel>& functions, Column<RawLabel>& callSites);
+
+        /*!
+         * \brief Decode the given fields if they have not already been decoded. The raw labels are released once all
+         * the fields are decoded.
+         * \param fields The fields that must be available (a combination of GraphField)
+        */
+        void decodeLabels(unsigned int fields);
+
+        /*!
+         * \brief Decode all the fields and forget the labels of the functions and call sites. The memory of the labels
+         * stored in the arena of the graph is only released with the graph.
+        */
+        void releaseLabels();
+
+        /*!
+         * \brief Renumber the functions of the call graph. The call sites are built again, numbered by their new
+         * caller. The labels are decoded first. Must be called before compressNames() and freeze().
+         * \param order The functions in their new order, the new identifier of a function is its index
+        */
+        void reorder(const std::vector<Function>& order);
+
+        /*!
+         * \brief Return the identifier a function had before the call graph was reordered.
+         * \param f the function descriptor
+         * \return The identifier of the function in the profile
+        */
+        Function originalFunction(Function f) const {
+            return originals.empty() ? f : originals[f];
+        }
+
+        /*!
+         * \brief Move the names of the functions in a front-coded name table and release the arena of the graph. The
+         * labels are released too, the names must then be read with nameOf().
+        */
+        void compressNames();
+
+        /*!
+         * \brief Set the memory the call site table built by reorder() and the frozen graph can each take on the heap.
+         * Larger columns are mapped from temporary files. Must be called before reorder() and freeze().
+         * \param bytes The maximal size of the call site table or of the frozen graph on the heap, 0 for no limit
+        */
+        void setMemoryCap(std::size_t bytes) {
+            memoryCap = bytes;
+        }
+
+        /*!
+         * \brief Build the frozen graph if it has not already been built. The fields of the functions are copied in
+         * columns, the call sites are read from the call site table. The call graph must not be modified afterwards,
+         * the frozen graph would not see the modifications. The columns are mapped from temporary files if they do not
+         * fit in the memory cap.
+         * \return The frozen graph
+         * \throw std::length_error If the call graph cannot be frozen, see canFreeze()
+        */
+        FrozenGraph& freeze();
+
+        /*!
+         * \brief Indicate if the call graph is small enough to be frozen with 32 bits indexes, its call sites must all be
+         * in the call site table.
+         * \return true if freeze() can be called
+        */
+        bool canFreeze() const;
+
+        /*!
+         * \brief Return the frozen graph, freeze() must have been called before.
+         * \return The frozen graph
+        */
+        const FrozenGraph& getFrozenGraph() const {
+            return *frozen;
         }
 
     private:
         Graph* graph;
+        CallSiteTable table;
 
         unsigned int calls;
         unsigned int applicationSize;
+
+        unsigned int decodedFields;
+        Column<char> labels;
+        Column<RawLabel> functionLabels;
+        Column<RawLabel> callSiteLabels;
+
+        CompressedNames names;
+        std::vector<Function> originals;
+
+        std::size_t memoryCap;
+        FrozenGraph* frozen;
 };
 
 } //end of inlining
@@ -0,0 +1,223 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef CALL_SITE_TABLE_H
+#define CALL_SITE_TABLE_H
+
+#include <cstddef>
+#include <utility>
+
+#include "Graph.hpp"
+#include "Column.hpp"
+
+namespace inlining {
+
+/*!
+ * \brief A call site of a call graph, the index of the call site in the columns of its call site table.
+ */
+typedef unsigned int FrozenCallSite;
+
+/*!
+ * \brief A function identifier as stored in the columns of a call site table.
+ */
+typedef unsigned int FrozenFunction;
+
+/*!
+ * \class CallSiteTable
+ * \brief The call sites of a call graph in compressed sparse row form.
+ *
+ * The call sites are numbered in the order they have been added by the reader, each field is stored in its own column
+ * indexed by call site. The out and in call sites of the functions are arrays of call site indexes grouped by source and
+ * by target, with an array of offsets for each, the call sites of a function are in the order of their numbers. The
+ * table is filled by GraphBuilder, only the numeric fields can be modified afterwards.
+ *
+ * The functions and the call sites are stored as 32 bits indexes, a table holds at most 2^32 - 1 functions and
+ * 2^32 - 1 call sites.
+ */
+class CallSiteTable {
+    public:
+        /*!
+         * \brief Construct an empty table.
+         */
+        CallSiteTable() : overflow(false) {}
+
+        /*!
+         * \brief Indicate if the given numbers of functions and call sites fit in 32 bits indexes.
+         * \param functions The number of functions
+         * \param callSites The number of call sites
+         * \return true if a table can hold them
+         */
+        static bool fits(std::size_t functions, std::size_t callSites);
+
+        /*!
+         * \brief Return the number of bytes taken by the columns of a table.
+         * \param functions The number of functions
+         * \param callSites The number of call sites
+         * \return The size of the table in bytes
+         */
+        static std::size_t footprint(std::size_t functions, std::size_t callSites);
+
+        /*!
+         * \brief Indicate if the calls given to the builder did not fit in 32 bits indexes, the table is then empty.
+         * \return true if call sites are missing
+         */
+        bool overflowed() const {
+            return overflow;
+        }
+
+        /*!
+         * \brief Return the number of call sites.
+         * \return The number of call sites
+         */
+        std::size_t numberOfCallSites() const {
+            return targets.size();
+        }
+
+        /*!
+         * \brief Return the out call sites of a function.
+         * \param function The function
+         * \return A pair of pointers to the indexes of the out call sites of the function
+         */
+        std::pair<const FrozenCallSite*, const FrozenCallSite*> outCallSites(Function function) const {
+            return std::make_pair(outEdges.data() + outOffsets[function], outEdges.data() + outOffsets[function + 1]);
+        }
+
+        /*!
+         * \brief Return the in call sites of a function.
+         * \param function The function
+         * \return A pair of pointers to the indexes of the in call sites of the function
+         */
+        std::pair<const FrozenCallSite*, const FrozenCallSite*> inCallSites(Function function) const {
+            return std::make_pair(inEdges.data() + inOffsets[function], inEdges.data() + inOffsets[function + 1]);
+        }
+
+        /*!
+         * \brief Return the number of out call sites of a function.
+         * \param function The function
+         * \return The out degree of the function
+         */
+        std::size_t outDegree(Function function) const {
+            return outOffsets[function + 1] - outOffsets[function];
+        }
+
+        /*!
+         * \brief Return the number of in call sites of a function.
+         * \param function The function
+         * \return The in degree of the function
+         */
+        std::size_t inDegree(Function function) const {
+            return inOffsets[function + 1] - inOffsets[function];
+        }
+
+        /*!
+         * \brief Return the caller of a call site.
+         * \param callSite The call site
+         * \return The source function of the call site
+         */
+        Function source(FrozenCallSite callSite) const {
+            return sources[callSite];
+        }
+
+        /*!
+         * \brief Return the callee of a call site.
+         * \param callSite The call site
+         * \return The target function of the call site
+         */
+        Function target(FrozenCallSite callSite) const {
+            return targets[callSite];
+        }
+
+        /*!
+         * \brief Return the number of calls of a call site.
+         * \param callSite The call site
+         * \return The number of calls of the call site
+         */
+        unsigned int calls(FrozenCallSite callSite) const {
+            return callCounts[callSite];
+        }
+
+        /*!
+         * \brief Set the number of calls of a call site.
+         * \param callSite The call site
+         * \param calls The number of calls of the call site
+         */
+        void setCalls(FrozenCallSite callSite, unsigned int calls) {
+            callCounts[callSite] = calls;
+        }
+
+        /*!
+         * \brief Return the cost of a call site.
+         * \param callSite The call site
+         * \return The cost of the call site
+         */
+        double cost(FrozenCallSite callSite) const {
+            return costs[callSite];
+        }
+
+        /*!
+         * \brief Set the cost of a call site.
+         * \param callSite The call site
+         * \param cost The cost of the call site
+         */
+        void setCost(FrozenCallSite callSite, double cost) {
+            costs[callSite] = cost;
+        }
+
+        /*!
+         * \brief Return the frequency of a call site, 0 before the graph is completed.
+         * \param callSite The call site
+         * \return The frequency of the call site
+         */
+        double frequency(FrozenCallSite callSite) const {
+            return frequencies[callSite];
+        }
+
+        /*!
+         * \brief Set the frequency of a call site.
+         * \param callSite The call site
+         * \param frequency The frequency of the call site
+         */
+        void setFrequency(FrozenCallSite callSite, double frequency) {
+            frequencies[callSite] = frequency;
+        }
+
+    private:
+        bool overflow;
+
+        Column<FrozenCallSite> outOffsets;
+        Column<FrozenCallSite> outEdges;
+        Column<FrozenCallSite> inOffsets;
+        Column<FrozenCallSite> inEdges;
+
+        Column<FrozenFunction> sources;
+        Column<FrozenFunction> targets;
+
+        Column<unsigned int> callCounts;
+        Column<double> costs;
+        Column<double> frequencies;
+
+        //Filled by the builder only
+        friend class GraphBuilder;
+};
+
+} //end of inlining
+
+#endif
@@ -0,0 +1,68 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef CALLGRIND_READER_H
+#define CALLGRIND_READER_H
+
+#include <string>
+
+#include "Graph.hpp"
+#include "ProfileReader.hpp"
+
+namespace inlining {
+
+/*!
+ * \class CallgrindReader
+ * \brief A reader for a callgrind.out profile.
+ *
+ * Reads the profile directly, without going through tools/converter.py and a .dot file. The costs are computed
+ * the same way as the converter, as percentages of the total self cost of the selected event, but no function or
+ * call site is pruned.
+ */
+class CallgrindReader : public ProfileReader {
+    public:
+        /*!
+         * \brief Construct a new CallgrindReader.
+         * \param i The Infos object to use to retrieve information about the shared object.
+         */
+        explicit CallgrindReader(Infos& i) : ProfileReader(i) {}
+
+        /*!
+         * \brief Select the event used for the costs. By default, the first event of the profile is used.
+         * \param e The name of the event (Ir, Dr, ...)
+         */
+        void setEvent(const std::string& e) {
+            event = e;
+        }
+
+        /*!
+         * \brief Read a callgrind.out file and creates a new call graph. It is up to the user to delete the CallGraph
+         * \param file The path to the file to read
+         * \return The call graph created from the profile
+         */
+        CallGraph* read(const std::string& file);
+
+    private:
+        std::string event;
+};
+
+} //end of inlining
+
+#endif
@@ -0,0 +1,179 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef COLUMN_H
+#define COLUMN_H
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+namespace inlining {
+
+/*!
+ * \brief Map a temporary file of the given size in memory. The file is removed as soon as it is mapped, its pages are
+ * written back to the disk by the kernel when the memory is needed and the space is freed with the mapping.
+ * \param bytes The size of the mapping
+ * \return A pointer to the zeroed mapping, NULL if it cannot be created
+ */
+void* mapTemporary(std::size_t bytes);
+
+/*!
+ * \brief Release a mapping created with mapTemporary().
+ * \param address The beginning of the mapping
+ * \param bytes The size of the mapping
+ */
+void unmapTemporary(void* address, std::size_t bytes);
+
+/*!
+ * \brief Release the pages of a part of a mapping created with mapTemporary() from the memory of the process. The
+ * values stay in the temporary file, they are read back from the page cache or from the disk at the next access.
+ * \param address The beginning of the part of the mapping
+ * \param bytes The size of the part
+ */
+void evictTemporary(void* address, std::size_t bytes);
+
+/*!
+ * \class Column
+ * \brief A fixed size array of plain values, either on the heap or in a temporary file mapped in memory.
+ *
+ * A mapped column is backed by the page cache instead of the heap, it can be larger than the memory, the passes reading
+ * it sequentially only keep the pages they are reading in memory. The values are zeroed when the column is allocated.
+ * If the temporary file cannot be created or its space cannot be allocated, the column falls back to the heap.
+ */
+template<typename T>
+class Column {
+    public:
+        /*!
+         * \brief Construct an empty column.
+         */
+        Column() : values(NULL), length(0), mapped(false) {}
+
+        ~Column() {
+            release();
+        }
+
+        /*!
+         * \brief Allocate the column, the previous values are released.
+         * \param size The number of values
+         * \param map Indicate if the column must be mapped from a temporary file (true) or allocated on the heap (false)
+         */
+        void allocate(std::size_t size, bool map) {
+            release();
+
+            length = size;
+
+            if (map && size > 0) {
+                values = static_cast<T*>(mapTemporary(size * sizeof(T)));
+                mapped = values != NULL;
+            }
+
+            if (!mapped) {
+                heap.assign(size, T());
+                values = heap.data();
+            }
+        }
+
+        /*!
+         * \brief Release the pages of a range of values of a mapped column from the memory of the process, once they
+         * have been written. The values are kept and read back at the next access. Does nothing for a column on the
+         * heap.
+         * \param first The first value of the range
+         * \param last The end of the range
+         */
+        void evict(std::size_t first, std::size_t last) {
+            if (mapped && first < last) {
+                evictTemporary(values + first, (last - first) * sizeof(T));
+            }
+        }
+
+        /*!
+         * \brief Exchange the values of two columns.
+         * \param other The column to exchange the values with
+         */
+        void swap(Column& other) {
+            std::swap(values, other.values);
+            std::swap(length, other.length);
+            std::swap(mapped, other.mapped);
+            heap.swap(other.heap);
+        }
+
+        /*!
+         * \brief Indicate if the column is mapped from a temporary file.
+         * \return true if the column is mapped, false if it is on the heap
+         */
+        bool isMapped() const {
+            return mapped;
+        }
+
+        /*!
+         * \brief Return the number of values of the column.
+         * \return The size of the column
+         */
+        std::size_t size() const {
+            return length;
+        }
+
+        /*!
+         * \brief Return the first value of the column.
+         * \return A pointer to the values
+         */
+        T* data() {
+            return values;
+        }
+
+        const T* data() const {
+            return values;
+        }
+
+        T& operator[](std::size_t index) {
+            return values[index];
+        }
+
+        const T& operator[](std::size_t index) const {
+            return values[index];
+        }
+
+    private:
+        T* values;
+        std::size_t length;
+        bool mapped;
+        std::vector<T> heap;
+
+        void release() {
+            if (mapped) {
+                unmapTemporary(values, length * sizeof(T));
+                mapped = false;
+            }
+
+            std::vector<T>().swap(heap);
+            values = NULL;
+            length = 0;
+        }
+
+        //Not copyable, the mapping belongs to a single column
+        Column(const Column&);
+        Column& operator=(const Column&);
+};
+
+} //end of inlining
+
+#endif
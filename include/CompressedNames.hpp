@@ -0,0 +1,115 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef COMPRESSED_NAMES_H
+#define COMPRESSED_NAMES_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "StringRef.hpp"
+
+namespace inlining {
+
+/*!
+ * \class CompressedNames
+ * \brief A front-coded table of names with random access by identifier.
+ *
+ * The names are sorted and cut in blocks of BLOCK_SIZE names. The first name of a block is stored in full, the next
+ * ones only store the length of the prefix they share with the previous name and their own suffix. A name is decoded
+ * by walking its block from the first name. The sorted order makes prefix queries possible on the compressed form,
+ * the blocks are found by a binary search on their first names and only the matching blocks are decoded.
+ */
+class CompressedNames {
+    public:
+        /*!
+         * \brief The number of names in a block.
+         */
+        static const std::size_t BLOCK_SIZE = 16;
+
+        /*!
+         * \brief Construct an empty table.
+         */
+        CompressedNames() {}
+
+        /*!
+         * \brief Compress the given names.
+         * \param names The names, the identifier of a name is its index
+         */
+        explicit CompressedNames(const std::vector<StringRef>& names);
+
+        /*!
+         * \brief Return the number of names of the table.
+         * \return The number of names
+         */
+        std::size_t size() const {
+            return ranks.size();
+        }
+
+        /*!
+         * \brief Indicate if the table is empty.
+         * \return true if the table does not contain any name
+         */
+        bool empty() const {
+            return ranks.empty();
+        }
+
+        /*!
+         * \brief Decode a name.
+         * \param id The identifier of the name
+         * \return The decoded name
+         */
+        std::string operator[](std::size_t id) const;
+
+        /*!
+         * \brief Find all the names starting with a prefix, without decoding the other blocks.
+         * \param prefix The prefix to search
+         * \param ids The vector to fill with the identifiers of the matching names, in the order of the names
+         */
+        void findPrefix(const StringRef& prefix, std::vector<std::size_t>& ids) const;
+
+        /*!
+         * \brief Find all the names equal to a name.
+         * \param name The name to search
+         * \param ids The vector to fill with the identifiers of the matching names
+         */
+        void find(const StringRef& name, std::vector<std::size_t>& ids) const;
+
+        /*!
+         * \brief Return the number of bytes used by the table.
+         * \return The size of the compressed names, of the blocks and of the identifiers
+         */
+        std::size_t bytes() const;
+
+    private:
+        std::vector<char> data;                     //The encoded blocks
+        std::vector<std::size_t> blocks;            //The offset of each block in data
+        std::vector<unsigned int> ranks;            //The position of each name in the sorted order
+        std::vector<unsigned int> ids;              //The identifier of each position in the sorted order
+
+        void find(const StringRef& prefix, bool exact, std::vector<std::size_t>& result) const;
+        StringRef head(std::size_t block) const;
+};
+
+} //end of inlining
+
+#endif
@@ -0,0 +1,112 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+
+#include <string>
+#include <cstddef>
+
+#include <zlib.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace inlining {
+
+/*!
+ * \enum Compression
+ * \brief The compression of an input file.
+ */
+enum Compression {
+    NO_COMPRESSION,     /*!< A plain text file */
+    GZIP_COMPRESSION,   /*!< A gzip (or zlib) file */
+    ZSTD_COMPRESSION    /*!< A zstd file */
+};
+
+/*!
+ * \brief Detect the compression of a file from its first bytes.
+ * \param data The first bytes of the file
+ * \param size The number of bytes, at least 4 bytes are necessary to detect zstd
+ * \return The compression of the file
+ */
+Compression detectCompression(const char* data, size_t size);
+
+/*!
+ * \brief Detect the compression of the given file.
+ * \param file The path to the file
+ * \return The compression of the file
+ */
+Compression detectCompression(const std::string& file);
+
+/*!
+ * \class Decompressor
+ * \brief Decompress a stream incrementally. A plain text stream is copied as is.
+ */
+class Decompressor {
+    public:
+        /*!
+         * \brief Construct a new Decompressor.
+         */
+        Decompressor();
+
+        /*!
+         * \brief Release the decompression context.
+         */
+        ~Decompressor();
+
+        /*!
+         * \brief Detect the compression of the stream and prepare the decompression.
+         * \param data The first bytes of the stream
+         * \param size The number of bytes
+         * \return true if the stream can be decompressed
+         */
+        bool start(const char* data, size_t size);
+
+        /*!
+         * \brief Decompress the next bytes of the stream.
+         * \param data The compressed bytes
+         * \param size The number of bytes
+         * \param output The string to append the decompressed content to
+         * \return false if the stream is not valid
+         */
+        bool feed(const char* data, size_t size, std::string& output);
+
+    private:
+        Compression compression;
+        bool failed;
+
+        z_stream gzip;
+
+#ifdef HAVE_ZSTD
+        ZSTD_DStream* zstd;
+#endif
+
+        bool fail();
+
+        //Not copyable
+        Decompressor(const Decompressor&);
+        Decompressor& operator=(const Decompressor&);
+};
+
+} //end of inlining
+
+#endif
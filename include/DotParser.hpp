@@ -0,0 +1,180 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef DOT_PARSER_H
+#define DOT_PARSER_H
+
+#include <string>
+#include <vector>
+
+#include "StringRef.hpp"
+#include "Graph.hpp"
+
+namespace inlining {
+
+/*!
+ * \struct DotStatement
+ * \brief A node or an edge statement of a dot file. All the fields reference the parsed buffer.
+ */
+struct DotStatement {
+    bool edge;              /*!< Indicate if the statement is an edge (true) or a node (false) */
+    StringRef source;       /*!< The node of a node statement or the source of an edge statement */
+    StringRef target;       /*!< The target of an edge statement */
+    StringRef label;        /*!< The label attribute */
+    StringRef module;       /*!< The module attribute */
+    StringRef fileName;     /*!< The filename attribute */
+
+    DotStatement() : edge(false) {}
+};
+
+/*!
+ * \class DotParser
+ * \brief A parser for the subset of the dot language produced by tools/converter.py.
+ *
+ * The parser works directly on the buffer and never copies the identifiers or the attributes. Node and edge
+ * statements and edge chains are supported, the default attribute statements are skipped. Subgraphs, ports and HTML
+ * identifiers are not, the parser fails on them and the caller must fall back to boost::read_graphviz.
+ */
+class DotParser {
+    public:
+        /*!
+         * \brief Construct a parser for the given buffer.
+         * \param b The beginning of the dot content
+         * \param e The end of the dot content
+         */
+        DotParser(const char* b, const char* e) : it(b), end(e), started(false), partial(false), closed(false), error(false), chainIndex(0) {}
+
+        /*!
+         * \brief Construct a parser for a part of the statements of a graph, without the header. The end of the buffer
+         * is a valid end of the part, the closing brace is optional.
+         * \param b The beginning of the statements
+         * \param e The end of the statements, must be between two statements
+         * \param p Must be true
+         */
+        DotParser(const char* b, const char* e, bool p) : it(b), end(e), started(true), partial(p), closed(false), error(false), chainIndex(0) {}
+
+        /*!
+         * \brief Parse the header of the graph (digraph name {) if it has not already been parsed.
+         * \return true if the header is valid
+         */
+        bool header() {
+            return started || parseHeader();
+        }
+
+        /*!
+         * \brief Return the current position of the parser in the buffer.
+         * \return A pointer to the next character to parse
+         */
+        const char* position() const {
+            return it;
+        }
+
+        /*!
+         * \brief Indicate if the closing brace of the graph has been parsed.
+         * \return true if the end of the graph has been reached
+         */
+        bool isClosed() const {
+            return closed;
+        }
+
+        /*!
+         * \brief Parse the next node or edge statement.
+         * \param statement The statement to fill
+         * \return true if a statement has been parsed, false at the end of the graph or on error
+         */
+        bool next(DotStatement& statement);
+
+        /*!
+         * \brief Indicate if the content cannot be parsed by this parser.
+         * \return true if an error has been encountered
+         */
+        bool failed() const {
+            return error;
+        }
+
+    private:
+        const char* it;
+        const char* end;
+        bool started;
+        bool partial;
+        bool closed;
+        bool error;
+
+        //The remaining edges of an edge chain (a -> b -> c)
+        std::vector<StringRef> chain;
+        std::vector<StringRef>::size_type chainIndex;
+        DotStatement chainStatement;
+
+        void skipBlanks();
+        bool parseHeader();
+        bool parseId(StringRef& id);
+        bool parseId(StringRef& id, bool& quoted);
+        bool parseAttributes(DotStatement& statement);
+        bool fail();
+};
+
+/*!
+ * \brief Return the value of an identifier, removing the escaped quotes and line continuations.
+ * \param id The identifier as it appears between the quotes
+ * \return The value of the identifier
+ */
+std::string unescape(const StringRef& id);
+
+/*!
+ * \brief Write the value of an identifier, removing the escaped quotes and line continuations. The value is never
+ * longer than the identifier.
+ * \param id The identifier as it appears between the quotes
+ * \param destination The characters to fill, at least id.size()
+ * \return The number of written characters
+ */
+std::size_t unescape(const StringRef& id, char* destination);
+
+/*!
+ * \brief Decode the label of a function produced by converter.py (name\\ninclusive%\\n(self%)\\ncalls×).
+ * \param label The label of the node
+ * \param inclusiveCost The inclusive cost to fill
+ * \param selfCost The self cost to fill
+ * \param calls The number of calls to fill
+ * \param fields The fields to decode (a combination of GraphField), the others are left untouched
+ * \return true if the label has been decoded, false if it has another form
+ */
+bool decodeFunctionLabel(const StringRef& label, double& inclusiveCost, double& selfCost, unsigned int& calls, unsigned int fields = ALL_FIELDS);
+
+/*!
+ * \brief Decode the label of a call site produced by converter.py (calls× or cost%\\ncalls×).
+ * \param label The label of the edge
+ * \param cost The cost to fill, 0 if the label does not contain it
+ * \param calls The number of calls to fill
+ * \param fields The fields to decode (a combination of GraphField), the others are left untouched
+ */
+void decodeCallSiteLabel(const StringRef& label, double& cost, unsigned int& calls, unsigned int fields = ALL_FIELDS);
+
+/*!
+ * \brief Find the beginning of the first line after the given position that follows a complete statement, that is
+ * a line ending with a semicolon. The dot files produced by converter.py have one statement per line.
+ * \param position The position to start the search from
+ * \param end The end of the buffer
+ * \return The beginning of the next statement or end if there are none
+ */
+const char* nextStatement(const char* position, const char* end);
+
+} //end of inlining
+
+#endif
@@ -0,0 +1,72 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef FOLDED_READER_H
+#define FOLDED_READER_H
+
+#include <string>
+
+#include "ProfileReader.hpp"
+
+namespace inlining {
+
+/*!
+ * \class FoldedReader
+ * \brief A reader for the folded stacks produced by the flamegraph scripts (stackcollapse-perf.pl, bpftrace, ...).
+ *
+ * Each line is a stack, from the root to the leaf, followed by the number of samples (main;run;compute 1234). A frame
+ * can be prefixed by its module (libc.so.6`malloc) and the _[k], _[j] and _[i] annotations are ignored. The file is
+ * streamed, only the functions and the call sites are kept in memory, and it can be compressed with gzip or zstd.
+ *
+ * The samples are used both as the costs and as the calls: the self cost of a function is the percentage of the
+ * samples in which it is the leaf, the inclusive cost the percentage of the samples in which it appears, and each pair
+ * of consecutive frames is a call site. A recursive function or call site is only counted once per stack.
+ */
+class FoldedReader : public ProfileReader {
+    public:
+        /*!
+         * \brief Construct a new FoldedReader.
+         * \param i The Infos object to use to retrieve information about the shared object.
+         */
+        explicit FoldedReader(Infos& i) : ProfileReader(i), blockSize(1 << 20) {}
+
+        /*!
+         * \brief Read a folded stacks file and creates a new call graph. It is up to the user to delete the CallGraph
+         * \param file The path to the file to read, - for the standard input
+         * \return The call graph created from the stacks or NULL if the file cannot be read
+         */
+        CallGraph* read(const std::string& file);
+
+        /*!
+         * \brief Set the maximal number of bytes read at once from the file.
+         * \param size The size of a read in bytes
+         */
+        void setBlockSize(size_t size) {
+            blockSize = size == 0 ? 1 : size;
+        }
+
+    private:
+        size_t blockSize;
+};
+
+} //end of inlining
+
+#endif
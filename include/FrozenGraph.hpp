@@ -0,0 +1,419 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef FROZEN_GRAPH_H
+#define FROZEN_GRAPH_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <limits>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include "Graph.hpp"
+#include "Column.hpp"
+#include "CallSiteTable.hpp"
+
+namespace inlining {
+
+class CallGraph;
+
+/*!
+ * \class FrozenGraph
+ * \brief An immutable copy of the numeric fields of the functions of a call graph, over the call sites of its call site
+ * table.
+ *
+ * The call sites are the call sites of the call site table of the call graph, they are not copied. The fields of the
+ * functions are stored in one column per field, indexed by function. The modules are the interned strings of the call
+ * graph, two functions are in the same module if they have the same module identifier. The functions of the frozen graph
+ * are the functions of the call graph. The frozen graph is not updated when the call graph is modified.
+ *
+ * The numeric columns are the hot part of the call graph, read by the analysis and the reports. The names, the labels
+ * and the file names stay in the call graph and are only read to print the results. The temperatures are the only
+ * columns that can be written, they are computed by the Analyzer.
+ *
+ * The functions are stored as 32 bits indexes, like the call sites of the table, a call graph with more functions
+ * cannot be frozen.
+ *
+ * The columns can be mapped from temporary files instead of being allocated on the heap. A mapped frozen graph is
+ * backed by the page cache, the analysis passes walk the functions and the call sites in order and only keep the pages
+ * they read in memory.
+ */
+class FrozenGraph {
+    public:
+        /*!
+         * \brief Freeze the given call graph.
+         * \param graph The call graph to freeze
+         * \throw std::length_error If the call sites of the call graph are not all in its call site table
+         */
+        explicit FrozenGraph(const CallGraph& graph, bool mapped = false);
+
+        /*!
+         * \brief Return the number of bytes taken by the columns of a frozen graph, the call sites are in the call site
+         * table.
+         * \param functions The number of functions
+         * \param callSites The number of call sites
+         * \return The size of the frozen graph in bytes
+         */
+        static std::size_t footprint(std::size_t functions, std::size_t callSites);
+
+        /*!
+         * \brief Indicate if the columns are mapped from temporary files.
+         * \return true if the columns are mapped, false if they are on the heap
+         */
+        bool isMapped() const {
+            return mapped;
+        }
+
+        /*!
+         * \brief Return the number of functions.
+         * \return The number of functions
+         */
+        std::size_t numberOfFunctions() const {
+            return modules.size();
+        }
+
+        /*!
+         * \brief Return the number of call sites.
+         * \return The number of call sites
+         */
+        std::size_t numberOfCallSites() const {
+            return callSites->numberOfCallSites();
+        }
+
+        /*!
+         * \brief Return the out call sites of a function.
+         * \param function The function
+         * \return A pair of pointers to the indexes of the out call sites of the function
+         */
+        std::pair<const FrozenCallSite*, const FrozenCallSite*> outCallSites(Function function) const {
+            return callSites->outCallSites(function);
+        }
+
+        /*!
+         * \brief Return the in call sites of a function.
+         * \param function The function
+         * \return A pair of pointers to the indexes of the in call sites of the function
+         */
+        std::pair<const FrozenCallSite*, const FrozenCallSite*> inCallSites(Function function) const {
+            return callSites->inCallSites(function);
+        }
+
+        /*!
+         * \brief Return the number of out call sites of a function.
+         * \param function The function
+         * \return The out degree of the function
+         */
+        std::size_t outDegree(Function function) const {
+            return callSites->outDegree(function);
+        }
+
+        /*!
+         * \brief Return the number of in call sites of a function.
+         * \param function The function
+         * \return The in degree of the function
+         */
+        std::size_t inDegree(Function function) const {
+            return callSites->inDegree(function);
+        }
+
+        /*!
+         * \brief Return the caller of a call site.
+         * \param callSite The call site
+         * \return The source function of the call site
+         */
+        Function source(FrozenCallSite callSite) const {
+            return callSites->source(callSite);
+        }
+
+        /*!
+         * \brief Return the callee of a call site.
+         * \param callSite The call site
+         * \return The target function of the call site
+         */
+        Function target(FrozenCallSite callSite) const {
+            return callSites->target(callSite);
+        }
+
+        /*!
+         * \brief Return the identifier of the module of a function.
+         * \param function The function
+         * \return The module identifier, the same for all the functions of a module
+         */
+        StringId module(Function function) const {
+            return modules[function];
+        }
+
+        /*!
+         * \brief Return the name of a module.
+         * \param module The module identifier
+         * \return The name of the module
+         */
+        const std::string& moduleName(StringId module) const {
+            return (*strings)[module];
+        }
+
+        /*!
+         * \brief Return the number of interned strings of the call graph, the module identifiers are lower than this
+         * number.
+         * \return The number of string identifiers
+         */
+        StringId numberOfStrings() const {
+            return strings->size();
+        }
+
+        /*!
+         * \brief Return the number of calls of a function.
+         * \param function The function
+         * \return The number of calls of the function
+         */
+        unsigned int calls(Function function) const {
+            return functionCalls[function];
+        }
+
+        /*!
+         * \brief Return the size of a function.
+         * \param function The function
+         * \return The size of the function, 0 if unknown
+         */
+        unsigned int size(Function function) const {
+            return sizes[function];
+        }
+
+        /*!
+         * \brief Return the number of parameters of a function.
+         * \param function The function
+         * \return The number of parameters of the function
+         */
+        unsigned int parameters(Function function) const {
+            return functionParameters[function];
+        }
+
+        /*!
+         * \brief Indicate if a function is virtual.
+         * \param function The function
+         * \return true if the function is virtual
+         */
+        bool isVirtual(Function function) const {
+            return virtualities[function];
+        }
+
+        /*!
+         * \brief Return the frequency of a function.
+         * \param function The function
+         * \return The frequency of the function
+         */
+        double frequency(Function function) const {
+            return functionFrequencies[function];
+        }
+
+        /*!
+         * \brief Return the self cost of a function.
+         * \param function The function
+         * \return The cost of the function
+         */
+        double selfCost(Function function) const {
+            return selfCosts[function];
+        }
+
+        /*!
+         * \brief Return the temperature of a function, 0 before the analysis.
+         * \param function The function
+         * \return The temperature of the function
+         */
+        double temperature(Function function) const {
+            return temperatures[function];
+        }
+
+        /*!
+         * \brief Set the temperature of a function.
+         * \param function The function
+         * \param temperature The temperature of the function
+         */
+        void setTemperature(Function function, double temperature) {
+            temperatures[function] = temperature;
+        }
+
+        /*!
+         * \brief Return the number of calls of a call site.
+         * \param callSite The call site
+         * \return The number of calls of the call site
+         */
+        unsigned int callSiteCalls(FrozenCallSite callSite) const {
+            return callSites->calls(callSite);
+        }
+
+        /*!
+         * \brief Return the frequency of a call site.
+         * \param callSite The call site
+         * \return The frequency of the call site
+         */
+        double callSiteFrequency(FrozenCallSite callSite) const {
+            return callSites->frequency(callSite);
+        }
+
+        /*!
+         * \brief Return the temperature of a call site, 0 before the analysis.
+         * \param callSite The call site
+         * \return The temperature of the call site
+         */
+        double callSiteTemperature(FrozenCallSite callSite) const {
+            return callSiteTemperatures[callSite];
+        }
+
+        /*!
+         * \brief Set the temperature of a call site.
+         * \param callSite The call site
+         * \param temperature The temperature of the call site
+         */
+        void setCallSiteTemperature(FrozenCallSite callSite, double temperature) {
+            callSiteTemperatures[callSite] = temperature;
+        }
+
+    private:
+        bool mapped;
+
+        const CallSiteTable* callSites;
+
+        Column<StringId> modules;
+        const StringPool* strings;
+
+        Column<unsigned int> functionCalls;
+        Column<unsigned int> sizes;
+        Column<unsigned int> functionParameters;
+        Column<char> virtualities;
+        Column<double> functionFrequencies;
+        Column<double> selfCosts;
+        Column<double> temperatures;
+
+        Column<double> callSiteTemperatures;
+};
+
+//Boost Graph Library adapters, a frozen graph is a bidirectional, vertex list and edge list graph
+
+/*!
+ * \brief Iterator on the out or in call sites of a function of a frozen graph.
+ */
+typedef const FrozenCallSite* FrozenAdjacentIterator;
+
+/*!
+ * \brief Iterator on the functions or the call sites of a frozen graph.
+ */
+typedef boost::counting_iterator<std::size_t> FrozenIterator;
+
+inline std::pair<FrozenIterator, FrozenIterator> vertices(const FrozenGraph& graph) {
+    return std::make_pair(FrozenIterator(0), FrozenIterator(graph.numberOfFunctions()));
+}
+
+inline std::size_t num_vertices(const FrozenGraph& graph) {
+    return graph.numberOfFunctions();
+}
+
+inline std::pair<FrozenIterator, FrozenIterator> edges(const FrozenGraph& graph) {
+    return std::make_pair(FrozenIterator(0), FrozenIterator(graph.numberOfCallSites()));
+}
+
+inline std::size_t num_edges(const FrozenGraph& graph) {
+    return graph.numberOfCallSites();
+}
+
+inline std::pair<FrozenAdjacentIterator, FrozenAdjacentIterator> out_edges(Function function, const FrozenGraph& graph) {
+    return graph.outCallSites(function);
+}
+
+inline std::size_t out_degree(Function function, const FrozenGraph& graph) {
+    return graph.outDegree(function);
+}
+
+inline std::pair<FrozenAdjacentIterator, FrozenAdjacentIterator> in_edges(Function function, const FrozenGraph& graph) {
+    return graph.inCallSites(function);
+}
+
+inline std::size_t in_degree(Function function, const FrozenGraph& graph) {
+    return graph.inDegree(function);
+}
+
+inline std::size_t degree(Function function, const FrozenGraph& graph) {
+    return graph.inDegree(function) + graph.outDegree(function);
+}
+
+inline Function source(FrozenCallSite callSite, const FrozenGraph& graph) {
+    return graph.source(callSite);
+}
+
+inline Function target(FrozenCallSite callSite, const FrozenGraph& graph) {
+    return graph.target(callSite);
+}
+
+inline boost::typed_identity_property_map<std::size_t> get(boost::vertex_index_t, const FrozenGraph&) {
+    return boost::typed_identity_property_map<std::size_t>();
+}
+
+inline boost::typed_identity_property_map<std::size_t> get(boost::edge_index_t, const FrozenGraph&) {
+    return boost::typed_identity_property_map<std::size_t>();
+}
+
+} //end of inlining
+
+namespace boost {
+
+template<>
+struct graph_traits<inlining::FrozenGraph> {
+    struct traversal_category : bidirectional_graph_tag, vertex_list_graph_tag, edge_list_graph_tag {};
+
+    typedef inlining::Function vertex_descriptor;
+    typedef inlining::FrozenCallSite edge_descriptor;
+    typedef directed_tag directed_category;
+    typedef allow_parallel_edge_tag edge_parallel_category;
+
+    typedef inlining::FrozenIterator vertex_iterator;
+    typedef inlining::FrozenIterator edge_iterator;
+    typedef inlining::FrozenAdjacentIterator out_edge_iterator;
+    typedef inlining::FrozenAdjacentIterator in_edge_iterator;
+
+    typedef std::size_t vertices_size_type;
+    typedef std::size_t edges_size_type;
+    typedef std::size_t degree_size_type;
+
+    static vertex_descriptor null_vertex() {
+        return std::numeric_limits<vertex_descriptor>::max();
+    }
+};
+
+template<>
+struct property_map<inlining::FrozenGraph, vertex_index_t> {
+    typedef typed_identity_property_map<std::size_t> type;
+    typedef type const_type;
+};
+
+template<>
+struct property_map<inlining::FrozenGraph, edge_index_t> {
+    typedef typed_identity_property_map<std::size_t> type;
+    typedef type const_type;
+};
+
+} //end of boost
+
+#endif
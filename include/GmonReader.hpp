@@ -0,0 +1,70 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef GMON_READER_H
+#define GMON_READER_H
+
+#include <string>
+
+#include "ProfileReader.hpp"
+
+namespace inlining {
+
+/*!
+ * \class GmonReader
+ * \brief A reader for the gmon.out profiles written by the programs compiled with -pg.
+ *
+ * The binary profile is read directly, without gprof and tools/converter.py. The addresses of the histograms and of
+ * the arcs are resolved to functions with the symbol table of the executable loaded by Infos. The self cost of a
+ * function is its share of the samples of the histograms, the inclusive cost and the costs of the call sites are
+ * propagated from the callees to the callers in proportion of the calls, like gprof does. The cycles of the call
+ * graph are broken, the time of a recursive call is not propagated.
+ */
+class GmonReader : public ProfileReader {
+    public:
+        /*!
+         * \brief Construct a new GmonReader.
+         * \param i The Infos object to use to retrieve information about the shared object.
+         */
+        explicit GmonReader(Infos& i) : ProfileReader(i), executable("a.out") {}
+
+        /*!
+         * \brief Set the executable the profile has been generated by. By default, a.out like gprof.
+         * \param e The path to the executable
+         */
+        void setExecutable(const std::string& e) {
+            executable = e;
+        }
+
+        /*!
+         * \brief Read a gmon.out file and creates a new call graph. It is up to the user to delete the CallGraph
+         * \param file The path to the file to read
+         * \return The call graph created from the profile or NULL if the profile is not valid
+         */
+        CallGraph* read(const std::string& file);
+
+    private:
+        std::string executable;
+};
+
+} //end of inlining
+
+#endif
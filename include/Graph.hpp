@@ -22,26 +22,46 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define Graph_H
 
 #include <boost/graph/adjacency_list.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include "StringPool.hpp"
+#include "StringArena.hpp"
 
 namespace inlining {
 
+/*!
+ * \enum GraphField
+ * \brief The fields of the functions and of the call sites that are decoded from the labels of a profile. The values
+ * are combined in a mask.
+ */
+enum GraphField {
+    FUNCTION_CALLS = 1,             /*!< vertex_info::calls */
+    FUNCTION_SELF_COST = 2,         /*!< vertex_info::self_cost */
+    FUNCTION_INCLUSIVE_COST = 4,    /*!< vertex_info::inclusive_cost */
+    CALL_SITE_CALLS = 8,            /*!< edge_info::calls */
+    CALL_SITE_COST = 16,            /*!< edge_info::cost */
+    ALL_FIELDS = 31                 /*!< All the fields */
+};
+
 /*!
  * \struct vertex_info
  * \brief struct containing all the information about a vertex of the graph
  */
 struct vertex_info {
-    std::string name;           /*!< The name of the function */
-    std::string label;          /*!< The label */
-    std::string file_name;      /*!< The filename the function has been defined in */
-    std::string module;         /*!< The shared object of the function */
+    StringRef name;             /*!< The name of the function, stored in the arena of the graph */
+    StringRef label;            /*!< The label, stored in the arena of the graph */
+    StringId file_name;         /*!< The filename the function has been defined in, interned in the strings of the graph */
+    StringId module;            /*!< The shared object of the function, interned in the strings of the graph */
     double self_cost;           /*!< The cost of the function */
     double inclusive_cost;      /*!< The inclusive cost of the function */
-    double temperature;         /*!< The temperature of the function */
     double frequency;           /*!< The frequency of the function */
     unsigned int calls;         /*!< The number of calls of the function */
     unsigned int parameters;    /*!< The number of parameters of the function */
     unsigned int size;          /*!< The size of the function */
     bool virtuality;            /*!< Indicate if the function is virtual (true) or not (false) */
+
+    vertex_info() : file_name(EMPTY_STRING), module(EMPTY_STRING), self_cost(0.0), inclusive_cost(0.0), frequency(0.0), calls(0),
+            parameters(0), size(0), virtuality(false) {}
 };
 
 /*!
@@ -49,24 +69,207 @@ struct vertex_info {
  * \brief struct containing all the information about an edge of the graph
  */
 struct edge_info {
-    std::string name;       /*!< The name of the call site */
-    std::string label;      /*!< The label */
+    StringRef name;         /*!< The name of the call site, stored in the arena of the graph */
+    StringRef label;        /*!< The label, stored in the arena of the graph */
     unsigned int calls;     /*!< The number of calls of the call site */
-    double temperature;     /*!< The temperature of the call site */
     double frequency;       /*!< The frequency of the call site */
     double cost;            /*!< The cost of the call site */
 };
 
 /*!
- * \brief The properties of the graph, only the name
+ * \struct graph_strings_t
+ * \brief The tag of the property of a graph containing the interned strings of its functions.
+ */
+struct graph_strings_t {
+    typedef boost::graph_property_tag kind;     /*!< A graph property */
+};
+
+/*!
+ * \struct graph_arena_t
+ * \brief The tag of the property of a graph containing the names and the labels of its functions and call sites.
+ */
+struct graph_arena_t {
+    typedef boost::graph_property_tag kind;     /*!< A graph property */
+};
+
+/*!
+ * \brief The properties of the graph, the name, the interned strings (the modules and the file names) and the arena of
+ * the names and the labels
  */
-typedef boost::property < boost::graph_name_t, std::string > GraphProperties;
+typedef boost::property < boost::graph_name_t, std::string, boost::property < graph_strings_t, StringPool, boost::property < graph_arena_t, StringArena > > > GraphProperties;
 
 /*!
  * \brief A graph. Used to store the call graph.
  */
 typedef boost::adjacency_list < boost::vecS, boost::vecS, boost::bidirectionalS, vertex_info, edge_info, GraphProperties> Graph;
 
+/*!
+ * \brief Return the interned strings of a graph.
+ * \param graph The graph
+ * \return The strings of the graph
+ */
+inline StringPool& stringsOf(Graph& graph) {
+    return boost::get_property(graph, graph_strings_t());
+}
+
+/*!
+ * \brief Return the interned strings of a graph.
+ * \param graph The graph
+ * \return The strings of the graph
+ */
+inline const StringPool& stringsOf(const Graph& graph) {
+    return boost::get_property(graph, graph_strings_t());
+}
+
+/*!
+ * \brief Return the arena storing the names and the labels of a graph.
+ * \param graph The graph
+ * \return The arena of the graph
+ */
+inline StringArena& arenaOf(Graph& graph) {
+    return boost::get_property(graph, graph_arena_t());
+}
+
+/*!
+ * \class InternedPropertyMap
+ * \brief A property map giving the string value of an interned field of the functions of a graph. The strings put in
+ * the map are interned in the graph. Used to read a graph with boost::read_graphviz.
+ */
+class InternedPropertyMap {
+    public:
+        typedef boost::graph_traits<Graph>::vertex_descriptor key_type;     /*!< A function */
+        typedef std::string value_type;                                     /*!< The string value of the field */
+        typedef std::string reference;                                      /*!< The values are returned by copy */
+        typedef boost::read_write_property_map_tag category;                /*!< The map can be read and written */
+
+        /*!
+         * \brief Construct a map on the given field of the functions.
+         * \param g The graph
+         * \param f The interned field
+         */
+        InternedPropertyMap(Graph& g, StringId vertex_info::* f) : graph(&g), field(f) {}
+
+        /*!
+         * \brief Return the value of the field of a function.
+         * \param map The map
+         * \param function The function
+         * \return The string value of the field
+         */
+        friend std::string get(const InternedPropertyMap& map, key_type function) {
+            return stringsOf(*map.graph)[(*map.graph)[function].*map.field];
+        }
+
+        /*!
+         * \brief Set the value of the field of a function.
+         * \param map The map
+         * \param function The function
+         * \param value The string value of the field
+         */
+        friend void put(const InternedPropertyMap& map, key_type function, const std::string& value) {
+            (*map.graph)[function].*map.field = stringsOf(*map.graph).intern(value);
+        }
+
+    private:
+        Graph* graph;
+        StringId vertex_info::* field;
+};
+
+/*!
+ * \class ArenaPropertyMap
+ * \brief A property map giving the value of a name or a label of the functions or of the call sites of a graph. The
+ * strings put in the map are stored in the arena of the graph. Used to read a graph with boost::read_graphviz.
+ */
+template<typename Key, typename Info>
+class ArenaPropertyMap {
+    public:
+        typedef Key key_type;                                   /*!< A function or a call site */
+        typedef std::string value_type;                         /*!< The value of the field */
+        typedef std::string reference;                          /*!< The values are returned by copy */
+        typedef boost::read_write_property_map_tag category;    /*!< The map can be read and written */
+
+        /*!
+         * \brief Construct a map on the given field.
+         * \param g The graph
+         * \param f The field stored in the arena
+         */
+        ArenaPropertyMap(Graph& g, StringRef Info::* f) : graph(&g), field(f), arena(&arenaOf(g)) {}
+
+        /*!
+         * \brief Construct a map on the given field, storing the strings in another arena than the one of the graph.
+         * \param g The graph
+         * \param f The field stored in the arena
+         * \param a The arena, must outlive the use of the field
+         */
+        ArenaPropertyMap(Graph& g, StringRef Info::* f, StringArena& a) : graph(&g), field(f), arena(&a) {}
+
+        /*!
+         * \brief Return the value of the field of a function or of a call site.
+         * \param map The map
+         * \param key The function or the call site
+         * \return The value of the field
+         */
+        friend std::string get(const ArenaPropertyMap& map, const key_type& key) {
+            return ((*map.graph)[key].*map.field).str();
+        }
+
+        /*!
+         * \brief Set the value of the field of a function or of a call site.
+         * \param map The map
+         * \param key The function or the call site
+         * \param value The value of the field
+         */
+        friend void put(const ArenaPropertyMap& map, const key_type& key, const std::string& value) {
+            (*map.graph)[key].*map.field = map.arena->store(value);
+        }
+
+    private:
+        Graph* graph;
+        StringRef Info::* field;
+        StringArena* arena;
+};
+
+/*!
+ * \brief Create a property map on a name or a label of the functions.
+ * \param graph The graph
+ * \param field The field of the functions
+ * \return The property map
+ */
+inline ArenaPropertyMap<boost::graph_traits<Graph>::vertex_descriptor, vertex_info> arenaMap(Graph& graph, StringRef vertex_info::* field) {
+    return ArenaPropertyMap<boost::graph_traits<Graph>::vertex_descriptor, vertex_info>(graph, field);
+}
+
+/*!
+ * \brief Create a property map on a name or a label of the functions, stored in the given arena.
+ * \param graph The graph
+ * \param field The field of the functions
+ * \param arena The arena storing the values
+ * \return The property map
+ */
+inline ArenaPropertyMap<boost::graph_traits<Graph>::vertex_descriptor, vertex_info> arenaMap(Graph& graph, StringRef vertex_info::* field, StringArena& arena) {
+    return ArenaPropertyMap<boost::graph_traits<Graph>::vertex_descriptor, vertex_info>(graph, field, arena);
+}
+
+/*!
+ * \brief Create a property map on a name or a label of the call sites.
+ * \param graph The graph
+ * \param field The field of the call sites
+ * \return The property map
+ */
+inline ArenaPropertyMap<boost::graph_traits<Graph>::edge_descriptor, edge_info> arenaMap(Graph& graph, StringRef edge_info::* field) {
+    return ArenaPropertyMap<boost::graph_traits<Graph>::edge_descriptor, edge_info>(graph, field);
+}
+
+/*!
+ * \brief Create a property map on a name or a label of the call sites, stored in the given arena.
+ * \param graph The graph
+ * \param field The field of the call sites
+ * \param arena The arena storing the values
+ * \return The property map
+ */
+inline ArenaPropertyMap<boost::graph_traits<Graph>::edge_descriptor, edge_info> arenaMap(Graph& graph, StringRef edge_info::* field, StringArena& arena) {
+    return ArenaPropertyMap<boost::graph_traits<Graph>::edge_descriptor, edge_info>(graph, field, arena);
+}
+
 //Iterators
 
 /*!
@@ -121,7 +324,7 @@ struct library_info {
 /*!
  * \brief A dependency graph. Used only to generate the circular dependencies.
  */
-typedef boost::adjacency_list < boost::setS, boost::vecS, boost::directedS, vertex_info, edge_info, library_info> DependencyGraph;
+typedef boost::adjacency_list < boost::setS, boost::vecS, boost::directedS, library_info> DependencyGraph;
 
 //Descriptors
 
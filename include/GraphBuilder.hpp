@@ -0,0 +1,234 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef GRAPH_BUILDER_H
+#define GRAPH_BUILDER_H
+
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
+#include <limits>
+
+#include "Graph.hpp"
+#include "CallSiteTable.hpp"
+#include "StringRef.hpp"
+
+namespace inlining {
+
+class CallGraph;
+
+/*!
+ * \class NameInterner
+ * \brief Interns names from several threads.
+ *
+ * The names are distributed in shards by their hash, each shard has its own lock and its own table. The identifier of
+ * a name is its index in its shard shifted by SHARD_BITS, ored with the index of the shard. The names are not copied,
+ * they must stay valid as long as the interner is used.
+ */
+class NameInterner {
+    public:
+        /*!
+         * \brief The number of bits of the identifiers used for the shard.
+         */
+        static const unsigned int SHARD_BITS = 6;
+
+        /*!
+         * \brief The number of shards.
+         */
+        static const unsigned int SHARDS = 1 << SHARD_BITS;
+
+        /*!
+         * \brief Intern a name, can be called from several threads.
+         * \param name The name to intern
+         * \return The identifier of the name, the same for equal names
+         */
+        unsigned int intern(const StringRef& name);
+
+        /*!
+         * \brief Return the names of a shard, in the order they have been interned.
+         * \param shard The index of the shard
+         * \return The names of the shard
+         */
+        const std::vector<StringRef>& names(unsigned int shard) const {
+            return shards[shard].names;
+        }
+
+        /*!
+         * \brief Return an interned name.
+         * \param id The identifier of the name
+         * \return The name
+         */
+        const StringRef& name(unsigned int id) const {
+            return shards[id & (SHARDS - 1)].names[id >> SHARD_BITS];
+        }
+
+    private:
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_map<StringRef, unsigned int, StringRefHash> index;
+            std::vector<StringRef> names;
+        };
+
+        Shard shards[SHARDS];
+};
+
+/*!
+ * \struct RawCall
+ * \brief A call site as read from a profile, before it is added in the graph.
+ */
+struct RawCall {
+    Function caller;        /*!< The calling function */
+    Function callee;        /*!< The called function */
+    unsigned int calls;     /*!< The number of calls */
+    double cost;            /*!< The cost of the calls */
+};
+
+/*!
+ * \brief Round a number of calls accumulated by a reader to the count of a function or a call site.
+ * \param calls The number of calls, possibly weighted or scaled
+ * \return The rounded number of calls, clamped to the range of an unsigned int
+ */
+inline unsigned int toCalls(double calls) {
+    if (!(calls > 0.0)) {
+        return 0;
+    }
+
+    double max = std::numeric_limits<unsigned int>::max();
+
+    return calls + 0.5 >= max ? std::numeric_limits<unsigned int>::max() : static_cast<unsigned int>(calls + 0.5);
+}
+
+/*!
+ * \class GraphBuilder
+ * \brief Builds the call sites of a call graph from the calls collected by a reader.
+ *
+ * The calls become the call sites of the call site table of the call graph, numbered in the order of the calls. The out
+ * and in call sites are grouped by function with a counting sort, each thread counts and places the call sites of its
+ * own range of functions, with a prefix sum over the ranges. The call sites of a function stay in the order of the
+ * calls, so the table does not depend on the number of threads.
+ *
+ * With a memory cap, the calls are spilled to a column mapped from a temporary file once they would take more than the
+ * cap, and the columns of the table are mapped if the table would take more than the cap. The pages of the mapped
+ * columns are released from the memory of the process once they have been written, the counting sort reads and writes
+ * them sequentially from the page cache.
+ */
+class GraphBuilder {
+    public:
+        /*!
+         * \brief Construct an empty builder.
+         * \param t The number of threads to use to group the call sites
+         * \param cap The size in bytes of the calls or of the table after which they are mapped from temporary files,
+         * 0 for no limit
+         */
+        explicit GraphBuilder(unsigned int t, std::size_t cap = 0) : threads(t), memoryCap(cap), count(0) {}
+
+        /*!
+         * \brief Reserve space for the given number of calls.
+         * \param size The number of calls
+         */
+        void reserve(std::size_t size);
+
+        /*!
+         * \brief Add a call, it becomes a call site of the graph, after the call sites of the previous calls.
+         * \param caller The calling function
+         * \param callee The called function
+         * \param calls The number of calls
+         * \param cost The cost of the calls
+         */
+        void addCall(Function caller, Function callee, unsigned int calls, double cost) {
+            if (count == capacity()) {
+                grow(count == 0 ? 1024 : 2 * count);
+            }
+
+            RawCall call = {caller, callee, calls, cost};
+
+            if (spill.isMapped()) {
+                spill[count] = call;
+
+                //The written pages are released by blocks of calls
+                if ((count + 1) % SPILL_BLOCK == 0) {
+                    spill.evict(count + 1 - SPILL_BLOCK, count + 1);
+                }
+            } else {
+                heap.push_back(call);
+            }
+
+            ++count;
+        }
+
+        /*!
+         * \brief Return the number of calls added to the builder.
+         * \return The number of calls
+         */
+        std::size_t size() const {
+            return count;
+        }
+
+        /*!
+         * \brief Indicate if the calls have been spilled to a temporary file.
+         * \return true if the calls are mapped from a temporary file
+         */
+        bool isSpilled() const {
+            return spill.isMapped();
+        }
+
+        /*!
+         * \brief Create the call graph of the given functions, the calls become its call sites.
+         * \param graph The functions, the graph belongs to the call graph
+         * \return The call graph
+         */
+        CallGraph* build(Graph* graph);
+
+        /*!
+         * \brief Fill a call site table with the calls, the previous call sites of the table are released. If the calls
+         * do not fit in 32 bits indexes, the table is left without call sites and marked as overflowed.
+         * \param table The table to fill
+         * \param functions The number of functions of the call graph
+         */
+        void build(CallSiteTable& table, std::size_t functions);
+
+    private:
+        //The number of calls written before their pages are released
+        static const std::size_t SPILL_BLOCK = 1 << 16;
+
+        unsigned int threads;
+        std::size_t memoryCap;
+        std::size_t count;
+
+        //The calls are either on the heap or in the spill column
+        std::vector<RawCall> heap;
+        Column<RawCall> spill;
+
+        std::size_t capacity() const {
+            return spill.isMapped() ? spill.size() : heap.capacity();
+        }
+
+        const RawCall& call(std::size_t index) const {
+            return spill.isMapped() ? spill[index] : heap[index];
+        }
+
+        void grow(std::size_t size);
+};
+
+} //end of inlining
+
+#endif
@@ -22,24 +22,37 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define GraphReader_H
 
 #include "Graph.hpp"
+#include "ProfileReader.hpp"
 
 namespace inlining {
 
-class Infos;
-class CallGraph;
-
 /*!
  * \class GraphReader
  * \brief A reader for a call graph.
  *        Reads a callgraph from a .dot and creates a CallGraph to use
+ *
+ * The fast reader splits the file in chunks starting at the beginning of a line that follows a complete statement.
+ * The chunks are parsed concurrently by the threads of the reader and merged in the order of the file, the numbering
+ * of the vertices does not depend on the number of threads.
  */
-class GraphReader {
+class GraphReader : public ProfileReader {
     public:
         /*!
          * \brief Construct a new GraphReader.
          * \param i The Infos object to use to retrieve information about the shared object.
          */
-        explicit GraphReader(Infos& i) : infos(i) {}
+        explicit GraphReader(Infos& i) : ProfileReader(i), useBoost(false) {}
+
+        /*!
+         * \brief Indicate if the file must be read with boost::read_graphviz instead of the fast reader.
+         *
+         * The fast reader maps the file in memory and decodes it without copies. It falls back to boost by itself
+         * when the file uses constructs it does not support (subgraphs, ports, ...).
+         * \param boost true to read with boost, false to use the fast reader.
+         */
+        void setUseBoost(bool boost) {
+            useBoost = boost;
+        }
 
         /*!
          * \brief Read a dot file and creates a new call graph. It is up to the user to delete the CallGraph
@@ -54,8 +67,10 @@ class GraphReader {
          */
         void extractInformation(CallGraph& graph);
     private:
-        Infos& infos;
+        bool useBoost;
 
+        CallGraph* readFast(const std::string& file);
+        CallGraph* readBoost(const std::string& file);
         void parseVertices(CallGraph& graph);
         void parseEdges(CallGraph& graph);
 };
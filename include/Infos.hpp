@@ -58,13 +58,38 @@ typedef std::unordered_set<std::string> VirtualFunctionSet;
  */
 typedef std::unordered_map<std::string, unsigned int> SizeMap;
 
+/*!
+ * \struct FunctionSymbol
+ * \brief A function of the symbol table of an ELF file.
+ */
+struct FunctionSymbol {
+    Elf64_Addr address;     /*!< The address of the first instruction of the function */
+    Elf64_Xword size;       /*!< The size of the function, 0 if unknown */
+    std::string name;       /*!< The name of the function */
+
+    FunctionSymbol(Elf64_Addr a, Elf64_Xword s, const std::string& n) : address(a), size(s), name(n) {}
+};
+
+/*!
+ * \brief The functions of an ELF file, sorted by address.
+ */
+typedef std::vector<FunctionSymbol> SymbolTable;
+
+/*!
+ * \brief Find the function containing the given address in a symbol table.
+ * \param table The symbol table, sorted by address
+ * \param address The address, relative to the file as in its symbol table
+ * \return The function containing the address or NULL if there are none
+ */
+const FunctionSymbol* findFunction(const SymbolTable& table, Elf64_Addr address);
+
 /*!
  * \class Infos
  * \brief Utility to get informations about function.
  */
 class Infos {
     public:
-        Infos() : m_demangled(false) {}
+        Infos() : m_demangled(false), m_keepSymbols(false) {}
 
         /*!
          * \brief Set if the Callgrind profile contains demangled (true) or mangled (false) names.
@@ -82,6 +107,12 @@ class Infos {
             return m_demangled;
         }
 
+        /*!
+         * \brief Parse the given library if it has not already been parsed.
+         * \param file the library name
+        */
+        void loadLibrary(const std::string& file);
+
         /*!
          * \brief Return the size of the given function in the given function
          * \param file the library name of the function
@@ -98,6 +129,28 @@ class Infos {
         */
         bool isVirtual(const std::string& file, const std::string& function);
 
+        /*!
+         * \brief Return the size of a function of a library that has already been loaded. The Infos are not modified,
+         * the method can be called from several threads.
+         * \param hash The hash of the function (file##function)
+         * \return The size of the function or 0 if the size cannot be found
+        */
+        unsigned int sizeOfHash(const std::string& hash) const {
+            auto found = functionSizes.find(hash);
+
+            return found == functionSizes.end() ? 0 : found->second;
+        }
+
+        /*!
+         * \brief Indicate if a function of a library that has already been loaded is virtual. The Infos are not
+         * modified, the method can be called from several threads.
+         * \param hash The hash of the function (file##function)
+         * \return true if the function is virtual
+        */
+        bool isVirtualHash(const std::string& hash) const {
+            return virtualFunctions.find(hash) != virtualFunctions.end();
+        }
+
         /*!
          * \brief Return all the detected virtual functions.
          * \return A set containing all the virtual functions.
@@ -122,6 +175,57 @@ class Infos {
             return files.size();
         }
 
+        /*!
+         * \brief Return the libraries that have been parsed.
+         * \return A set containing the path of each parsed library
+        */
+        const FileSet& getLibraries() const {
+            return files;
+        }
+
+        /*!
+         * \brief Restore the information of a library without parsing it. Used when loading a snapshot.
+         * \param file The path to the library
+        */
+        void addLibrary(const std::string& file) {
+            files.insert(file);
+        }
+
+        /*!
+         * \brief Restore a virtual function without parsing its library. Used when loading a snapshot.
+         * \param hash The hash of the function (file##function)
+        */
+        void addVirtualFunction(const std::string& hash) {
+            virtualFunctions.insert(hash);
+        }
+
+        /*!
+         * \brief Return the functions of the given file. The symbol table of the file is kept in memory the first time
+         * it is used, the file is parsed again if it has already been parsed without it. The returned table is never
+         * modified afterwards and can be shared between threads.
+         * \param file The path to the ELF file
+         * \return The functions of the file sorted by address, empty if the file cannot be parsed
+        */
+        const SymbolTable& symbolsOf(const std::string& file);
+
+        /*!
+         * \brief Indicate if the given file is an executable, not a shared object. The symbols of an executable are at
+         * their final address, the symbols of a shared object are relative to the file.
+         * \param file The path to the ELF file
+         * \return true if the file is an ELF executable
+        */
+        bool isExecutable(const std::string& file) const;
+
+        /*!
+         * \brief Find the function containing the given address.
+         * \param file The path to the ELF file
+         * \param address The address, relative to the file as in its symbol table
+         * \return The function containing the address or NULL if there are none
+        */
+        const FunctionSymbol* findFunction(const std::string& file, Elf64_Addr address) {
+            return inlining::findFunction(symbolsOf(file), address);
+        }
+
         /*!
          * \brief Parse the given file to extract information from.
          * \param file The file name.
@@ -142,8 +246,10 @@ class Infos {
         FileSet files;
         SizeMap functionSizes;
         VirtualFunctionSet virtualFunctions;
+        std::unordered_map<std::string, SymbolTable> symbolTables;
 
         bool m_demangled;
+        bool m_keepSymbols;
 
         void parseLibrary(const std::string& file, Elf* elf, Type type);
         void parseExecutable(const std::string& file, Elf* elf, Type type);
@@ -26,6 +26,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "Infos.hpp"
 #include "CallGraph.hpp"
+#include "ProfileReader.hpp"
+#include "Parallel.hpp"
+#include "Reordering.hpp"
 
 /*!
  * \namespace inlining
@@ -39,14 +42,20 @@ namespace inlining {
  */
 class Inlining {
     public:
-        Inlining() : m_issues(true), m_statistic(true), m_filter(false), m_default(false) {}
+        Inlining() : m_issues(true), m_statistic(true), m_filter(false), m_default(false), m_boost(false), m_lean(false), m_threads(defaultThreads()), m_memoryCap(0), m_order(ORIGINAL_ORDER), m_format(AUTO_FORMAT) {}
 
         /*!
          * \brief Analyze the given call graph and outputs every information about it in the console
-         * \param file The path to the call graph DOT file
+         * \param file The path to the call graph file (DOT, callgrind.out or snapshot), - to stream a DOT file from the standard input
         */
         void analyze(const std::string& file);
 
+        /*!
+         * \brief Merge several runs of the application and outputs every information about the merged call graph in the console
+         * \param files The paths to the call graph files of the runs
+        */
+        void analyze(const std::vector<std::string>& files);
+
         /*!
          * \brief Indicate if the Callgrind profile contains demangled (true) or mangled (false) names.
          * \param demangled Boolean tag indicating if the Callgrind profile contains demangled (true) or mangled (false) names.
@@ -93,14 +102,110 @@ class Inlining {
         void enableDefaultFilters() {
             m_default = true;
         }
+
+        /*!
+         * \brief Set the format of the call graph file. By default, the format is detected from the file.
+         * \param format The format of the call graph file
+        */
+        void setFormat(InputFormat format) {
+            m_format = format;
+        }
+
+        /*!
+         * \brief Indicate if the dot files must be read with boost::read_graphviz instead of the fast reader.
+         * \param boost Boolean tag indicating if boost must be used (true) or not (false).
+        */
+        void setUseBoostReader(bool boost) {
+            m_boost = boost;
+        }
+
+        /*!
+         * \brief Indicate if the call graph must be read in lean mode. A lean graph only keeps the names and the numeric
+         * fields, the labels are released as soon as they are decoded and the names are compressed before the analysis.
+         * \param lean Boolean tag indicating if the labels must be released (true) or kept (false).
+        */
+        void setLean(bool lean) {
+            m_lean = lean;
+        }
+
+        /*!
+         * \brief Set the number of threads to use. By default, all the cores are used.
+         * \param threads The number of threads
+        */
+        void setThreads(unsigned int threads) {
+            m_threads = threads == 0 ? 1 : threads;
+        }
+
+        /*!
+         * \brief Set the memory the column stores can each take on the heap: the calls collected by the reader, the
+         * call site table, the raw labels and the frozen call graph. A larger store is built in temporary files mapped
+         * in memory. By default, there is no limit.
+         * \param megabytes The memory cap in megabytes, 0 for no limit
+        */
+        void setMemoryCap(std::size_t megabytes) {
+            m_memoryCap = megabytes;
+        }
+
+        /*!
+         * \brief Set the order to give to the functions before the analysis. By default, the order of the profile is
+         * kept.
+         * \param order The order of the functions
+        */
+        void setVertexOrder(VertexOrder order) {
+            m_order = order;
+        }
+
+        /*!
+         * \brief Set the weights of the runs to merge, in the order of the files. The missing weights are 1.
+         * \param weights The weight of each run
+        */
+        void setWeights(const std::vector<double>& weights) {
+            m_weights = weights;
+        }
+
+        /*!
+         * \brief Save the call graph in a binary snapshot once it has been read.
+         * \param file The path to the snapshot to write
+        */
+        void setSnapshot(const std::string& file) {
+            m_snapshot = file;
+        }
+
+        /*!
+         * \brief Set the event to use for the costs of a callgrind profile or the sample type of a pprof profile.
+         * \param event The name of the event
+        */
+        void setEvent(const std::string& event) {
+            m_event = event;
+        }
+
+        /*!
+         * \brief Set the executable a gmon.out profile has been generated by.
+         * \param executable The path to the executable
+        */
+        void setExecutable(const std::string& executable) {
+            m_executable = executable;
+        }
     private:
         Infos infos;
         bool m_issues;
         bool m_statistic;
         bool m_filter;
         bool m_default;
+        bool m_boost;
+        bool m_lean;
+        unsigned int m_threads;
+        std::size_t m_memoryCap;
+        VertexOrder m_order;
+        InputFormat m_format;
+        std::string m_event;
+        std::string m_executable;
+        std::string m_snapshot;
         std::vector<std::string> filters;
+        std::vector<double> m_weights;
 
+        ProfileReader* createReader(const std::string& file, Infos& readerInfos, unsigned int threads);
+        void analyze(const std::string& file, CallGraph* graph);
         void printHeader(const std::string& file, const CallGraph& graph) const;
 };
 
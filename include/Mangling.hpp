@@ -0,0 +1,43 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef MANGLING_H
+#define MANGLING_H
+
+#include "StringRef.hpp"
+
+namespace inlining {
+
+/*!
+ * \brief Count the parameters of a function directly from its mangled name (Itanium C++ ABI), without demangling it.
+ *
+ * The mangled encoding is walked once without allocations. The substitutions and the template parameters are not
+ * resolved, each of them is a single type, only the pack expansions are replaced by the size of their argument pack.
+ * The return type of the template functions is not counted, like void for the functions without parameters.
+ * \param name The mangled name
+ * \return The number of parameters, 0 if the name is not the mangled name of a function, -1 if the name uses a
+ * construct that is not supported (expressions in the template arguments, decltype, ...) or is not valid
+ */
+int countMangledParameters(const StringRef& name);
+
+} //end of inlining
+
+#endif
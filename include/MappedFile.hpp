@@ -0,0 +1,97 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+namespace inlining {
+
+/*!
+ * \class MappedFile
+ * \brief A read-only memory mapping of a whole file. The mapping is released with the object.
+ *
+ * A compressed file (gzip or zstd) and the standard input cannot be mapped, their content is decompressed in memory
+ * instead.
+ */
+class MappedFile {
+    public:
+        /*!
+         * \brief Map the given file in memory.
+         * \param file The path to the file to map, - for the standard input.
+         */
+        explicit MappedFile(const std::string& file);
+
+        /*!
+         * \brief Unmap the file.
+         */
+        ~MappedFile();
+
+        /*!
+         * \brief Indicate if the file has been mapped.
+         * \return true if the file is mapped, false if it cannot be opened or mapped.
+         */
+        bool isOpen() const {
+            return opened;
+        }
+
+        /*!
+         * \brief Return the beginning of the mapped content.
+         * \return A pointer to the first byte of the file.
+         */
+        const char* begin() const {
+            return data;
+        }
+
+        /*!
+         * \brief Return the end of the mapped content.
+         * \return A pointer after the last byte of the file.
+         */
+        const char* end() const {
+            return data + length;
+        }
+
+        /*!
+         * \brief Return the size of the file.
+         * \return The size of the file in bytes.
+         */
+        size_t size() const {
+            return length;
+        }
+
+    private:
+        const char* data;
+        size_t length;
+        bool opened;
+
+        std::string content;    //The decompressed content, empty if the file is mapped
+
+        bool load(int fd, const std::string& file);
+
+        //Not copyable
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+};
+
+} //end of inlining
+
+#endif
@@ -0,0 +1,103 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstddef>
+
+namespace inlining {
+
+/*!
+ * \brief Return the number of threads to use by default.
+ * \return The number of hardware threads, at least 1
+ */
+inline unsigned int defaultThreads() {
+    unsigned int threads = std::thread::hardware_concurrency();
+
+    return threads == 0 ? 1 : threads;
+}
+
+/*!
+ * \brief Execute the given functor for each task in [0, tasks) using several threads, giving the index of the
+ * worker executing the task. This allows each worker to accumulate its results in its own structure and to reduce
+ * them after the end of the loop.
+ *
+ * The tasks are distributed dynamically, a worker takes the next task as soon as it has finished the previous one.
+ * With a single thread, the tasks are executed in order on the calling thread.
+ * \param tasks The number of tasks
+ * \param threads The maximum number of threads to use, the workers are numbered in [0, threads)
+ * \param functor The functor to execute, called with the index of the worker and the index of the task
+ */
+template<typename Functor>
+void parallelForWorker(size_t tasks, unsigned int threads, Functor functor) {
+    if (threads <= 1 || tasks <= 1) {
+        for (size_t task = 0; task < tasks; ++task) {
+            functor(0, task);
+        }
+
+        return;
+    }
+
+    if (threads > tasks) {
+        threads = tasks;
+    }
+
+    std::atomic<size_t> next(0);
+
+    auto worker = [&](unsigned int index) {
+        size_t task;
+        while ((task = next++) < tasks) {
+            functor(index, task);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 1; i < threads; ++i) {
+        pool.push_back(std::thread(worker, i));
+    }
+
+    //The calling thread works too
+    worker(0);
+
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+/*!
+ * \brief Execute the given functor for each task in [0, tasks) using several threads.
+ *
+ * The functor must be safe to call concurrently for different tasks.
+ * \param tasks The number of tasks
+ * \param threads The maximum number of threads to use
+ * \param functor The functor to execute, called with the index of the task
+ */
+template<typename Functor>
+void parallelFor(size_t tasks, unsigned int threads, Functor functor) {
+    parallelForWorker(tasks, threads, [&functor](unsigned int, size_t task){ functor(task); });
+}
+
+} //end of inlining
+
+#endif
@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef PERF_READER_H
+#define PERF_READER_H
+
+#include <string>
+
+#include "ProfileReader.hpp"
+#include "Parallel.hpp"
+
+namespace inlining {
+
+/*!
+ * \class PerfReader
+ * \brief A reader for the perf.data files recorded with perf record -g.
+ *
+ * The file is read directly, without perf script. A first sequential pass walks the records, builds the memory
+ * mappings of each process from the MMAP, MMAP2 and FORK records and loads the symbol tables of the mapped modules.
+ * The samples are then symbolized and accumulated in parallel, by batches, each thread in its own partial graph.
+ * The mappings are those known at the end of the file, a sample in a region that has been remapped later is resolved
+ * with the last mapping.
+ *
+ * The self cost of a function is the percentage of the periods of the samples in which it is the leaf of the
+ * callchain, the inclusive cost the percentage of the samples in which it appears, and each pair of consecutive
+ * frames is a call site. The number of samples is used as the number of calls. The addresses that cannot be resolved
+ * are attributed to a [unknown] function of their module. The batches of samples are processed by the threads of
+ * the reader.
+ */
+class PerfReader : public ProfileReader {
+    public:
+        /*!
+         * \brief Construct a new PerfReader.
+         * \param i The Infos object to use to retrieve information about the shared object.
+         */
+        explicit PerfReader(Infos& i) : ProfileReader(i), batchSize(1 << 16) {}
+
+        /*!
+         * \brief Read a perf.data file and creates a new call graph. It is up to the user to delete the CallGraph
+         * \param file The path to the file to read
+         * \return The call graph created from the samples or NULL if the file is not valid
+         */
+        CallGraph* read(const std::string& file);
+
+        /*!
+         * \brief Set the number of samples of a batch processed by a thread.
+         * \param size The number of samples
+         */
+        void setBatchSize(size_t size) {
+            batchSize = size == 0 ? 1 : size;
+        }
+
+    private:
+        size_t batchSize;
+};
+
+} //end of inlining
+
+#endif
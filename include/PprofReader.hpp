@@ -0,0 +1,84 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef PPROF_READER_H
+#define PPROF_READER_H
+
+#include <string>
+
+#include "ProfileReader.hpp"
+
+namespace inlining {
+
+/*!
+ * \class PprofReader
+ * \brief A reader for the pprof profiles (profile.proto) written by gperftools, Go and pprof -proto.
+ *
+ * The protocol buffer is decoded by hand, optionally decompressed from gzip or zstd, and streamed twice. The first
+ * pass keeps the string table, the mappings, the locations and the functions and skips the samples. The second pass
+ * accumulates the samples directly in the functions and the call sites. The memory depends on the number of
+ * locations and functions, not on the number of samples.
+ *
+ * The inlined functions of a location are expanded into call sites. A location without line information is resolved
+ * with the symbol table of its mapping, or attributed to a [unknown] function of its module. The self cost of a
+ * function is the percentage of the selected value of the samples in which it is the leaf, the inclusive cost the
+ * percentage of the samples in which it appears. The number of calls is the sample count when the profile has one.
+ */
+class PprofReader : public ProfileReader {
+    public:
+        /*!
+         * \brief Construct a new PprofReader.
+         * \param i The Infos object to use to retrieve information about the shared object.
+         */
+        explicit PprofReader(Infos& i) : ProfileReader(i), blockSize(1 << 20) {}
+
+        /*!
+         * \brief Select the value of the samples used for the costs (cpu, alloc_space, ...). By default, the default
+         * sample type of the profile or the last one.
+         * \param type The name of the sample type
+         */
+        void setSampleType(const std::string& type) {
+            sampleType = type;
+        }
+
+        /*!
+         * \brief Read a pprof profile and creates a new call graph. It is up to the user to delete the CallGraph
+         * \param file The path to the file to read
+         * \return The call graph created from the profile or NULL if the profile is not valid
+         */
+        CallGraph* read(const std::string& file);
+
+        /*!
+         * \brief Set the maximal number of bytes read at once from the file.
+         * \param size The size of a read in bytes
+         */
+        void setBlockSize(size_t size) {
+            blockSize = size == 0 ? 1 : size;
+        }
+
+    private:
+        std::string sampleType;
+        size_t blockSize;
+};
+
+} //end of inlining
+
+#endif
@@ -0,0 +1,89 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef PROFILE_MERGER_H
+#define PROFILE_MERGER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "ProfileReader.hpp"
+#include "Parallel.hpp"
+
+namespace inlining {
+
+/*!
+ * \class ProfileMerger
+ * \brief Merge several runs of the same application into a single call graph.
+ *
+ * The functions of the runs are aligned by module and name. The calls and the costs of the functions and of the
+ * call sites are summed, each run being weighted. The costs are percentages of the cost of each run, they are divided
+ * by the total weight to remain percentages. The merged graph is then completed like a graph read from a single
+ * profile.
+ *
+ * The runs are read in parallel. Each thread folds its runs in its own partial graph and releases each run as soon as
+ * it has been folded, the partial graphs are then reduced into the merged graph. The memory depends on the number of
+ * distinct functions, not on the number of runs. The runs are read by the threads of the merger.
+ */
+class ProfileMerger : public ProfileReader {
+    public:
+        /*!
+         * \brief The function creating the reader of a run. The reader must use the given Infos.
+         */
+        typedef std::function<ProfileReader*(const std::string&, Infos&)> ReaderFactory;
+
+        /*!
+         * \brief Construct a new ProfileMerger.
+         * \param i The Infos object to use to complete the merged graph.
+         * \param f The function creating the reader of a run.
+         */
+        ProfileMerger(Infos& i, ReaderFactory f) : ProfileReader(i), factory(f) {}
+
+        /*!
+         * \brief Add a run to merge.
+         * \param file The path to the profile of the run
+         * \param weight The weight of the run
+         */
+        void addRun(const std::string& file, double weight = 1.0);
+
+        /*!
+         * \brief Merge the runs added with addRun(). It is up to the user to delete the CallGraph
+         * \return The merged call graph
+         */
+        CallGraph* merge();
+
+        /*!
+         * \brief Add the given profile as a run with a weight of 1 and merge all the runs.
+         * \param file The path to the profile
+         * \return The merged call graph
+         */
+        CallGraph* read(const std::string& file);
+
+    private:
+        ReaderFactory factory;
+
+        std::vector<std::string> files;
+        std::vector<double> weights;
+};
+
+} //end of inlining
+
+#endif
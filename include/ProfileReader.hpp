@@ -0,0 +1,174 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef PROFILE_READER_H
+#define PROFILE_READER_H
+
+#include <string>
+#include <cstddef>
+
+#include "Graph.hpp"
+#include "Parallel.hpp"
+
+namespace inlining {
+
+class Infos;
+class CallGraph;
+
+/*!
+ * \enum InputFormat
+ * \brief The format of a call graph file given to the analyzer.
+ */
+enum InputFormat {
+    AUTO_FORMAT,        /*!< Detect the format from the content of the file. */
+    DOT_FORMAT,         /*!< A .dot file produced by tools/converter.py. */
+    CALLGRIND_FORMAT,   /*!< A raw callgrind.out profile. */
+    SNAPSHOT_FORMAT,    /*!< A binary snapshot written by SnapshotWriter. */
+    FOLDED_FORMAT,      /*!< The folded stacks of a sampling profiler (root;...;leaf samples). */
+    GMON_FORMAT,        /*!< A gmon.out profile of a program compiled with -pg. */
+    PERF_FORMAT,        /*!< A perf.data file recorded with perf record -g. */
+    PPROF_FORMAT        /*!< A pprof profile (profile.proto), possibly compressed. */
+};
+
+/*!
+ * \class ProfileReader
+ * \brief Base class of the readers creating a CallGraph from a profile.
+ *
+ * The readers are responsible of the topology and of the costs and calls of the functions and call sites. The
+ * information that does not depend on the profile format (parameters, size, virtuality and frequencies) is then
+ * completed by this class.
+ */
+class ProfileReader {
+    public:
+        /*!
+         * \brief Construct a new ProfileReader.
+         * \param i The Infos object to use to retrieve information about the shared object.
+         */
+        explicit ProfileReader(Infos& i) : infos(i), complete(true), lean(false), fields(ALL_FIELDS), threads(defaultThreads()), memoryCap(0) {}
+
+        /*!
+         * \brief Destruct the reader.
+         */
+        virtual ~ProfileReader() {}
+
+        /*!
+         * \brief Read a profile and creates a new call graph. It is up to the user to delete the CallGraph
+         * \param file The path to the file to read
+         * \return The call graph created from the profile
+         */
+        virtual CallGraph* read(const std::string& file) = 0;
+
+        /*!
+         * \brief Indicate if the graph must be completed with the information that does not depend on the profile.
+         *
+         * When the graph is not completed, the reader only sets the topology, the costs and the calls and does not use
+         * the Infos. This is used to read several runs before merging them.
+         * \param c true to complete the graph (the default), false to only read the profile
+         */
+        void setComplete(bool c) {
+            complete = c;
+        }
+
+        /*!
+         * \brief Select the fields of the functions and call sites that must be decoded while reading.
+         *
+         * The readers of the .dot files only decode the selected fields and keep the labels so that the other fields
+         * can be decoded later with CallGraph::decodeLabels(). The other readers always decode all the fields. The calls
+         * are always decoded, the frequencies depend on them.
+         * \param f The fields to decode (a combination of GraphField), all of them by default
+         */
+        void setFields(unsigned int f) {
+            fields = lean ? static_cast<unsigned int>(ALL_FIELDS) : f | FUNCTION_CALLS | CALL_SITE_CALLS;
+        }
+
+        /*!
+         * \brief Indicate if the graph must be read in lean mode.
+         *
+         * In lean mode, all the fields are decoded while reading and the labels are released once decoded, only the
+         * numeric fields and the names are kept in the graph. The selected fields are ignored.
+         * \param l true to read a lean graph, false to keep the labels (the default)
+         */
+        void setLean(bool l) {
+            lean = l;
+
+            if (lean) {
+                fields = ALL_FIELDS;
+            }
+        }
+
+        /*!
+         * \brief Set the number of threads used by the reader. By default, all the cores are used.
+         *
+         * The functions and the call sites are always completed in parallel, some readers use the threads to read the
+         * profile as well. The resulting graph does not depend on the number of threads.
+         * \param t The number of threads
+         */
+        void setThreads(unsigned int t) {
+            threads = t == 0 ? 1 : t;
+        }
+
+        /*!
+         * \brief Set the memory the calls, the call site table and the raw labels collected by the reader can each take
+         * on the heap. Above it, they are built in temporary files mapped in memory. By default, there is no limit.
+         * \param bytes The maximal size of each of them on the heap, 0 for no limit
+         */
+        void setMemoryCap(std::size_t bytes) {
+            memoryCap = bytes;
+        }
+
+    protected:
+        Infos& infos;           /*!< The Infos used to get the size and the virtuality of the functions */
+        bool complete;          /*!< Indicate if the graph must be completed */
+        bool lean;              /*!< Indicate if the labels must be released once decoded */
+        unsigned int fields;    /*!< The fields to decode, including the calls */
+        unsigned int threads;   /*!< The number of threads to use */
+        std::size_t memoryCap;  /*!< The size above which the columns are mapped from temporary files, 0 for no limit */
+
+        /*!
+         * \brief Complete the functions and then the call sites of the graph, if the reader must complete the graph.
+         * \param graph The call graph to complete
+         */
+        void completeGraph(CallGraph& graph);
+
+        /*!
+         * \brief Compute the parameters, size, virtuality and frequency of every function and the totals of the graph.
+         * The libraries of the functions are loaded first, the functions are then completed in parallel with partial
+         * totals per block of functions. The calls of the functions must have been set before.
+         * \param graph The call graph to complete
+         */
+        void completeFunctions(CallGraph& graph);
+
+        /*!
+         * \brief Compute the frequency of every call site. Must be called after completeFunctions().
+         * \param graph The call graph to complete
+         */
+        void completeCallSites(CallGraph& graph);
+};
+
+/*!
+ * \brief Detect the format of the given profile from its first bytes, decompressed if the file is compressed.
+ * \param file The path to the profile.
+ * \return The format of the profile, DOT_FORMAT if it cannot be detected.
+ */
+InputFormat detectFormat(const std::string& file);
+
+} //end of inlining
+
+#endif
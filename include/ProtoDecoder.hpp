@@ -0,0 +1,228 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef PROTO_DECODER_H
+#define PROTO_DECODER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "StringRef.hpp"
+
+namespace inlining {
+
+/*!
+ * \enum WireType
+ * \brief The encoding of a field of a protocol buffer message.
+ */
+enum WireType {
+    WIRE_VARINT = 0,        /*!< A variable length integer. */
+    WIRE_FIXED64 = 1,       /*!< A 64 bits value. */
+    WIRE_LENGTH = 2,        /*!< A length followed by bytes (strings, messages and packed fields). */
+    WIRE_START_GROUP = 3,   /*!< The beginning of a group (deprecated). */
+    WIRE_END_GROUP = 4,     /*!< The end of a group (deprecated). */
+    WIRE_FIXED32 = 5        /*!< A 32 bits value. */
+};
+
+/*!
+ * \brief Decode a variable length integer.
+ * \param it The position of the integer, moved after it
+ * \param end The end of the buffer
+ * \param value The decoded value
+ * \return false if the integer is truncated or longer than 10 bytes
+ */
+inline bool decodeVarint(const char*& it, const char* end, uint64_t& value) {
+    value = 0;
+
+    for (unsigned int shift = 0; shift < 64 && it < end; shift += 7) {
+        unsigned char byte = *it++;
+
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * \class ProtoDecoder
+ * \brief A decoder of a protocol buffer message held in memory, without generated code.
+ *
+ * The fields are read in the order of the buffer with next(), the value of each field must then be read with the
+ * function of its wire type or skipped. The strings and the nested messages reference the buffer.
+ */
+class ProtoDecoder {
+    public:
+        /*!
+         * \brief Construct a decoder for the given message.
+         * \param b The beginning of the message
+         * \param e The end of the message
+         */
+        ProtoDecoder(const char* b, const char* e) : it(b), end(e), error(false) {}
+
+        /*!
+         * \brief Construct a decoder for a nested message.
+         * \param message The bytes of the message
+         */
+        explicit ProtoDecoder(const StringRef& message) : it(message.begin), end(message.end), error(false) {}
+
+        /*!
+         * \brief Read the key of the next field.
+         * \param field The number of the field
+         * \param wire The wire type of the field
+         * \return false at the end of the message or on error
+         */
+        bool next(uint32_t& field, uint32_t& wire) {
+            if (error || it >= end) {
+                return false;
+            }
+
+            uint64_t key;
+            if (!decodeVarint(it, end, key) || (key >> 3) == 0) {
+                return fail();
+            }
+
+            field = key >> 3;
+            wire = key & 7;
+
+            return true;
+        }
+
+        /*!
+         * \brief Read the value of a varint field.
+         * \param value The value to fill
+         * \return false on error
+         */
+        bool varint(uint64_t& value) {
+            return decodeVarint(it, end, value) || fail();
+        }
+
+        /*!
+         * \brief Read the value of a length-delimited field.
+         * \param value The reference to the bytes of the field
+         * \return false on error
+         */
+        bool bytes(StringRef& value) {
+            uint64_t length;
+            if (!decodeVarint(it, end, length) || length > static_cast<uint64_t>(end - it)) {
+                return fail();
+            }
+
+            value = StringRef(it, it + length);
+            it += length;
+
+            return true;
+        }
+
+        /*!
+         * \brief Read a repeated integer field, packed or not. The values are appended to the vector.
+         * \param wire The wire type of the field
+         * \param values The vector to append the values to
+         * \return false on error
+         */
+        bool repeated(uint32_t wire, std::vector<uint64_t>& values) {
+            uint64_t value;
+
+            if (wire == WIRE_VARINT) {
+                if (!varint(value)) {
+                    return false;
+                }
+
+                values.push_back(value);
+
+                return true;
+            }
+
+            StringRef packed;
+            if (wire != WIRE_LENGTH || !bytes(packed)) {
+                return fail();
+            }
+
+            for (const char* p = packed.begin; p < packed.end;) {
+                if (!decodeVarint(p, packed.end, value)) {
+                    return fail();
+                }
+
+                values.push_back(value);
+            }
+
+            return true;
+        }
+
+        /*!
+         * \brief Skip the value of a field.
+         * \param wire The wire type of the field
+         * \return false on error
+         */
+        bool skip(uint32_t wire) {
+            uint64_t value;
+            StringRef ignored;
+
+            switch (wire) {
+                case WIRE_VARINT:
+                    return varint(value);
+                case WIRE_FIXED64:
+                    return advance(8);
+                case WIRE_LENGTH:
+                    return bytes(ignored);
+                case WIRE_FIXED32:
+                    return advance(4);
+                default:
+                    //The groups are not used by proto3
+                    return fail();
+            }
+        }
+
+        /*!
+         * \brief Indicate if the message is invalid.
+         * \return true if an error has been encountered
+         */
+        bool failed() const {
+            return error;
+        }
+
+    private:
+        const char* it;
+        const char* end;
+        bool error;
+
+        bool advance(size_t size) {
+            if (static_cast<size_t>(end - it) < size) {
+                return fail();
+            }
+
+            it += size;
+            return true;
+        }
+
+        bool fail() {
+            error = true;
+            return false;
+        }
+};
+
+} //end of inlining
+
+#endif
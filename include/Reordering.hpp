@@ -0,0 +1,54 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef REORDERING_H
+#define REORDERING_H
+
+#include <vector>
+
+#include "Graph.hpp"
+
+namespace inlining {
+
+class CallGraph;
+
+/*!
+ * \enum VertexOrder
+ * \brief The order to give to the functions of a call graph before its analysis.
+ */
+enum VertexOrder {
+    ORIGINAL_ORDER,     /*!< Keep the order of the profile. */
+    RCM_ORDER,          /*!< Reverse Cuthill-McKee, the callers and callees of a function get close numbers. */
+    BFS_ORDER,          /*!< Breadth first from main along the calls, then from the unreached functions. */
+    MODULE_ORDER        /*!< By module, in the order the modules are met, the most called functions first in each module. */
+};
+
+/*!
+ * \brief Compute a new order of the functions of a call graph.
+ * \param graph The call graph
+ * \param order The order to compute
+ * \return The functions in their new order, the new identifier of a function is its index
+ */
+std::vector<Function> computeOrder(const CallGraph& graph, VertexOrder order);
+
+} //end of inlining
+
+#endif
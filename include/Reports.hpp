@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <set>
 
 #include "CallGraph.hpp"
+#include "FrozenGraph.hpp"
 #include "Graph.hpp"
 
 namespace inlining {
@@ -39,14 +40,14 @@ class Analyzer;
 class Reports {
     public:
         /*!
-         * \brief Construct a new Reports
+         * \brief Construct a new Reports. The call graph must have been frozen by the analyzer.
          * \param g The call graph
          * \param a The analyzer
         */
         Reports(const CallGraph& g, const Analyzer& a) : graph(g), analyzer(a) {}
 
         /*!
-         * \brief Add a filter
+         * \brief Add a filter. A filter ending with * filters all the functions starting with the rest of the filter.
          * \param filter the filter to add
         */
         void addFilter(const std::string& filter);
@@ -68,7 +69,15 @@ class Reports {
          * \param cs The call site to test
          * \return true if the call site has to be filtered otherwise false
         */
-        bool filter(const CallSite& cs) const;
+        bool filterCallSite(FrozenCallSite cs) const;
+
+        /*!
+         * \brief Indicate for each function if it has to be filtered. The filters are searched once per function,
+         * not once per call site. If the names are compressed, the filters are searched in the name table without
+         * decoding the other names.
+         * \return A vector indexed by function, true if the function has to be filtered otherwise false
+        */
+        std::vector<char> filteredFunctions() const;
 
         /*!
          * \brief Return the top biggest functions
@@ -101,9 +110,9 @@ class Reports {
         /*!
          * \brief Return the top most called call sites
          * \param top The number of call sites to return, 20 by default
-         * \return A vector containing the top most called call sites of the application
+         * \return A vector containing the top most called call sites of the application, as call sites of the frozen graph
         */
-        std::vector<CallSite> getMostCalledCallSites(unsigned int top = 20) const;
+        std::vector<FrozenCallSite> getMostCalledCallSites(unsigned int top = 20) const;
 
         /*!
          * \brief Return the top most parameterized functions
@@ -115,9 +124,9 @@ class Reports {
         /*!
          * \brief Return the top most interesting call sites
          * \param top The number of call sites to return, 20 by default
-         * \return A vector containing the top most interesting call sites of the application
+         * \return A vector containing the top most interesting call sites of the application, as call sites of the frozen graph
         */
-        std::vector<CallSite> getMostInterestingCallSites(unsigned int top = 20) const;
+        std::vector<FrozenCallSite> getMostInterestingCallSites(unsigned int top = 20) const;
 
         /*!
          * \brief Return the top tiniest functions
@@ -129,16 +138,34 @@ class Reports {
         /*!
          * \brief Return the top heaviest inter library call sites
          * \param top The number of functions to return, 20 by default
-         * \return A vector containing the top inter library call sites of the application
+         * \return A vector containing the top inter library call sites of the application, as call sites of the frozen graph
         */
-        std::vector<CallSite> getHeaviestInterLibraryCalls(unsigned int top = 20) const;
+        std::vector<FrozenCallSite> getHeaviestInterLibraryCalls(unsigned int top = 20) const;
 
         /*!
          * \brief Return the top heaviest virtual call sites
          * \param top The number of functions to return, 20 by default
-         * \return A vector containing the top heaviest virtual call sites of the application
+         * \return A vector containing the top heaviest virtual call sites of the application, as call sites of the frozen graph
+        */
+        std::vector<FrozenCallSite> getHeaviestVirtualCalls(unsigned int top = 20) const;
+
+        /*!
+         * \brief Return the fields of the functions and call sites read by the statistic reports, in addition to the
+         * fields used by the analyzer.
+         * \return The fields used by printStatisticReports() (a combination of GraphField)
         */
-        std::vector<CallSite> getHeaviestVirtualCalls(unsigned int top = 20) const;
+        static unsigned int statisticFields() {
+            return FUNCTION_CALLS | CALL_SITE_CALLS | FUNCTION_SELF_COST;
+        }
+
+        /*!
+         * \brief Return the fields of the functions and call sites read by the issues, in addition to the fields used
+         * by the analyzer.
+         * \return The fields used by printIssues() (a combination of GraphField)
+        */
+        static unsigned int issueFields() {
+            return FUNCTION_CALLS | CALL_SITE_CALLS;
+        }
 
         /*!
          * \brief Print all the statistic report
@@ -265,12 +292,12 @@ class Reports {
         */
         template <class Compare>
         std::vector<Function> getTopFunctions(unsigned int top, Compare compare) const {
+            std::vector<char> filtered = filteredFunctions();
             std::vector<Function> functions;
 
-            FunctionIterator first, last;
-            for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
-                if (!filter(*first)) {
-                    functions.push_back(*first);
+            for (Function function = 0; function < filtered.size(); ++function) {
+                if (!filtered[function]) {
+                    functions.push_back(function);
                 }
             }
 
@@ -283,16 +310,17 @@ class Reports {
          * \brief Return all the top great call sites according to the given comparator
          * \param top The number of call sites to return
          * \param compare The comparator to use
-         * \return A vector containing the top great call sites
+         * \return A vector containing the top great call sites, as call sites of the frozen graph
         */
         template <class Compare>
-        std::vector<CallSite> getTopCallSites(unsigned int top, Compare compare) const {
-            std::vector<CallSite> callSites;
-
-            CallSiteIterator first, last;
-            for (boost::tie(first, last) = graph.callSites(); first != last; ++first) {
-                if (!filter(*first)) {
-                    callSites.push_back(*first);
+        std::vector<FrozenCallSite> getTopCallSites(unsigned int top, Compare compare) const {
+            const FrozenGraph& frozen = graph.getFrozenGraph();
+            std::vector<char> filtered = filteredFunctions();
+            std::vector<FrozenCallSite> callSites;
+
+            for (FrozenCallSite site = 0; site < frozen.numberOfCallSites(); ++site) {
+                if (!filtered[frozen.source(site)] && !filtered[frozen.target(site)]) {
+                    callSites.push_back(site);
                 }
             }
 
@@ -302,6 +330,7 @@ class Reports {
         }
     private:
         std::set<std::string> filters;
+        std::vector<std::string> prefixes;
         const CallGraph& graph;
         const Analyzer& analyzer;
 
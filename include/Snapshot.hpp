@@ -0,0 +1,108 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace inlining {
+
+/*!
+ * \brief The first bytes of every snapshot file.
+ */
+static const char SNAPSHOT_MAGIC[8] = {'I', 'N', 'L', 'S', 'N', 'A', 'P', '\0'};
+
+/*!
+ * \brief The version of the snapshot format. Must be incremented at each change of the layout.
+ */
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+/*!
+ * \brief Written in the native byte order to detect the snapshots coming from another architecture.
+ */
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+/*!
+ * \struct SnapshotHeader
+ * \brief The header of a snapshot file.
+ *
+ * A snapshot is the header followed by the functions, the call sites, the string offsets, the libraries, the virtual
+ * functions and the characters of the strings. Every section starts at a multiple of 8 bytes.
+ */
+struct SnapshotHeader {
+    char magic[8];                  /*!< SNAPSHOT_MAGIC */
+    uint32_t version;               /*!< SNAPSHOT_VERSION */
+    uint32_t byteOrder;             /*!< SNAPSHOT_BYTE_ORDER */
+    uint32_t functions;             /*!< The number of functions */
+    uint32_t callSites;             /*!< The number of call sites */
+    uint32_t strings;               /*!< The number of interned strings */
+    uint32_t libraries;             /*!< The number of parsed libraries */
+    uint32_t virtualFunctions;      /*!< The number of virtual functions */
+    uint32_t calls;                 /*!< The total number of calls of the graph */
+    uint32_t applicationSize;       /*!< The total size of the application */
+    uint32_t padding;               /*!< Unused */
+    uint64_t characters;            /*!< The number of characters of all the strings */
+};
+
+/*!
+ * \struct SnapshotFunction
+ * \brief A function of a snapshot. The strings are indexes in the string table.
+ */
+struct SnapshotFunction {
+    double selfCost;            /*!< The cost of the function */
+    double inclusiveCost;       /*!< The inclusive cost of the function */
+    double frequency;           /*!< The frequency of the function */
+    uint32_t calls;             /*!< The number of calls of the function */
+    uint32_t parameters;        /*!< The number of parameters of the function */
+    uint32_t size;              /*!< The size of the function */
+    uint32_t virtuality;        /*!< 1 if the function is virtual, otherwise 0 */
+    uint32_t name;              /*!< The name of the function */
+    uint32_t module;            /*!< The shared object of the function */
+    uint32_t fileName;          /*!< The file the function has been defined in */
+    uint32_t padding;           /*!< Unused */
+};
+
+/*!
+ * \struct SnapshotCallSite
+ * \brief A call site of a snapshot. The source and the target are indexes of functions.
+ */
+struct SnapshotCallSite {
+    double cost;                /*!< The cost of the call site */
+    double frequency;           /*!< The frequency of the call site */
+    uint32_t source;            /*!< The caller */
+    uint32_t target;            /*!< The callee */
+    uint32_t calls;             /*!< The number of calls of the call site */
+    uint32_t padding;           /*!< Unused */
+};
+
+/*!
+ * \brief Round the size of a section to keep the next one aligned.
+ * \param size The size of the section in bytes
+ * \return The size of the section with its padding
+ */
+inline uint64_t alignSection(uint64_t size) {
+    return (size + 7) & ~static_cast<uint64_t>(7);
+}
+
+} //end of inlining
+
+#endif
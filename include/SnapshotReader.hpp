@@ -0,0 +1,53 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef SNAPSHOT_READER_H
+#define SNAPSHOT_READER_H
+
+#include "ProfileReader.hpp"
+
+namespace inlining {
+
+/*!
+ * \class SnapshotReader
+ * \brief A reader for the binary snapshots written by SnapshotWriter.
+ *
+ * The snapshot is mapped in memory and copied into the graph without any parsing. The libraries and the virtual
+ * functions saved in the snapshot are restored in the Infos, the ELF files are not parsed again.
+ */
+class SnapshotReader : public ProfileReader {
+    public:
+        /*!
+         * \brief Construct a new SnapshotReader.
+         * \param i The Infos object to restore the libraries and the virtual functions into.
+         */
+        explicit SnapshotReader(Infos& i) : ProfileReader(i) {}
+
+        /*!
+         * \brief Read a snapshot and creates a new call graph. It is up to the user to delete the CallGraph
+         * \param file The path to the snapshot
+         * \return The call graph saved in the snapshot or NULL if the snapshot is not valid
+         */
+        CallGraph* read(const std::string& file);
+};
+
+} //end of inlining
+
+#endif
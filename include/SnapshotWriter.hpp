@@ -0,0 +1,60 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef SNAPSHOT_WRITER_H
+#define SNAPSHOT_WRITER_H
+
+#include <string>
+
+namespace inlining {
+
+class Infos;
+class CallGraph;
+
+/*!
+ * \class SnapshotWriter
+ * \brief Save a fully extracted call graph in a binary snapshot that can be reloaded by SnapshotReader.
+ *
+ * The snapshot contains everything the analyzer needs, including the libraries and the virtual functions found by
+ * Infos, so that the ELF files do not need to be parsed again.
+ */
+class SnapshotWriter {
+    public:
+        /*!
+         * \brief Construct a new SnapshotWriter.
+         * \param i The Infos object used to read the call graph.
+         */
+        explicit SnapshotWriter(const Infos& i) : infos(i) {}
+
+        /*!
+         * \brief Write the given call graph in a snapshot.
+         * \param graph The call graph to save
+         * \param file The path to the snapshot file
+         * \return true if the snapshot has been written, otherwise false
+         */
+        bool write(const CallGraph& graph, const std::string& file);
+
+    private:
+        const Infos& infos;
+};
+
+} //end of inlining
+
+#endif
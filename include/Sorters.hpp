@@ -23,138 +23,176 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <vector>
 
-namespace inlining {
+#include "FrozenGraph.hpp"
 
-class CallGraph;
+namespace inlining {
 
 /*!
  * \class SortByTemperature
- * \brief Sort something by temperature
+ * \brief Sort the functions by temperature
  */
 class SortByTemperature {
     public:
         /*!
          * \brief Create the sorter.
-         * \param g The call graph to use.
+         * \param g The frozen call graph to use.
         */
-        explicit SortByTemperature(const CallGraph& g) : graph(g) {}
+        explicit SortByTemperature(const FrozenGraph& g) : graph(g) {}
 
         /*!
-         * \brief Compare the two objects by their temperature.
-         * \param a The first object.
-         * \param b The second object.
-         * \tparam T The type of object to compare
+         * \brief Compare the two functions by their temperature.
+         * \param a The first function.
+         * \param b The second function.
         */
-        template<typename T>
-        bool operator()(const T& a, const T& b) {
-            return graph[a].temperature < graph[b].temperature;
+        bool operator()(Function a, Function b) const {
+            return graph.temperature(a) < graph.temperature(b);
         }
     private:
-        const CallGraph& graph;
+        const FrozenGraph& graph;
+};
+
+/*!
+ * \class SortCallSitesByTemperature
+ * \brief Sort the call sites by temperature
+ */
+class SortCallSitesByTemperature {
+    public:
+        /*!
+         * \brief Create the sorter.
+         * \param g The frozen call graph to use.
+        */
+        explicit SortCallSitesByTemperature(const FrozenGraph& g) : graph(g) {}
+
+        /*!
+         * \brief Compare the two call sites by their temperature.
+         * \param a The first call site.
+         * \param b The second call site.
+        */
+        bool operator()(FrozenCallSite a, FrozenCallSite b) const {
+            return graph.callSiteTemperature(a) < graph.callSiteTemperature(b);
+        }
+    private:
+        const FrozenGraph& graph;
 };
 
 /*!
  * \class SortByCalls
- * \brief Sort something by the number of calls
+ * \brief Sort the functions by the number of calls
  */
 class SortByCalls {
     public:
         /*!
          * \brief Create the sorter.
-         * \param g The call graph to use.
+         * \param g The frozen call graph to use.
         */
-        explicit SortByCalls(const CallGraph& g) : graph(g) {}
+        explicit SortByCalls(const FrozenGraph& g) : graph(g) {}
 
         /*!
-         * \brief Compare the two objects by their number of calls.
-         * \param a The first object.
-         * \param b The second object.
-         * \tparam T The type of object to compare
+         * \brief Compare the two functions by their number of calls.
+         * \param a The first function.
+         * \param b The second function.
+        */
+        bool operator()(Function a, Function b) const {
+            return graph.calls(a) < graph.calls(b);
+        }
+    private:
+        const FrozenGraph& graph;
+};
+
+/*!
+ * \class SortCallSitesByCalls
+ * \brief Sort the call sites by the number of calls
+ */
+class SortCallSitesByCalls {
+    public:
+        /*!
+         * \brief Create the sorter.
+         * \param g The frozen call graph to use.
+        */
+        explicit SortCallSitesByCalls(const FrozenGraph& g) : graph(g) {}
+
+        /*!
+         * \brief Compare the two call sites by their number of calls.
+         * \param a The first call site.
+         * \param b The second call site.
         */
-        template<typename T>
-        bool operator()(const T& a, const T& b) {
-            return graph[a].calls < graph[b].calls;
+        bool operator()(FrozenCallSite a, FrozenCallSite b) const {
+            return graph.callSiteCalls(a) < graph.callSiteCalls(b);
         }
     private:
-        const CallGraph& graph;
+        const FrozenGraph& graph;
 };
 
 /*!
  * \class SortBySize
- * \brief Sort something by size
+ * \brief Sort the functions by size
  */
 class SortBySize {
     public:
         /*!
          * \brief Create the sorter.
-         * \param g The call graph to use.
+         * \param g The frozen call graph to use.
         */
-        explicit SortBySize(const CallGraph& g) : graph(g) {}
+        explicit SortBySize(const FrozenGraph& g) : graph(g) {}
 
         /*!
-         * \brief Compare the two objects by their size.
-         * \param a The first object.
-         * \param b The second object.
-         * \tparam T The type of object to compare
+         * \brief Compare the two functions by their size.
+         * \param a The first function.
+         * \param b The second function.
         */
-        template<typename T>
-        bool operator()(const T& a, const T& b) {
-            return (graph[a].size) < (graph[b].size);
+        bool operator()(Function a, Function b) const {
+            return graph.size(a) < graph.size(b);
         }
     private:
-        const CallGraph& graph;
+        const FrozenGraph& graph;
 };
 
 /*!
  * \class SortByParameters
- * \brief Sort something by the number of parameters
+ * \brief Sort the functions by the number of parameters
  */
 class SortByParameters {
     public:
         /*!
          * \brief Create the sorter.
-         * \param g The call graph to use.
+         * \param g The frozen call graph to use.
         */
-        explicit SortByParameters(const CallGraph& g) : graph(g) {}
+        explicit SortByParameters(const FrozenGraph& g) : graph(g) {}
 
         /*!
-         * \brief Compare the two objects by their number of parameters.
-         * \param a The first object.
-         * \param b The second object.
-         * \tparam T The type of object to compare
+         * \brief Compare the two functions by their number of parameters.
+         * \param a The first function.
+         * \param b The second function.
         */
-        template<typename T>
-        bool operator()(const T& a, const T& b) {
-            return graph[a].parameters < graph[b].parameters;
+        bool operator()(Function a, Function b) const {
+            return graph.parameters(a) < graph.parameters(b);
         }
     private:
-        const CallGraph& graph;
+        const FrozenGraph& graph;
 };
 
 /*!
  * \class SortBySelfCosts
- * \brief Sort something by self cost
+ * \brief Sort the functions by self cost
  */
 class SortBySelfCosts {
     public:
         /*!
          * \brief Create the sorter.
-         * \param g The call graph to use.
+         * \param g The frozen call graph to use.
         */
-        explicit SortBySelfCosts(const CallGraph& g) : graph(g) {}
+        explicit SortBySelfCosts(const FrozenGraph& g) : graph(g) {}
 
         /*!
-         * \brief Compare the two objects by their self costs.
-         * \param a The first object.
-         * \param b The second object.
-         * \tparam T The type of object to compare
+         * \brief Compare the two functions by their self costs.
+         * \param a The first function.
+         * \param b The second function.
         */
-        template<typename T>
-        bool operator()(const T& a, const T& b) {
-            return graph[a].self_cost < graph[b].self_cost;
+        bool operator()(Function a, Function b) const {
+            return graph.selfCost(a) < graph.selfCost(b);
         }
     private:
-        const CallGraph& graph;
+        const FrozenGraph& graph;
 };
 
 /*!
@@ -208,29 +246,26 @@ class SortHierarchyIssue {
 
 /*!
  * \class FilterByTemperature
- * \brief Filter the given values keeping only the values with a temperature greater than the given threshold.
- * \param T The type of object to filter.
+ * \brief Filter the call sites keeping only the call sites with a temperature greater than the given threshold.
  */
 class FilterByTemperature {
     public:
         /*!
-         * \brief Create the sorter.
-         * \param g The call graph to use.
+         * \brief Create the filter.
+         * \param g The frozen call graph to use.
          * \param t The threshold.
         */
-        FilterByTemperature(const Graph& g, double t) : graph(g), threshold(t) {}
+        FilterByTemperature(const FrozenGraph& g, double t) : graph(g), threshold(t) {}
 
         /*!
-         * \brief Filter the given object if its temperature is lower than the threshold
-         * \param a The first object.
-         * \tparam T The type of object to compare
+         * \brief Filter the given call site if its temperature is lower than the threshold
+         * \param a The call site.
         */
-        template <typename T>
-        bool operator()(const T& a) const  {
-            return graph[a].temperature < threshold;
+        bool operator()(FrozenCallSite a) const  {
+            return graph.callSiteTemperature(a) < threshold;
         }
     private:
-        const Graph& graph;
+        const FrozenGraph& graph;
         double threshold;
 };
 
@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef STREAM_READER_H
+#define STREAM_READER_H
+
+#include "ProfileReader.hpp"
+
+namespace inlining {
+
+/*!
+ * \class StreamReader
+ * \brief A reader for a .dot call graph coming from a pipe, for instance the standard output of converter.py, or
+ *        from a compressed file.
+ *
+ * The stream is processed by a pipeline of three stages connected by bounded queues. The first stage reads and
+ * decompresses the input (gzip or zstd, detected from the first bytes) and cuts it in blocks of complete statements,
+ * the second one parses the blocks, interns the names and
+ * decodes the labels, the third one parses the ELF file of each new module as soon as it appears. Once the last byte
+ * has been read, only the totals and the frequencies remain to be computed.
+ */
+class StreamReader : public ProfileReader {
+    public:
+        /*!
+         * \brief Construct a new StreamReader.
+         * \param i The Infos object to use to retrieve information about the shared object.
+         */
+        explicit StreamReader(Infos& i) : ProfileReader(i), blockSize(1 << 20), queueSize(16) {}
+
+        /*!
+         * \brief Read a call graph from a stream and creates a new call graph. It is up to the user to delete the CallGraph
+         * \param file The path to the stream to read, - for the standard input
+         * \return The call graph read from the stream or NULL if the stream is not a valid dot graph
+         */
+        CallGraph* read(const std::string& file);
+
+        /*!
+         * \brief Set the maximal number of bytes read at once from the stream.
+         * \param size The size of a read in bytes
+         */
+        void setBlockSize(size_t size) {
+            blockSize = size == 0 ? 1 : size;
+        }
+
+        /*!
+         * \brief Set the capacity of the queues between the stages.
+         * \param size The maximal number of elements waiting in a queue
+         */
+        void setQueueSize(size_t size) {
+            queueSize = size;
+        }
+
+    private:
+        size_t blockSize;
+        size_t queueSize;
+};
+
+} //end of inlining
+
+#endif
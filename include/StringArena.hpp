@@ -0,0 +1,122 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "StringRef.hpp"
+
+namespace inlining {
+
+/*!
+ * \class StringArena
+ * \brief A bump allocator for the strings of a graph.
+ *
+ * The characters are copied at the end of large chunks, a string is never freed alone, all the chunks are freed at
+ * once with the arena. The stored strings are null-terminated and stay valid until the arena is destroyed. The arena
+ * must not be used from several threads, but the space reserved by allocate() can be filled by any thread.
+ */
+class StringArena {
+    public:
+        /*!
+         * \brief Construct an empty arena, no memory is allocated before the first string.
+         */
+        StringArena() : position(NULL), remaining(0), used(0), reserved(0) {}
+
+        /*!
+         * \brief Construct an empty arena. The strings are never copied between arenas, the references stored in a
+         * copied graph still point into the arena of the original graph, which must outlive the copy.
+         */
+        StringArena(const StringArena&) : position(NULL), remaining(0), used(0), reserved(0) {}
+
+        /*!
+         * \brief Free all the chunks of the arena, the stored strings become invalid.
+         */
+        ~StringArena();
+
+        /*!
+         * \brief Reserve characters in the arena.
+         * \param size The number of characters to reserve
+         * \return A pointer to the first reserved character
+         */
+        char* allocate(std::size_t size);
+
+        /*!
+         * \brief Copy the given characters in the arena.
+         * \param value The characters to copy
+         * \return A reference to the copy, followed by a null character
+         */
+        StringRef store(const StringRef& value);
+
+        /*!
+         * \brief Copy the given string in the arena.
+         * \param value The string to copy
+         * \return A reference to the copy, followed by a null character
+         */
+        StringRef store(const std::string& value) {
+            return store(StringRef(value));
+        }
+
+        /*!
+         * \brief Free all the chunks of the arena, the stored strings become invalid.
+         */
+        void clear();
+
+        /*!
+         * \brief Exchange the chunks of two arenas, the stored strings stay valid and now belong to the other arena.
+         * \param rhs The arena to exchange the chunks with
+         */
+        void swap(StringArena& rhs);
+
+        /*!
+         * \brief Return the number of characters reserved by allocate() and store().
+         * \return The number of used characters
+         */
+        std::size_t size() const {
+            return used;
+        }
+
+        /*!
+         * \brief Return the number of characters allocated by the arena, used or not.
+         * \return The total size of the chunks
+         */
+        std::size_t capacity() const {
+            return reserved;
+        }
+
+    private:
+        std::vector<char*> chunks;
+        char* position;             //The next free character of the last chunk
+        std::size_t remaining;      //The number of free characters of the last chunk
+        std::size_t used;
+        std::size_t reserved;
+
+        //The chunks of an arena cannot be replaced while they are referenced
+        StringArena& operator=(const StringArena& rhs);
+};
+
+} //end of inlining
+
+#endif
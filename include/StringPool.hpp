@@ -0,0 +1,110 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+
+#include "StringRef.hpp"
+
+namespace inlining {
+
+/*!
+ * \brief The identifier of an interned string. The identifiers are dense, from 0 to the number of strings.
+ */
+typedef unsigned int StringId;
+
+/*!
+ * \brief The identifier of the empty string in every pool.
+ */
+const StringId EMPTY_STRING = 0;
+
+/*!
+ * \class StringPool
+ * \brief Gives a dense identifier to each distinct string and keeps a single copy of each of them.
+ *
+ * The references returned by the pool stay valid until the pool is destroyed. The pool can be read from several
+ * threads, but intern() must not be called concurrently.
+ */
+class StringPool {
+    public:
+        /*!
+         * \brief Construct a pool containing only the empty string.
+         */
+        StringPool();
+
+        /*!
+         * \brief Copy a pool, the strings keep the same identifiers.
+         * \param rhs The pool to copy
+         */
+        StringPool(const StringPool& rhs);
+
+        /*!
+         * \brief Replace the strings of this pool by a copy of the strings of another one.
+         * \param rhs The pool to copy
+         * \return A reference to this pool
+         */
+        StringPool& operator=(const StringPool& rhs);
+
+        /*!
+         * \brief Return the identifier of the given string, the string is added to the pool if necessary.
+         * \param value The string to intern
+         * \return The identifier of the string
+         */
+        StringId intern(const StringRef& value);
+
+        /*!
+         * \brief Return the identifier of the given string, the string is added to the pool if necessary.
+         * \param value The string to intern
+         * \return The identifier of the string
+         */
+        StringId intern(const std::string& value) {
+            return intern(StringRef(value));
+        }
+
+        /*!
+         * \brief Return the string with the given identifier.
+         * \param id The identifier of the string
+         * \return The interned string
+         */
+        const std::string& operator[](StringId id) const {
+            return strings[id];
+        }
+
+        /*!
+         * \brief Return the number of strings of the pool.
+         * \return The number of strings, the identifiers are lower than this number
+         */
+        StringId size() const {
+            return strings.size();
+        }
+
+    private:
+        std::deque<std::string> strings;                                //A deque never moves its elements
+        std::unordered_map<StringRef, StringId, StringRefHash> ids;     //References the strings of the deque
+};
+
+} //end of inlining
+
+#endif
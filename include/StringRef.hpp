@@ -0,0 +1,144 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*! \file */
+
+#ifndef STRING_REF_H
+#define STRING_REF_H
+
+#include <string>
+#include <ostream>
+#include <cstring>
+#include <cstddef>
+
+namespace inlining {
+
+/*!
+ * \struct StringRef
+ * \brief A reference to a part of a buffer. The referenced characters are not copied and not null-terminated.
+ */
+struct StringRef {
+    const char* begin;      /*!< The first character */
+    const char* end;        /*!< After the last character */
+
+    /*!
+     * \brief Construct an empty reference.
+     */
+    StringRef() : begin(NULL), end(NULL) {}
+
+    /*!
+     * \brief Construct a reference to the given characters.
+     * \param b The first character
+     * \param e After the last character
+     */
+    StringRef(const char* b, const char* e) : begin(b), end(e) {}
+
+    /*!
+     * \brief Construct a reference to the characters of a string. The string must outlive the reference.
+     * \param value The string to reference
+     */
+    explicit StringRef(const std::string& value) : begin(value.data()), end(value.data() + value.size()) {}
+
+    /*!
+     * \brief Return the number of referenced characters.
+     * \return The size of the reference
+     */
+    size_t size() const {
+        return end - begin;
+    }
+
+    /*!
+     * \brief Indicate if the reference is empty.
+     * \return true if no characters are referenced, otherwise false
+     */
+    bool empty() const {
+        return begin == end;
+    }
+
+    /*!
+     * \brief Copy the referenced characters into a string.
+     * \return A string containing the referenced characters
+     */
+    std::string str() const {
+        return std::string(begin, end);
+    }
+
+    /*!
+     * \brief Compare the referenced characters of two references.
+     * \param rhs The other reference
+     * \return true if both references contain the same characters
+     */
+    bool operator==(const StringRef& rhs) const {
+        return size() == rhs.size() && memcmp(begin, rhs.begin, size()) == 0;
+    }
+
+    /*!
+     * \brief Compare the referenced characters of two references.
+     * \param rhs The other reference
+     * \return true if the references contain different characters
+     */
+    bool operator!=(const StringRef& rhs) const {
+        return !(*this == rhs);
+    }
+
+    /*!
+     * \brief Order the references like std::string does.
+     * \param rhs The other reference
+     * \return true if this reference is lexicographically lower than the other one
+     */
+    bool operator<(const StringRef& rhs) const {
+        size_t length = size() < rhs.size() ? size() : rhs.size();
+        int result = memcmp(begin, rhs.begin, length);
+        return result < 0 || (result == 0 && size() < rhs.size());
+    }
+};
+
+/*!
+ * \brief Write the referenced characters to a stream.
+ * \param stream The stream to write to
+ * \param ref The reference to write
+ * \return The stream
+ */
+inline std::ostream& operator<<(std::ostream& stream, const StringRef& ref) {
+    return stream.write(ref.begin, ref.size());
+}
+
+/*!
+ * \struct StringRefHash
+ * \brief FNV-1a hash of the referenced characters, to use StringRef as a key of the unordered containers.
+ */
+struct StringRefHash {
+    /*!
+     * \brief Hash the given reference.
+     * \param ref The reference to hash
+     * \return The hash of the characters
+     */
+    size_t operator()(const StringRef& ref) const {
+        size_t hash = 14695981039346656037ULL;
+
+        for (const char* it = ref.begin; it != ref.end; ++it) {
+            hash = (hash ^ static_cast<unsigned char>(*it)) * 1099511628211ULL;
+        }
+
+        return hash;
+    }
+};
+
+} //end of inlining
+
+#endif
@@ -0,0 +1,260 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+/*! \file */
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "StringRef.hpp"
+
+namespace inlining {
+
+/*!
+ * \brief Indicate if the given character is a blank (space, tabulation or end of line).
+ * \param c The character to test
+ * \return true if the character is a blank
+ */
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/*!
+ * \brief Remove the blanks at the beginning and at the end of the given value.
+ * \param value The value to trim
+ * \return The value without its leading and trailing blanks
+ */
+inline StringRef trimRef(const StringRef& value) {
+    const char* begin = value.begin;
+    const char* end = value.end;
+
+    while (begin < end && isBlank(*begin)) {
+        ++begin;
+    }
+
+    while (end > begin && isBlank(end[-1])) {
+        --end;
+    }
+
+    return StringRef(begin, end);
+}
+
+/*!
+ * \brief Return the first word of the given value, like the extraction of a string from a stream.
+ * \param value The value
+ * \return The first sequence of characters without blanks, empty if there are none
+ */
+inline StringRef firstWord(const StringRef& value) {
+    const char* begin = value.begin;
+
+    while (begin < value.end && isBlank(*begin)) {
+        ++begin;
+    }
+
+    const char* end = begin;
+
+    while (end < value.end && !isBlank(*end)) {
+        ++end;
+    }
+
+    return StringRef(begin, end);
+}
+
+/*!
+ * \brief Split the given value at the first occurrence of the separator.
+ * \param value The value to split
+ * \param separator The separator
+ * \param first The part before the separator
+ * \param second The part after the separator
+ * \return false if the separator does not appear in the value
+ */
+inline bool splitRef(const StringRef& value, const char* separator, StringRef& first, StringRef& second) {
+    size_t length = strlen(separator);
+
+    for (const char* it = value.begin; it + length <= value.end; ++it) {
+        if (memcmp(it, separator, length) == 0) {
+            first = StringRef(value.begin, it);
+            second = StringRef(it + length, value.end);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Parse the unsigned decimal number at the beginning of the given text, after its blanks. The parsing stops at
+ * the first character that is not a digit. A number that does not fit in an unsigned int is clamped to its maximum,
+ * like the calls computed by toCalls().
+ * \param text The text to parse
+ * \return The number, 0 if the text does not start with a digit
+ */
+inline unsigned int parseUnsigned(const StringRef& text) {
+    static const unsigned int max = std::numeric_limits<unsigned int>::max();
+
+    const char* it = text.begin;
+
+    while (it < text.end && isBlank(*it)) {
+        ++it;
+    }
+
+    unsigned int value = 0;
+
+    for (; it < text.end && *it >= '0' && *it <= '9'; ++it) {
+        unsigned int digit = *it - '0';
+
+        if (value > (max - digit) / 10) {
+            return max;
+        }
+
+        value = value * 10 + digit;
+    }
+
+    return value;
+}
+
+/*!
+ * \brief Parse the decimal floating point number at the beginning of the given text, after its blanks.
+ *
+ * The numbers with at most 15 significant digits and no exponent, the numbers of the profiles, are computed with a
+ * single exact multiplication or division, which gives the same result as strtod. The others are given to strtod.
+ * \param text The text to parse
+ * \return The number, 0 if the text does not start with a number
+ */
+inline double parseDouble(const StringRef& text) {
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char* it = text.begin;
+
+    while (it < text.end && isBlank(*it)) {
+        ++it;
+    }
+
+    const char* start = it;
+
+    bool negative = it < text.end && *it == '-';
+    if (it < text.end && (*it == '-' || *it == '+')) {
+        ++it;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool valid = false;
+
+    for (; it < text.end && *it >= '0' && *it <= '9'; ++it) {
+        mantissa = mantissa * 10 + (*it - '0');
+        digits += mantissa != 0;
+        valid = true;
+    }
+
+    if (it < text.end && *it == '.') {
+        for (++it; it < text.end && *it >= '0' && *it <= '9'; ++it) {
+            mantissa = mantissa * 10 + (*it - '0');
+            digits += mantissa != 0;
+            --exponent;
+            valid = true;
+        }
+    }
+
+    bool exact = valid && digits <= 15 && exponent >= -22 && !(it < text.end && (*it == 'e' || *it == 'E'));
+
+    if (!exact) {
+        //The buffer is not null-terminated, the number is copied to the stack before the conversion
+        char buffer[64];
+        size_t length = std::min<size_t>(text.end - start, sizeof(buffer) - 1);
+        memcpy(buffer, start, length);
+        buffer[length] = '\0';
+
+        return strtod(buffer, NULL);
+    }
+
+    double value = static_cast<double>(mantissa) / powers[-exponent];
+
+    return negative ? -value : value;
+}
+
+/*!
+ * \brief Split a label produced by converter.py at its "\\n" sequences in a single pass. The backslashes are searched
+ * with memchr, which compares a whole word of characters at a time.
+ * \param label The label to split
+ * \param parts The parts to fill
+ * \param max The maximum number of parts, the last part contains the rest of the label
+ * \return The number of parts that have been filled
+ */
+inline unsigned int splitLabel(const StringRef& label, StringRef* parts, unsigned int max) {
+    unsigned int count = 0;
+    const char* begin = label.begin;
+    const char* it = label.begin;
+
+    while (count + 1 < max) {
+        const char* backslash = static_cast<const char*>(memchr(it, '\\', label.end - it));
+
+        if (!backslash || backslash + 1 >= label.end) {
+            break;
+        }
+
+        if (backslash[1] == 'n') {
+            parts[count++] = StringRef(begin, backslash);
+            begin = it = backslash + 2;
+        } else {
+            it = backslash + 1;
+        }
+    }
+
+    parts[count++] = StringRef(begin, label.end);
+
+    return count;
+}
+
+/*!
+ * \brief Return the number of a part of a label, without its parentheses and its % or × suffix.
+ * \param part A part of a label, (12.5%), 12.5% or 1200× for instance
+ * \return The number without its decorations
+ */
+inline StringRef labelNumber(const StringRef& part) {
+    const char* begin = part.begin;
+    const char* end = part.end;
+
+    if (begin < end && *begin == '(') {
+        ++begin;
+    }
+
+    if (end > begin && end[-1] == ')') {
+        --end;
+    }
+
+    if (end > begin && end[-1] == '%') {
+        --end;
+    } else if (end - begin >= 2 && end[-2] == '\xC3' && end[-1] == '\x97') {
+        end -= 2;
+    }
+
+    return StringRef(begin, end);
+}
+
+} //end of inlining
+
+#endif
@@ -126,7 +126,7 @@ static inline std::string trim(const std::string& value) {
 */
 static inline bool fexists(const std::string& filename) {
     std::ifstream ifile(filename.c_str());
-    return ifile;
+    return ifile.good();
 }
 
 } //end of inlining
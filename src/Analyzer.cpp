@@ -25,15 +25,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <algorithm>
 #include <functional>
 
-#include <boost/graph/copy.hpp>
 #include <boost/graph/strong_components.hpp>
 
 #include "Timer.hpp"
 #include "CallGraph.hpp"
+#include "FrozenGraph.hpp"
 #include "Analyzer.hpp"
 #include "Logging.hpp"
 #include "Sorters.hpp"
 #include "Utils.hpp"
+#include "Tokenizer.hpp"
 #include "Infos.hpp"
 #include "Parameters.hpp"
 
@@ -46,13 +47,12 @@ using std::cout;
 using std::endl;
 using std::unordered_map;
 using std::map;
-using std::for_each;
-using std::bind1st;
-using std::mem_fun;
 
 using boost::vertex_index;
 using boost::vertex_index_map;
 
+Analyzer::Analyzer(CallGraph& g, Infos& i) : graph(g), frozen(g.freeze()), infos(i), filterDuplicates(false) {}
+
 void Analyzer::setFilterDuplicates(bool filter) {
     filterDuplicates = filter;
 }
@@ -61,94 +61,89 @@ void Analyzer::addProtectedLibrary(const std::string& library) {
     protectedLibraries.insert(library);
 }
 
-void Analyzer::computeFunctionTemperature(Function function) {
+static double functionTemperature(unsigned int parameters, bool virtuality, unsigned int size, size_t callers, unsigned int applicationSize, double frequency) {
     //Not enough information
-    if (graph[function].size == 0) {
-        graph[function].temperature = 0.0;
-    } else {
-        unsigned int parameters = graph[function].parameters;
-        bool virtuality = graph[function].virtuality;
-        unsigned int size = graph[function].size;
+    if (size == 0) {
+        return 0.0;
+    }
 
-        double cost = 1.0 + (parameters * Parameters::get(HEURISTIC_FUNCTION_PARAMETER_COST)) + (virtuality ? Parameters::get(HEURISTIC_FUNCTION_VIRTUALITY_COST) : 0.0);
-        double size_overhead = 1.0 + (size * (in_degree(function, *graph.getGraph()) - 1)) / graph.getApplicationSize();
+    double cost = 1.0 + (parameters * Parameters::get(HEURISTIC_FUNCTION_PARAMETER_COST)) + (virtuality ? Parameters::get(HEURISTIC_FUNCTION_VIRTUALITY_COST) : 0.0);
+    double size_overhead = 1.0 + (size * (callers - 1)) / applicationSize;
 
-        graph[function].temperature = (cost / size_overhead) * graph[function].frequency;
-    }
+    return (cost / size_overhead) * frequency;
 }
 
-void Analyzer::computeCallSiteTemperature(CallSite site) {
-    Function caller = source(site, *graph.getGraph());
-
+static double callSiteTemperature(unsigned int callerCalls, unsigned int parameters, bool virtuality, bool library, unsigned int size, size_t callers, unsigned int applicationSize, double frequency) {
     //No way to inline it
-    if (graph[caller].calls == 0) {
-        graph[site].temperature= 0.0;
-    } else {
-        Function callee = target(site, *graph.getGraph());
+    if (callerCalls == 0) {
+        return 0.0;
+    }
 
-        //Not enough information about the callee
-        if (graph[callee].size == 0) {
-            graph[site].temperature= 0.0;
-        } else {
-            bool virtuality = graph[callee].virtuality;
-            bool library = graph[callee].module != graph[caller].module;
-            unsigned int parameters = graph[callee].parameters;
+    //Not enough information about the callee
+    if (size == 0) {
+        return 0.0;
+    }
 
-            double cost = 1.0 + (parameters * Parameters::get(HEURISTIC_CALL_SITE_PARAMETER_COST)) + (virtuality ? Parameters::get(HEURISTIC_CALL_SITE_VIRTUALITY_COST) : 0.0) + (library ? Parameters::get(HEURISTIC_LIBRARY_COST) : 0.0);
+    double cost = 1.0 + (parameters * Parameters::get(HEURISTIC_CALL_SITE_PARAMETER_COST)) + (virtuality ? Parameters::get(HEURISTIC_CALL_SITE_VIRTUALITY_COST) : 0.0) + (library ? Parameters::get(HEURISTIC_LIBRARY_COST) : 0.0);
 
-            double size_overhead = 1.0;
+    double size_overhead = 1.0;
 
-            //Size overhead only if there is more than one calls to this functions
-            if (in_degree(callee, *graph.getGraph()) > 1) {
-                size_overhead += static_cast<double>(graph[callee].size) / static_cast<double>(graph.getApplicationSize());
-            }
-
-            graph[site].temperature= (cost / size_overhead) * graph[site].frequency;
-        }
+    //Size overhead only if there is more than one calls to this functions
+    if (callers > 1) {
+        size_overhead += static_cast<double>(size) / static_cast<double>(applicationSize);
     }
+
+    return (cost / size_overhead) * frequency;
+}
+
+void Analyzer::computeFunctionTemperature(Function function) {
+    frozen.setTemperature(function, functionTemperature(frozen.parameters(function), frozen.isVirtual(function), frozen.size(function),
+            frozen.inDegree(function), graph.getApplicationSize(), frozen.frequency(function)));
+}
+
+void Analyzer::computeCallSiteTemperature(FrozenCallSite site) {
+    Function caller = frozen.source(site);
+    Function callee = frozen.target(site);
+
+    frozen.setCallSiteTemperature(site, callSiteTemperature(frozen.calls(caller), frozen.parameters(callee), frozen.isVirtual(callee), frozen.module(callee) != frozen.module(caller),
+            frozen.size(callee), frozen.inDegree(callee), graph.getApplicationSize(), frozen.callSiteFrequency(site)));
 }
 
 void Analyzer::analyze() {
     Timer timer;
 
-    FunctionIterator fit, fend;
-    boost::tie(fit, fend) = graph.functions();
-    for_each(fit, fend, bind1st(mem_fun(&Analyzer::computeFunctionTemperature), this));
+    for (Function function = 0; function < frozen.numberOfFunctions(); ++function) {
+        computeFunctionTemperature(function);
+    }
 
     cout << "First " << endl;
 
-    CallSiteIterator cit, cend;
-    boost::tie(cit, cend) = graph.callSites();
-    for_each(cit, cend, bind1st(mem_fun(&Analyzer::computeCallSiteTemperature), this));
+    //The temperatures are written in the columns of the frozen graph, the call graph is not touched
+    for (FrozenCallSite site = 0; site < frozen.numberOfCallSites(); ++site) {
+        computeCallSiteTemperature(site);
+    }
 
     PERF cout << "PERF : Graph analyzed in " << timer.elapsed() << "ms" << endl;
 }
 
-vector<CallSite> Analyzer::findInterLibraryCalls() const {
-    vector<CallSite> callSites;
-
-    CallSiteIterator cit, cend;
-    for (boost::tie(cit, cend) = graph.callSites(); cit != cend; ++cit) {
-        Function caller = source(*cit, *graph.getGraph());
-        Function callee = target(*cit, *graph.getGraph());
+vector<FrozenCallSite> Analyzer::findInterLibraryCalls() const {
+    vector<FrozenCallSite> callSites;
 
-        if (graph[caller].module != graph[callee].module) {
-            callSites.push_back(*cit);
+    for (FrozenCallSite site = 0; site < frozen.numberOfCallSites(); ++site) {
+        if (frozen.module(frozen.source(site)) != frozen.module(frozen.target(site))) {
+            callSites.push_back(site);
         }
     }
 
     return callSites;
 }
 
-vector<CallSite> Analyzer::findVirtualCalls() const {
-    vector<CallSite> callSites;
-
-    CallSiteIterator cit, cend;
-    for (boost::tie(cit, cend) = graph.callSites(); cit != cend; ++cit) {
-        Function callee = target(*cit, *graph.getGraph());
+vector<FrozenCallSite> Analyzer::findVirtualCalls() const {
+    vector<FrozenCallSite> callSites;
 
-        if (graph[callee].virtuality) {
-            callSites.push_back(*cit);
+    for (FrozenCallSite site = 0; site < frozen.numberOfCallSites(); ++site) {
+        if (frozen.isVirtual(frozen.target(site))) {
+            callSites.push_back(site);
         }
     }
 
@@ -158,10 +153,9 @@ vector<CallSite> Analyzer::findVirtualCalls() const {
 vector<Function> Analyzer::findFunctionsCalledOnce() const {
     vector<Function> functions;
 
-    FunctionIterator first, last;
-    for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
-        if (graph[*first].calls == 1) {
-            functions.push_back(*first);
+    for (Function function = 0; function < frozen.numberOfFunctions(); ++function) {
+        if (frozen.calls(function) == 1) {
+            functions.push_back(function);
         }
     }
 
@@ -171,57 +165,55 @@ vector<Function> Analyzer::findFunctionsCalledOnce() const {
 vector<Function> Analyzer::findLeafFunctions() const {
     vector<Function> functions;
 
-    FunctionIterator first, last;
-    for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
-        if (out_degree(*first, *graph.getGraph()) == 0) {
-            functions.push_back(*first);
+    for (Function function = 0; function < frozen.numberOfFunctions(); ++function) {
+        if (frozen.outDegree(function) == 0) {
+            functions.push_back(function);
         }
     }
 
     return functions;
 }
 
-void findCluster(Function src, vector<CallSite>& cluster, set<Function>& visited, const Graph& graph) {
+//Only the hot call sites are followed
+static void findCluster(Function src, vector<FrozenCallSite>& cluster, set<Function>& visited, const FrozenGraph& frozen, const vector<char>& hot) {
     if (visited.find(src) != visited.end()) {
         return;
     }
 
     //Search in all the out directions
-    OutCallSiteIterator it, end;
-    for (boost::tie(it, end) = out_edges(src, graph); it != end; ++it) {
-        CallSite c = *it;
-        Function f = target(c, graph);
+    const FrozenCallSite* it;
+    const FrozenCallSite* end;
+    for (boost::tie(it, end) = frozen.outCallSites(src); it != end; ++it) {
+        FrozenCallSite c = *it;
 
         //Avoid searching again for the same call site
-        if (find(cluster.begin(), cluster.end(), c) == cluster.end()) {
+        if (hot[c] && find(cluster.begin(), cluster.end(), c) == cluster.end()) {
             cluster.push_back(c);
 
-            findCluster(f, cluster, visited, graph);
+            findCluster(frozen.target(c), cluster, visited, frozen, hot);
         }
     }
 
     //Search in all the in directions
-    InCallSiteIterator it2, end2;
-    for (boost::tie(it2, end2) = in_edges(src, graph); it2 != end2; ++it2) {
-        CallSite c = *it2;
-        Function f = source(c, graph);
+    for (boost::tie(it, end) = frozen.inCallSites(src); it != end; ++it) {
+        FrozenCallSite c = *it;
 
         //Avoid searching again for the same call site
-        if (find(cluster.begin(), cluster.end(), c) == cluster.end()) {
+        if (hot[c] && find(cluster.begin(), cluster.end(), c) == cluster.end()) {
             cluster.push_back(c);
 
-            findCluster(f, cluster, visited, graph);
+            findCluster(frozen.source(c), cluster, visited, frozen, hot);
         }
     }
 
     visited.insert(src);
 }
 
-static double temperature(const std::vector<CallSite>& v, const CallGraph& graph) {
+static double temperature(const std::vector<FrozenCallSite>& v, const FrozenGraph& frozen) {
     double temperature = 0;
 
-    for (std::vector<CallSite>::const_iterator it = v.begin(); it != v.end(); ++it) {
-        temperature += graph[*it].temperature;
+    for (std::vector<FrozenCallSite>::const_iterator it = v.begin(); it != v.end(); ++it) {
+        temperature += frozen.callSiteTemperature(*it);
     }
 
     return temperature;
@@ -230,34 +222,34 @@ static double temperature(const std::vector<CallSite>& v, const CallGraph& graph
 vector<Cluster> Analyzer::findClusters() const {
     Timer timer;
 
-    Graph copy;
-    copy_graph(*graph.getGraph(), copy);
-
     //Keep only the most interesting call sites
-    FilterByTemperature filter(copy, Parameters::get(HOT_CALL_SITE));
-    remove_edge_if(filter, copy);
+    FilterByTemperature filter(frozen, Parameters::get(HOT_CALL_SITE));
+
+    vector<char> hot(frozen.numberOfCallSites());
+    for (FrozenCallSite site = 0; site < frozen.numberOfCallSites(); ++site) {
+        hot[site] = !filter(site);
+    }
 
     vector<Cluster> clusters;
     set<Function> visited;
 
     //We get the clusters of the graph
-    FunctionIterator first, last;
-    for (boost::tie(first, last) = vertices(copy); first != last; ++first) {
-        if (visited.find(*first) == visited.end()) {
+    for (Function function = 0; function < frozen.numberOfFunctions(); ++function) {
+        if (visited.find(function) == visited.end()) {
             //Search a cluster
-            vector<CallSite> cluster;
-            findCluster(*first, cluster, visited, copy);
+            vector<FrozenCallSite> cluster;
+            findCluster(function, cluster, visited, frozen, hot);
 
             //We do not consider a single call site as a real cluster
             if (cluster.size() > 1) {
                 //If the cluster is too big, we reduce it to the max size
                 if (cluster.size() > Parameters::get(CLUSTER_MAX_SIZE)) {
-                    sort(cluster.begin(), cluster.end(), SortByTemperature(graph));
+                    sort(cluster.begin(), cluster.end(), SortCallSitesByTemperature(frozen));
 
                     cluster.erase(cluster.begin(), cluster.end() - Parameters::get(CLUSTER_MAX_SIZE));
                 }
 
-                clusters.push_back(Cluster(cluster, temperature(cluster, graph)));
+                clusters.push_back(Cluster(cluster, temperature(cluster, frozen)));
             }
         }
     }
@@ -265,7 +257,7 @@ vector<Cluster> Analyzer::findClusters() const {
     return clusters;
 }
 
-void findPath(CallSite src, Function dest, vector<vector<CallSite>>& paths, vector<CallSite>& path, int limit, const CallGraph& graph) {
+void findPath(FrozenCallSite src, Function dest, vector<vector<FrozenCallSite>>& paths, vector<FrozenCallSite>& path, int limit, const FrozenGraph& graph) {
     //The path is too long
     if (limit == 0) {
         return;
@@ -273,18 +265,18 @@ void findPath(CallSite src, Function dest, vector<vector<CallSite>>& paths, vect
 
     path.push_back(src);
 
-    string library = graph[target(src, *graph.getGraph())].module;
+    StringId library = graph.module(graph.target(src));
 
     //We are back in the dest library
-    if (graph[dest].module == library) {
+    if (graph.module(dest) == library) {
         paths.push_back(path); //Do a copy ? Add f to the path or implicitely ?
     } else {
-        OutCallSiteIterator it, end;
-        for (boost::tie(it, end) = out_edges(target(src, *graph.getGraph()), *graph.getGraph()); it != end; ++it) {
-            CallSite c = *it;
-            Function f = target(c, *graph.getGraph());
+        FrozenAdjacentIterator it, end;
+        for (boost::tie(it, end) = graph.outCallSites(graph.target(src)); it != end; ++it) {
+            FrozenCallSite c = *it;
+            Function f = graph.target(c);
 
-            if (graph[f].module == library || graph[f].module == graph[dest].module) {
+            if (graph.module(f) == library || graph.module(f) == graph.module(dest)) {
                 //Is this condition useful ?
                 if (find(path.begin(), path.end(), c) == path.end()) {
                     findPath(c, dest, paths, path, limit - 1, graph);
@@ -296,63 +288,62 @@ void findPath(CallSite src, Function dest, vector<vector<CallSite>>& paths, vect
     path.erase(path.end() - 1);
 }
 
-vector<vector<CallSite>> findPaths(CallSite src, Function dest, const CallGraph& graph, int L) {
-    vector<vector<CallSite>> paths;
-    vector<CallSite> path;
+vector<vector<FrozenCallSite>> findPaths(FrozenCallSite src, Function dest, const FrozenGraph& graph, int L) {
+    vector<vector<FrozenCallSite>> paths;
+    vector<FrozenCallSite> path;
 
     findPath(src, dest, paths, path, L, graph);
 
     return paths;
 }
 
-int computeMinCalls(const vector<CallSite>& path, const CallGraph& graph) {
-    unsigned int min = graph[path[0]].calls;
+int computeMinCalls(const vector<FrozenCallSite>& path, const FrozenGraph& graph) {
+    unsigned int min = graph.callSiteCalls(path[0]);
 
-    for (std::vector<CallSite>::const_iterator it = path.begin(); it != path.end(); ++it) {
-        min = std::min(min, graph[*it].calls);
+    for (std::vector<FrozenCallSite>::const_iterator it = path.begin(); it != path.end(); ++it) {
+        min = std::min(min, graph.callSiteCalls(*it));
     }
 
     return min;
 }
 
-unsigned long interestOfMoving(Function src, Function dest, const CallGraph& graph) {
-    if (graph[src].module == graph[dest].module) {
+unsigned long interestOfMoving(Function src, Function dest, const FrozenGraph& graph) {
+    if (graph.module(src) == graph.module(dest)) {
         return 0;
     }
 
     unsigned long benefit = 0;
 
     //Search the calls from src function
-    OutCallSiteIterator it, end;
-    for (boost::tie(it, end) = out_edges(src, *graph.getGraph()); it != end; ++it) {
-        CallSite c = *it;
+    FrozenAdjacentIterator it, end;
+    for (boost::tie(it, end) = graph.outCallSites(src); it != end; ++it) {
+        FrozenCallSite c = *it;
         Function f = graph.target(c);
 
         //If moved to the library of the callee, we avoid library calls
-        if (graph[f].module == graph[dest].module) {
-            benefit += graph[c].calls;
+        if (graph.module(f) == graph.module(dest)) {
+            benefit += graph.callSiteCalls(c);
         }
 
         //If both were in the same library, we adds more library calls
-        if (graph[f].module == graph[src].module) {
-            benefit -= graph[c].calls;
+        if (graph.module(f) == graph.module(src)) {
+            benefit -= graph.callSiteCalls(c);
         }
     }
 
     //Search the calls to src function
-    InCallSiteIterator it2, end2;
-    for (boost::tie(it2, end2) = in_edges(src, *graph.getGraph()); it2 != end2; ++it2) {
-        CallSite c = *it2;
+    for (boost::tie(it, end) = graph.inCallSites(src); it != end; ++it) {
+        FrozenCallSite c = *it;
         Function f = graph.source(c);
 
         //If the caller is in the dest library, we avoid library calls
-        if (graph[f].module == graph[dest].module) {
-            benefit += graph[c].calls;
+        if (graph.module(f) == graph.module(dest)) {
+            benefit += graph.callSiteCalls(c);
         }
 
         //If both were in the same library, we adds more library calls
-        if (graph[f].module == graph[src].module) {
-            benefit -= graph[c].calls;
+        if (graph.module(f) == graph.module(src)) {
+            benefit -= graph.callSiteCalls(c);
         }
     }
 
@@ -384,49 +375,49 @@ void Analyzer::computeSolution(vector<string>& solutions, set<string>& libraryFi
     total += benefit;
 }
 
-unsigned long Analyzer::computeSolutions(Function src, Function dest, const vector<vector<CallSite>>& paths, vector<string>& solutions) const {
+unsigned long Analyzer::computeSolutions(Function src, Function dest, const vector<vector<FrozenCallSite>>& paths, vector<string>& solutions) const {
     set<string> libraryFilters;
     unsigned long benefit;
 
-    unsigned long benefitSrcToDest = interestOfMoving(src, dest, graph);
-    unsigned long benefitDestToSrc = interestOfMoving(dest, src, graph);
+    unsigned long benefitSrcToDest = interestOfMoving(src, dest, frozen);
+    unsigned long benefitDestToSrc = interestOfMoving(dest, src, frozen);
 
     //No benefit
     if (benefitSrcToDest <= 0 && benefitDestToSrc <= 0) {
         solutions.push_back("Benefit is not enough, neither of them should be moved");
     } else if (benefitSrcToDest > benefitDestToSrc) {
-        computeSolution(solutions, libraryFilters, graph[src].name, graph[dest].module, benefitSrcToDest, benefit);
+        computeSolution(solutions, libraryFilters, graph.nameOf(src), graph.moduleOf(dest), benefitSrcToDest, benefit);
 
         //Consider moving the end of the paths too
-        for (vector<vector<CallSite>>::const_iterator pit = paths.begin(); pit != paths.end(); ++pit) {
-            Function function = graph.target((*pit)[pit->size() - 1]);
+        for (vector<vector<FrozenCallSite>>::const_iterator pit = paths.begin(); pit != paths.end(); ++pit) {
+            Function function = frozen.target((*pit)[pit->size() - 1]);
 
             //Don't test twice the same function in the case of a direct cycle between two functions
-            if (graph[function].name != graph[src].name) {
-                unsigned long b = interestOfMoving(function, dest, graph);
+            if (graph.nameOf(function) != graph.nameOf(src)) {
+                unsigned long b = interestOfMoving(function, dest, frozen);
 
-                computeSolution(solutions, libraryFilters, graph[function].name, graph[dest].module, b, benefit);
+                computeSolution(solutions, libraryFilters, graph.nameOf(function), graph.moduleOf(dest), b, benefit);
             }
         }
     } else {
-        computeSolution(solutions, libraryFilters, graph[dest].name, graph[src].module, benefitDestToSrc, benefit);
+        computeSolution(solutions, libraryFilters, graph.nameOf(dest), graph.moduleOf(src), benefitDestToSrc, benefit);
 
         //Consider moving the middle of the path too
-        for (vector<vector<CallSite>>::const_iterator pit = paths.begin(); pit != paths.end(); ++pit) {
-            vector<CallSite> path = *pit;
+        for (vector<vector<FrozenCallSite>>::const_iterator pit = paths.begin(); pit != paths.end(); ++pit) {
+            vector<FrozenCallSite> path = *pit;
 
             //Contains only src, dest and the last function in library(src)
             if (path.size() <= 3) {
                 continue;
             }
 
-            for (vector<CallSite>::size_type i = 1; i < path.size() - 1; ++i) {
-                Function f = graph.target(path[i]);
+            for (vector<FrozenCallSite>::size_type i = 1; i < path.size() - 1; ++i) {
+                Function f = frozen.target(path[i]);
 
-                unsigned long b = interestOfMoving(f, src, graph);
+                unsigned long b = interestOfMoving(f, src, frozen);
 
                 if (benefit >= Parameters::get(MOVE_BENEFIT_THRESHOLD)) {
-                    computeSolution(solutions, libraryFilters, graph[f].name, graph[src].module, b, benefit);
+                    computeSolution(solutions, libraryFilters, graph.nameOf(f), graph.moduleOf(src), b, benefit);
                 } else {
                     break; //To avoid breaking the path in too many library
                 }
@@ -440,30 +431,30 @@ unsigned long Analyzer::computeSolutions(Function src, Function dest, const vect
 vector<LibraryIssue> Analyzer::findLibraryIssues() const {
     vector<LibraryIssue> issues;
 
-    vector<CallSite> callSites = findInterLibraryCalls();
+    vector<FrozenCallSite> callSites = findInterLibraryCalls();
 
-    for (std::vector<CallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
+    for (std::vector<FrozenCallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
         //Consider only heavy paths
-        if (graph[*iterator].calls >= Parameters::get(HEAVY_CALL_SITE)) {
-            Function src = source(*iterator, *graph.getGraph());
-            Function dest = target(*iterator, *graph.getGraph());
-            vector<vector<CallSite>> paths;
+        if (frozen.callSiteCalls(*iterator) >= Parameters::get(HEAVY_CALL_SITE)) {
+            Function src = frozen.source(*iterator);
+            Function dest = frozen.target(*iterator);
+            vector<vector<FrozenCallSite>> paths;
 
             vector<string> solutions;
             unsigned long benefit = computeSolutions(src, dest, paths, solutions);
 
             issues.push_back(LibraryIssue(src, dest, paths, solutions, benefit));
-        } else if (graph[*iterator].calls >= Parameters::get(LIBRARY_PATH_THRESHOLD)) {
-            Function src = source(*iterator, *graph.getGraph());
+        } else if (frozen.callSiteCalls(*iterator) >= Parameters::get(LIBRARY_PATH_THRESHOLD)) {
+            Function src = frozen.source(*iterator);
 
-            vector<vector<CallSite>> paths = findPaths(*iterator, src, graph, Parameters::get(LIBRARY_PATH_MAX_LENGTH));
+            vector<vector<FrozenCallSite>> paths = findPaths(*iterator, src, frozen, Parameters::get(LIBRARY_PATH_MAX_LENGTH));
 
             if (!paths.empty()) {
-                vector<vector<CallSite>> result;
+                vector<vector<FrozenCallSite>> result;
 
                 //Filter the paths with not enough calls
-                for (vector<vector<CallSite>>::const_iterator it = paths.begin(); it != paths.end(); ++it) {
-                    int min = computeMinCalls(*it, graph);
+                for (vector<vector<FrozenCallSite>>::const_iterator it = paths.begin(); it != paths.end(); ++it) {
+                    int min = computeMinCalls(*it, frozen);
 
                     if (min >= Parameters::get(LIBRARY_MIN_PATH_CALLS)) {
                         result.push_back(*it);
@@ -471,7 +462,7 @@ vector<LibraryIssue> Analyzer::findLibraryIssues() const {
                 }
 
                 if (!result.empty()) {
-                    Function dest = target(*iterator, *graph.getGraph());
+                    Function dest = frozen.target(*iterator);
 
                     vector<string> solutions;
                     unsigned long benefit = computeSolutions(src, dest, result, solutions);
@@ -485,10 +476,11 @@ vector<LibraryIssue> Analyzer::findLibraryIssues() const {
     return issues;
 }
 
-static void inline addLibrary(DependencyGraph& dependencyGraph, map<std::string, Library>& libraries, const std::string& libraryName) {
-    if (libraryName.size() > 0 && libraries.find(libraryName) == libraries.end()) {
+//The names reference the modules of the call graph, they are only copied in the dependency graph
+static void inline addLibrary(DependencyGraph& dependencyGraph, map<StringRef, Library>& libraries, const StringRef& libraryName) {
+    if (!libraryName.empty() && libraries.find(libraryName) == libraries.end()) {
         Library library = add_vertex(dependencyGraph);
-        dependencyGraph[library].name = libraryName;
+        dependencyGraph[library].name = libraryName.str();
         libraries[libraryName] = library;
     }
 }
@@ -496,23 +488,38 @@ static void inline addLibrary(DependencyGraph& dependencyGraph, map<std::string,
 std::vector<std::vector<std::string>> Analyzer::findCircularDependencies() const {
     DependencyGraph dependencyGraph;
 
-    map<std::string, Library> libraries;
+    map<StringRef, Library> libraries;
 
-    //Fill the dependency graph with the libraries and the dependencies amon them
-    CallSiteIterator cit, cend;
-    for (boost::tie(cit, cend) = graph.callSites(); cit != cend; ++cit) {
-        CallSite callSite = *cit;
+    //The library of each module is searched only once, in the order the modules are met
+    const Library none = boost::graph_traits<DependencyGraph>::null_vertex();
+    vector<Library> moduleLibraries(frozen.numberOfStrings(), none);
+    vector<char> resolved(frozen.numberOfStrings(), false);
+
+    auto libraryOf = [&](StringId module) -> Library {
+        if (!resolved[module]) {
+            resolved[module] = true;
+
+            StringRef name = firstWord(StringRef(frozen.moduleName(module)));
+
+            //Add the library in the graph
+            addLibrary(dependencyGraph, libraries, name);
+
+            if (!name.empty()) {
+                moduleLibraries[module] = libraries[name];
+            }
+        }
 
-        std::string src = trim(graph[graph.source(callSite)].module);
-        std::string target = trim(graph[graph.target(callSite)].module);
+        return moduleLibraries[module];
+    };
 
-        //Add the library of the source and the target in the graph
-        addLibrary(dependencyGraph, libraries, src);
-        addLibrary(dependencyGraph, libraries, target);
+    //Fill the dependency graph with the libraries and the dependencies amon them
+    for (FrozenCallSite site = 0; site < frozen.numberOfCallSites(); ++site) {
+        Library src = libraryOf(frozen.module(frozen.source(site)));
+        Library target = libraryOf(frozen.module(frozen.target(site)));
 
         //Add the link between the two libraries if there is one
-        if (src.size() > 0 && target.size() > 0 && src != target) {
-            add_edge(libraries[src], libraries[target], dependencyGraph);
+        if (src != none && target != none && src != target) {
+            add_edge(src, target, dependencyGraph);
         }
     }
 
@@ -551,11 +558,14 @@ vector<HierarchyIssue> Analyzer::findVirtualHierarchyIssues() const {
     map<string, set<string>> hierarchies;
 
     for (VirtualFunctionSet::const_iterator it = virtualFunctions.begin(); it != virtualFunctions.end(); ++it) {
-        string hash = *it;
+        StringRef library;
+        StringRef name;
 
-        vector<string> parts = split(hash, "##");
+        if (!splitRef(StringRef(*it), "##", library, name)) {
+            continue;
+        }
 
-        string function = parts[1];
+        string function = name.str();
 
         //Empty function name
         if (function.size() <= 1) {
@@ -603,15 +613,13 @@ vector<HierarchyIssue> Analyzer::findVirtualHierarchyIssues() const {
                 ++pos;
             }
 
-            string length = "";
+            const char* length = function.data() + pos;
 
             while (isdigit(function[pos])) {
-                length += function[pos];
                 ++pos;
             }
 
-            int x = toNumber<int>(length);
-            pos += x;
+            pos += parseUnsigned(StringRef(length, function.data() + pos));
 
             string functionName = function.substr(pos);
 
@@ -623,7 +631,7 @@ vector<HierarchyIssue> Analyzer::findVirtualHierarchyIssues() const {
 
     FunctionIterator first, last;
     for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
-        calls[graph[*first].name] = graph[*first].calls;
+        calls[graph.nameOf(*first)] = graph[*first].calls;
     }
 
     for (map<string, set<string>>::const_iterator it = hierarchies.begin(); it != hierarchies.end(); ++it) {
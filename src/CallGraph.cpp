@@ -17,16 +17,79 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include <iostream>
+#include <algorithm>
 #include <cstdlib>
 #include <sys/time.h>
 
 #include "CallGraph.hpp"
+#include "DotParser.hpp"
+#include "FrozenGraph.hpp"
+#include "GraphBuilder.hpp"
 
 using namespace boost;
 using namespace std;
 using namespace inlining;
 
+CallGraph::CallGraph(Graph* g) : graph(g), decodedFields(ALL_FIELDS), memoryCap(0), frozen(NULL) {
+    size_t functions = num_vertices(*graph);
+
+    GraphBuilder builder(1);
+    builder.reserve(num_edges(*graph));
+
+    size_t characters = 0;
+
+    CallSiteIterator first, last;
+    for (boost::tie(first, last) = edges(*graph); first != last; ++first) {
+        const edge_info& callSite = (*graph)[*first];
+
+        builder.addCall(boost::source(*first, *graph), boost::target(*first, *graph), callSite.calls, callSite.cost);
+
+        characters += callSite.label.size();
+    }
+
+    builder.build(table, functions);
+
+    if (num_edges(*graph) == 0) {
+        return;
+    }
+
+    //The labels of the call sites are kept as raw labels, in the order of the call sites
+    if (characters > 0) {
+        labels.allocate(characters, false);
+        callSiteLabels.allocate(num_edges(*graph), false);
+    }
+
+    size_t offset = 0;
+    FrozenCallSite site = 0;
+    for (boost::tie(first, last) = edges(*graph); first != last; ++first, ++site) {
+        const edge_info& callSite = (*graph)[*first];
+
+        table.setFrequency(site, callSite.frequency);
+
+        if (characters > 0) {
+            callSiteLabels[site] = {offset, callSite.label.size()};
+            std::copy(callSite.label.begin, callSite.label.end, labels.data() + offset);
+            offset += callSite.label.size();
+        }
+    }
+
+    //The graph only keeps the functions, the strings are moved, the names and the labels keep pointing to the same characters
+    Graph* vertices = new Graph(functions);
+
+    get_property(*vertices, graph_name) = get_property(*graph, graph_name);
+    stringsOf(*vertices) = stringsOf(*graph);
+    arenaOf(*vertices).swap(arenaOf(*graph));
+
+    for (Function function = 0; function < functions; ++function) {
+        (*vertices)[function] = (*graph)[function];
+    }
+
+    delete graph;
+    graph = vertices;
+}
+
 CallGraph::~CallGraph() {
+    delete frozen;
     delete graph;
 }
 
@@ -40,18 +103,10 @@ pair<FunctionIterator, FunctionIterator> CallGraph::functions() const {
     return vertices(*graph);
 }
 
-pair<CallSiteIterator, CallSiteIterator> CallGraph::callSites() {
-    return edges(*graph);
-}
-
-pair<CallSiteIterator, CallSiteIterator> CallGraph::callSites() const {
-    return edges(*graph);
-}
-
 //Utilities
 
-string CallGraph::getDescription(CallSite callSite) const {
-    return (*this)[source(callSite)].name + " --> " + (*this)[target(callSite)].name;
+string CallGraph::getDescription(FrozenCallSite callSite) const {
+    return nameOf(source(callSite)) + " --> " + nameOf(target(callSite));
 }
 
 //General setters
@@ -77,5 +132,169 @@ unsigned int CallGraph::numberOfFunctions() const {
 }
 
 unsigned int CallGraph::numberOfCallSites() const {
-    return num_edges(*graph);
+    return table.numberOfCallSites();
+}
+
+//Labels
+
+void CallGraph::setRawLabels(Column<char>& buffer, Column<RawLabel>& functions, Column<RawLabel>& callSites) {
+    labels.swap(buffer);
+    functionLabels.swap(functions);
+    callSiteLabels.swap(callSites);
+}
+
+void CallGraph::decodeLabels(unsigned int fields) {
+    unsigned int missing = fields & ~decodedFields;
+
+    if (!missing) {
+        return;
+    }
+
+    //Without raw labels, the labels have been kept in the functions (boost reader)
+    bool raw = functionLabels.size() > 0;
+
+    if (missing & (FUNCTION_CALLS | FUNCTION_SELF_COST | FUNCTION_INCLUSIVE_COST)) {
+        FunctionIterator first, last;
+        for (boost::tie(first, last) = functions(); first != last; ++first) {
+            vertex_info& function = (*graph)[*first];
+
+            StringRef label = function.label;
+            if (raw) {
+                const RawLabel& position = functionLabels[*first];
+                label = StringRef(labels.data() + position.offset, labels.data() + position.offset + position.size);
+            }
+
+            if (!label.empty()) {
+                decodeFunctionLabel(label, function.inclusive_cost, function.self_cost, function.calls, missing);
+            }
+        }
+    }
+
+    //The labels of the call sites are always raw labels, indexed by call site
+    if (missing & (CALL_SITE_CALLS | CALL_SITE_COST)) {
+        for (FrozenCallSite callSite = 0; callSite < callSiteLabels.size(); ++callSite) {
+            const RawLabel& position = callSiteLabels[callSite];
+
+            if (position.size > 0) {
+                StringRef label(labels.data() + position.offset, labels.data() + position.offset + position.size);
+
+                double cost = table.cost(callSite);
+                unsigned int calls = table.calls(callSite);
+
+                decodeCallSiteLabel(label, cost, calls, missing);
+
+                table.setCost(callSite, cost);
+                table.setCalls(callSite, calls);
+            }
+        }
+    }
+
+    decodedFields |= missing;
+
+    if (decodedFields == ALL_FIELDS) {
+        labels.allocate(0, false);
+        functionLabels.allocate(0, false);
+        callSiteLabels.allocate(0, false);
+    }
+}
+
+void CallGraph::releaseLabels() {
+    decodeLabels(ALL_FIELDS);
+
+    FunctionIterator first, last;
+    for (boost::tie(first, last) = functions(); first != last; ++first) {
+        (*graph)[*first].label = StringRef();
+    }
+}
+
+void CallGraph::reorder(const vector<Function>& order) {
+    decodeLabels(ALL_FIELDS);
+
+    size_t functions = num_vertices(*graph);
+
+    vector<Function> positions(functions);
+    for (Function function = 0; function < functions; ++function) {
+        positions[order[function]] = function;
+    }
+
+    //The call sites of a caller are added together, in the order of their numbers
+    GraphBuilder builder(1, memoryCap);
+    builder.reserve(table.numberOfCallSites());
+
+    vector<double> frequencies;
+    frequencies.reserve(table.numberOfCallSites());
+
+    for (Function function = 0; function < functions; ++function) {
+        const FrozenCallSite* it;
+        const FrozenCallSite* end;
+        for (boost::tie(it, end) = table.outCallSites(order[function]); it != end; ++it) {
+            builder.addCall(function, positions[table.target(*it)], table.calls(*it), table.cost(*it));
+            frequencies.push_back(table.frequency(*it));
+        }
+    }
+
+    builder.build(table, functions);
+
+    for (FrozenCallSite callSite = 0; callSite < frequencies.size(); ++callSite) {
+        table.setFrequency(callSite, frequencies[callSite]);
+    }
+
+    //The names and the labels keep pointing to the same characters
+    vector<vertex_info> previousFunctions(functions);
+    for (Function function = 0; function < functions; ++function) {
+        previousFunctions[function] = (*graph)[order[function]];
+    }
+
+    for (Function function = 0; function < functions; ++function) {
+        (*graph)[function] = previousFunctions[function];
+    }
+
+    vector<Function> previous(functions);
+    for (Function function = 0; function < functions; ++function) {
+        previous[function] = originalFunction(order[function]);
+    }
+
+    originals.swap(previous);
+
+    delete frozen;
+    frozen = NULL;
+}
+
+void CallGraph::compressNames() {
+    releaseLabels();
+
+    vector<StringRef> functionNames;
+    functionNames.reserve(numberOfFunctions());
+
+    FunctionIterator first, last;
+    for (boost::tie(first, last) = functions(); first != last; ++first) {
+        functionNames.push_back((*graph)[*first].name);
+    }
+
+    CompressedNames table(functionNames);
+
+    for (boost::tie(first, last) = functions(); first != last; ++first) {
+        (*graph)[*first].name = StringRef();
+    }
+
+    //Nothing references the arena anymore
+    arenaOf(*graph).clear();
+
+    std::swap(names, table);
+}
+
+//Frozen graph
+
+bool CallGraph::canFreeze() const {
+    return !table.overflowed();
+}
+
+FrozenGraph& CallGraph::freeze() {
+    if (!frozen) {
+        bool mapped = memoryCap > 0 && FrozenGraph::footprint(num_vertices(*graph), table.numberOfCallSites()) > memoryCap;
+
+        frozen = new FrozenGraph(*this, mapped);
+    }
+
+    return *frozen;
 }
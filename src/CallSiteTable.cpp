@@ -0,0 +1,36 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <limits>
+
+#include "CallSiteTable.hpp"
+
+using namespace std;
+using namespace inlining;
+
+bool CallSiteTable::fits(size_t functions, size_t callSites) {
+    return functions <= numeric_limits<FrozenFunction>::max() && callSites <= numeric_limits<FrozenCallSite>::max();
+}
+
+size_t CallSiteTable::footprint(size_t functions, size_t callSites) {
+    size_t perFunction = 2 * sizeof(FrozenCallSite);
+    size_t perCallSite = 4 * sizeof(FrozenCallSite) + sizeof(unsigned int) + 2 * sizeof(double);
+
+    return functions * perFunction + callSites * perCallSite;
+}
@@ -0,0 +1,415 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+#include "CallgrindReader.hpp"
+#include "CallGraph.hpp"
+#include "Timer.hpp"
+#include "Logging.hpp"
+#include "Infos.hpp"
+#include "GraphBuilder.hpp"
+#include "MappedFile.hpp"
+
+using namespace std;
+using namespace inlining;
+
+static const Function NO_FUNCTION = static_cast<Function>(-1);
+
+/*!
+ * \struct CallgrindCall
+ * \brief The accumulated information of all the calls from a caller to a callee.
+ */
+struct CallgrindCall {
+    Function caller;
+    Function callee;
+    unsigned int calls;
+    double cost;
+
+    CallgrindCall(Function a, Function b) : caller(a), callee(b), calls(0), cost(0.0) {}
+};
+
+/*!
+ * \struct CallgrindState
+ * \brief The state of the parser while reading a callgrind.out file.
+ */
+struct CallgrindState {
+    Graph& graph;
+
+    //The format of the cost lines
+    unsigned int positions;
+    unsigned int eventIndex;
+
+    //The name compression tables
+    vector<string> objects;
+    vector<string> files;
+    vector<Function> functions;
+
+    //The functions by name, the names are stored in the arena of the graph
+    unordered_map<StringRef, Function, StringRefHash> names;
+
+    //The raw costs of the functions
+    vector<double> selfCosts;
+    vector<double> callCosts;
+
+    unordered_map<unsigned long long, size_t> callIndex;
+    vector<CallgrindCall> calls;
+
+    //The current position
+    string object;
+    string file;
+    Function function;
+
+    //The target of the next call
+    string callObject;
+    Function callee;
+    unsigned int callCount;
+    bool inCall;
+
+    explicit CallgrindState(Graph& g) : graph(g), positions(1), eventIndex(0), function(NO_FUNCTION), callee(NO_FUNCTION), callCount(0), inCall(false) {}
+};
+
+static inline const char* skipSpaces(const char* it) {
+    while (*it == ' ' || *it == '\t') {
+        ++it;
+    }
+
+    return it;
+}
+
+static inline const char* skipToken(const char* it) {
+    while (*it && *it != ' ' && *it != '\t') {
+        ++it;
+    }
+
+    return it;
+}
+
+/*!
+ * \brief Parse a possibly compressed name specification ("(id) name", "(id)" or "name").
+ * \param value The value of the specification.
+ * \param id Will be set to the id of the compression, -1 if there is none.
+ * \param name Will be set to the name, empty if the specification only references a previous id.
+ */
+static void parseName(const char* value, long& id, string& name) {
+    value = skipSpaces(value);
+
+    id = -1;
+
+    if (*value == '(') {
+        char* end;
+        id = strtol(value + 1, &end, 10);
+
+        value = *end == ')' ? end + 1 : end;
+        value = skipSpaces(value);
+    }
+
+    name.assign(value);
+}
+
+/*!
+ * \brief Resolve a compressed string specification (ob=, fl=, ...).
+ */
+static const string& resolve(vector<string>& table, const char* value, string& name) {
+    long id;
+    parseName(value, id, name);
+
+    if (id >= 0) {
+        if (static_cast<size_t>(id) >= table.size()) {
+            table.resize(id + 1);
+        }
+
+        if (name.empty()) {
+            return table[id];
+        }
+
+        table[id] = name;
+    }
+
+    return name;
+}
+
+static Function getFunction(CallgrindState& state, const string& name) {
+    auto it = state.names.find(StringRef(name));
+
+    if (it != state.names.end()) {
+        return it->second;
+    }
+
+    Function function = add_vertex(state.graph);
+    state.graph[function].name = arenaOf(state.graph).store(name);
+
+    state.names[state.graph[function].name] = function;
+    state.selfCosts.push_back(0.0);
+    state.callCosts.push_back(0.0);
+
+    return function;
+}
+
+/*!
+ * \brief Resolve a compressed function specification (fn= or cfn=).
+ */
+static Function resolveFunction(CallgrindState& state, const char* value, string& name) {
+    long id;
+    parseName(value, id, name);
+
+    if (id >= 0 && name.empty()) {
+        if (static_cast<size_t>(id) < state.functions.size() && state.functions[id] != NO_FUNCTION) {
+            return state.functions[id];
+        }
+
+        ERROR cout << "ERROR : Reference to an undefined function (" << id << ")" << endl;
+        return NO_FUNCTION;
+    }
+
+    Function function = getFunction(state, name);
+
+    if (id >= 0) {
+        if (static_cast<size_t>(id) >= state.functions.size()) {
+            state.functions.resize(id + 1, NO_FUNCTION);
+        }
+
+        state.functions[id] = function;
+    }
+
+    return function;
+}
+
+static void parseHeader(CallgrindState& state, const string& key, const char* value, const string& event) {
+    if (key == "positions") {
+        state.positions = 0;
+
+        for (value = skipSpaces(value); *value; value = skipSpaces(skipToken(value))) {
+            ++state.positions;
+        }
+    } else if (key == "events") {
+        unsigned int index = 0;
+        bool found = event.empty();
+
+        for (value = skipSpaces(value); *value; value = skipSpaces(skipToken(value)), ++index) {
+            if (!found && string(value, skipToken(value)) == event) {
+                state.eventIndex = index;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            ERROR cout << "ERROR : The event " << event << " is not in the profile, the first event is used" << endl;
+        }
+    }
+
+    //The other header lines (version, creator, cmd, summary, ...) are not useful
+}
+
+static void parseSpecification(CallgrindState& state, const string& key, const char* value, string& name) {
+    if (key == "fn") {
+        state.function = resolveFunction(state, value, name);
+
+        if (state.function != NO_FUNCTION) {
+            vertex_info& info = state.graph[state.function];
+
+            if (info.module == EMPTY_STRING) {
+                info.module = stringsOf(state.graph).intern(state.object);
+            }
+
+            if (info.file_name == EMPTY_STRING) {
+                info.file_name = stringsOf(state.graph).intern(state.file);
+            }
+        }
+    } else if (key == "cfn") {
+        state.callee = resolveFunction(state, value, name);
+    } else if (key == "calls") {
+        state.callCount = strtoul(value, NULL, 10);
+        state.inCall = true;
+    } else if (key == "ob") {
+        state.object = resolve(state.objects, value, name);
+    } else if (key == "cob") {
+        state.callObject = resolve(state.objects, value, name);
+    } else if (key == "fl") {
+        state.file = resolve(state.files, value, name);
+    } else if (key == "fi" || key == "fe" || key == "cfi" || key == "cfl" || key == "jfi") {
+        //Only used to fill the compression table
+        resolve(state.files, value, name);
+    }
+
+    //jump= and jcnd= are not useful
+}
+
+static void parseCost(CallgrindState& state, const char* line) {
+    const char* it = skipSpaces(line);
+
+    //Skip the positions
+    for (unsigned int i = 0; i < state.positions && *it; ++i) {
+        it = skipSpaces(skipToken(it));
+    }
+
+    //Skip the events before the selected one
+    for (unsigned int i = 0; i < state.eventIndex && *it; ++i) {
+        it = skipSpaces(skipToken(it));
+    }
+
+    double cost = *it ? strtod(it, NULL) : 0.0;
+
+    if (state.inCall) {
+        state.inCall = false;
+
+        if (state.function != NO_FUNCTION && state.callee != NO_FUNCTION) {
+            unsigned long long key = (static_cast<unsigned long long>(state.function) << 32) | state.callee;
+
+            unordered_map<unsigned long long, size_t>::const_iterator found = state.callIndex.find(key);
+
+            size_t index;
+            if (found == state.callIndex.end()) {
+                index = state.calls.size();
+                state.callIndex[key] = index;
+                state.calls.push_back(CallgrindCall(state.function, state.callee));
+            } else {
+                index = found->second;
+            }
+
+            state.calls[index].calls += state.callCount;
+            state.calls[index].cost += cost;
+
+            vertex_info& info = state.graph[state.callee];
+            info.calls += state.callCount;
+
+            if (info.module == EMPTY_STRING) {
+                info.module = stringsOf(state.graph).intern(state.callObject.empty() ? state.object : state.callObject);
+            }
+
+            //The recursive calls are already included in the self cost
+            if (state.function != state.callee) {
+                state.callCosts[state.function] += cost;
+            }
+        }
+
+        //The call specifications are only valid for one call
+        state.callObject.clear();
+    } else if (state.function != NO_FUNCTION) {
+        state.selfCosts[state.function] += cost;
+    }
+}
+
+CallGraph* CallgrindReader::read(const string& file) {
+    DEBUG cout << "DEBUG : Importing the callgrind file " << file << endl;
+
+    Timer timer;
+
+    Graph* graph = new Graph();
+    CallgrindState state(*graph);
+
+    //A compressed profile is decompressed in memory
+    MappedFile mapped(file);
+
+    if (!mapped.isOpen()) {
+        ERROR cout << "ERROR : Unable to open " << file << endl;
+
+        delete graph;
+        return NULL;
+    }
+
+    string line;
+    string key;
+    string name;
+
+    const char* current = mapped.begin();
+    while (current < mapped.end()) {
+        const char* eol = static_cast<const char*>(memchr(current, '\n', mapped.end() - current));
+        if (!eol) {
+            eol = mapped.end();
+        }
+
+        line.assign(current, eol);
+        current = eol + 1;
+
+        if (!line.empty() && line[line.size() - 1] == '\r') {
+            line.erase(line.size() - 1);
+        }
+
+        const char* it = line.c_str();
+        char c = *it;
+
+        if (c == '\0' || c == '#') {
+            continue;
+        }
+
+        //Cost line
+        if (isdigit(c) || c == '+' || c == '-' || c == '*') {
+            parseCost(state, it);
+            continue;
+        }
+
+        //Specification (key=value) or header (key: value)
+        const char* end = it + strcspn(it, "=:");
+
+        if (*end == '\0') {
+            continue;
+        }
+
+        key.assign(it, end);
+
+        if (*end == '=') {
+            parseSpecification(state, key, end + 1, name);
+        } else {
+            parseHeader(state, key, end + 1, event);
+        }
+    }
+
+    //Compute the costs as percentages of the total
+    double total = 0.0;
+    for (vector<double>::const_iterator it = state.selfCosts.begin(); it != state.selfCosts.end(); ++it) {
+        total += *it;
+    }
+
+    double ratio = total > 0.0 ? 100.0 / total : 0.0;
+
+    FunctionIterator first, last;
+    for (boost::tie(first, last) = vertices(*graph); first != last; ++first) {
+        vertex_info& info = (*graph)[*first];
+
+        info.self_cost = state.selfCosts[*first] * ratio;
+        info.inclusive_cost = (state.selfCosts[*first] + state.callCosts[*first]) * ratio;
+    }
+
+    GraphBuilder builder(threads, memoryCap);
+    builder.reserve(state.calls.size());
+
+    for (vector<CallgrindCall>::const_iterator it = state.calls.begin(); it != state.calls.end(); ++it) {
+        builder.addCall(it->caller, it->callee, it->calls, it->cost * ratio);
+    }
+
+    CallGraph* callGraph = builder.build(graph);
+
+    DEBUG cout << "DEBUG : Number of edges : " << callGraph->numberOfCallSites() << endl;
+    DEBUG cout << "DEBUG : Number of vertices : " << num_vertices(*graph) << endl;
+    PERF cout << "PERF : Importation finished in " << timer.elapsed() << "ms" << endl;
+
+    Timer extraction;
+
+    completeGraph(*callGraph);
+
+    PERF cout << "PERF : Information extracted in " << extraction.elapsed() << "ms" << endl;
+
+    return callGraph;
+}
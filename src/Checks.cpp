@@ -39,12 +39,12 @@ void checkFunctions(const CallGraph& graph) {
     for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
         if (graph[*first].size == 0) {
             ++zero;
-            cout << "Function " << graph[*first].name << " has a size of zero" << endl;
+            cout << "Function " << graph.nameOf(*first) << " has a size of zero" << endl;
         }
 
         if (graph[*first].calls == 0) {
             ++zeroCalls;
-            cout << "Function " << graph[*first].name << " has never been called" << endl;
+            cout << "Function " << graph.nameOf(*first) << " has never been called" << endl;
         }
     }
 
@@ -0,0 +1,81 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "Column.hpp"
+#include "Logging.hpp"
+
+using namespace std;
+using namespace inlining;
+
+void* inlining::mapTemporary(size_t bytes) {
+    const char* directory = getenv("TMPDIR");
+
+    string path = string(directory && *directory ? directory : "/tmp") + "/inlining-column-XXXXXX";
+
+    vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+
+    int fd = mkstemp(name.data());
+    if (fd < 0) {
+        ERROR cout << "ERROR : cannot create a temporary file in " << path << endl;
+        return NULL;
+    }
+
+    //The file stays alive as long as it is mapped
+    unlink(name.data());
+
+    //The blocks are allocated now, a full disk would otherwise raise a SIGBUS at the first write in the mapping
+    if (posix_fallocate(fd, 0, bytes) != 0) {
+        ERROR cout << "ERROR : cannot allocate " << bytes << " bytes for the temporary file " << name.data() << endl;
+        close(fd);
+        return NULL;
+    }
+
+    void* address = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (address == MAP_FAILED) {
+        ERROR cout << "ERROR : mmap of a temporary file failed" << endl;
+        return NULL;
+    }
+
+    return address;
+}
+
+void inlining::unmapTemporary(void* address, size_t bytes) {
+    munmap(address, bytes);
+}
+
+void inlining::evictTemporary(void* address, size_t bytes) {
+    //The beginning of the range is rounded down to a page, the values of the page stay in the file
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t offset = reinterpret_cast<size_t>(address) % page;
+
+    madvise(static_cast<char*>(address) - offset, bytes + offset, MADV_DONTNEED);
+}
@@ -0,0 +1,205 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <algorithm>
+#include <cstring>
+
+#include "CompressedNames.hpp"
+
+using namespace std;
+using namespace inlining;
+
+namespace {
+
+//The lengths are stored with 7 bits per byte, the high bit indicates that another byte follows
+void writeLength(vector<char>& data, size_t length) {
+    while (length >= 0x80) {
+        data.push_back(static_cast<char>((length & 0x7F) | 0x80));
+        length >>= 7;
+    }
+
+    data.push_back(static_cast<char>(length));
+}
+
+size_t readLength(const char*& position) {
+    size_t length = 0;
+    unsigned int shift = 0;
+
+    while (true) {
+        unsigned char byte = static_cast<unsigned char>(*position++);
+
+        length |= static_cast<size_t>(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) {
+            return length;
+        }
+
+        shift += 7;
+    }
+}
+
+size_t sharedPrefix(const StringRef& lhs, const StringRef& rhs) {
+    size_t length = min(lhs.size(), rhs.size());
+
+    size_t shared = 0;
+    while (shared < length && lhs.begin[shared] == rhs.begin[shared]) {
+        ++shared;
+    }
+
+    return shared;
+}
+
+/*!
+ * \brief Decode the names of the table one after the other, from the beginning of a block.
+ */
+struct Cursor {
+    const char* position;
+    string name;
+
+    void head() {
+        size_t length = readLength(position);
+
+        name.assign(position, length);
+        position += length;
+    }
+
+    void next() {
+        size_t shared = readLength(position);
+        size_t length = readLength(position);
+
+        name.resize(shared);
+        name.append(position, length);
+        position += length;
+    }
+};
+
+} //end of anonymous namespace
+
+CompressedNames::CompressedNames(const vector<StringRef>& names) : ranks(names.size()), ids(names.size()) {
+    for (size_t id = 0; id < names.size(); ++id) {
+        ids[id] = id;
+    }
+
+    //The identifiers of equal names stay in increasing order
+    stable_sort(ids.begin(), ids.end(), [&names](unsigned int lhs, unsigned int rhs){ return names[lhs] < names[rhs]; });
+
+    blocks.reserve((names.size() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+
+    for (size_t position = 0; position < ids.size(); ++position) {
+        const StringRef& name = names[ids[position]];
+
+        ranks[ids[position]] = position;
+
+        if (position % BLOCK_SIZE == 0) {
+            blocks.push_back(data.size());
+
+            writeLength(data, name.size());
+            data.insert(data.end(), name.begin, name.end);
+        } else {
+            size_t shared = sharedPrefix(names[ids[position - 1]], name);
+
+            writeLength(data, shared);
+            writeLength(data, name.size() - shared);
+            data.insert(data.end(), name.begin + shared, name.end);
+        }
+    }
+
+    vector<char>(data).swap(data);
+}
+
+string CompressedNames::operator[](size_t id) const {
+    size_t position = ranks[id];
+
+    Cursor cursor;
+    cursor.position = data.data() + blocks[position / BLOCK_SIZE];
+    cursor.head();
+
+    for (size_t i = 0; i < position % BLOCK_SIZE; ++i) {
+        cursor.next();
+    }
+
+    return cursor.name;
+}
+
+StringRef CompressedNames::head(size_t block) const {
+    const char* position = data.data() + blocks[block];
+    size_t length = readLength(position);
+
+    return StringRef(position, position + length);
+}
+
+void CompressedNames::findPrefix(const StringRef& prefix, vector<size_t>& result) const {
+    find(prefix, false, result);
+}
+
+void CompressedNames::find(const StringRef& name, vector<size_t>& result) const {
+    find(name, true, result);
+}
+
+void CompressedNames::find(const StringRef& prefix, bool exact, vector<size_t>& result) const {
+    if (empty()) {
+        return;
+    }
+
+    //The first block starting after the prefix, the matches can start at the end of the previous one
+    size_t first = 0;
+    size_t last = blocks.size();
+    while (first < last) {
+        size_t middle = first + (last - first) / 2;
+
+        if (head(middle) < prefix) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    size_t block = first > 0 ? first - 1 : 0;
+
+    Cursor cursor;
+    cursor.position = data.data() + blocks[block];
+
+    for (size_t position = block * BLOCK_SIZE; position < ids.size(); ++position) {
+        if (position % BLOCK_SIZE == 0) {
+            cursor.head();
+        } else {
+            cursor.next();
+        }
+
+        int comparison = cursor.name.compare(0, prefix.size(), prefix.begin, prefix.size());
+
+        //All the next names are after the prefix
+        if (comparison > 0) {
+            break;
+        }
+
+        if (comparison == 0) {
+            //The longer names are after the equal ones
+            if (exact && cursor.name.size() > prefix.size()) {
+                break;
+            }
+
+            result.push_back(ids[position]);
+        }
+    }
+}
+
+size_t CompressedNames::bytes() const {
+    return data.capacity() + blocks.capacity() * sizeof(size_t) + (ranks.capacity() + ids.capacity()) * sizeof(unsigned int);
+}
@@ -0,0 +1,168 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+#include "Decompressor.hpp"
+#include "Logging.hpp"
+
+using namespace std;
+using namespace inlining;
+
+static const size_t BUFFER_SIZE = 1 << 18;
+
+Compression inlining::detectCompression(const char* data, size_t size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    if (size >= 2 && bytes[0] == 0x1F && bytes[1] == 0x8B) {
+        return GZIP_COMPRESSION;
+    }
+
+    if (size >= 4 && bytes[0] == 0x28 && bytes[1] == 0xB5 && bytes[2] == 0x2F && bytes[3] == 0xFD) {
+        return ZSTD_COMPRESSION;
+    }
+
+    return NO_COMPRESSION;
+}
+
+Compression inlining::detectCompression(const string& file) {
+    ifstream stream(file.c_str(), ios::in | ios::binary);
+
+    char magic[4];
+    stream.read(magic, sizeof(magic));
+
+    return detectCompression(magic, stream.gcount());
+}
+
+Decompressor::Decompressor() : compression(NO_COMPRESSION), failed(false) {
+    memset(&gzip, 0, sizeof(gzip));
+
+#ifdef HAVE_ZSTD
+    zstd = NULL;
+#endif
+}
+
+Decompressor::~Decompressor() {
+    if (compression == GZIP_COMPRESSION) {
+        inflateEnd(&gzip);
+    }
+
+#ifdef HAVE_ZSTD
+    if (zstd) {
+        ZSTD_freeDStream(zstd);
+    }
+#endif
+}
+
+bool Decompressor::fail() {
+    failed = true;
+    return false;
+}
+
+bool Decompressor::start(const char* data, size_t size) {
+    compression = detectCompression(data, size);
+
+    if (compression == GZIP_COMPRESSION) {
+        //Accept both the gzip and the zlib headers
+        if (inflateInit2(&gzip, 15 + 32) != Z_OK) {
+            ERROR cout << "ERROR : Unable to initialize zlib" << endl;
+            return fail();
+        }
+    } else if (compression == ZSTD_COMPRESSION) {
+#ifdef HAVE_ZSTD
+        zstd = ZSTD_createDStream();
+
+        if (!zstd || ZSTD_isError(ZSTD_initDStream(zstd))) {
+            ERROR cout << "ERROR : Unable to initialize zstd" << endl;
+            return fail();
+        }
+#else
+        ERROR cout << "ERROR : The analyzer has been built without zstd support" << endl;
+        return fail();
+#endif
+    }
+
+    return true;
+}
+
+bool Decompressor::feed(const char* data, size_t size, string& output) {
+    if (failed) {
+        return false;
+    }
+
+    if (compression == NO_COMPRESSION) {
+        output.append(data, size);
+        return true;
+    }
+
+    char buffer[BUFFER_SIZE];
+
+    if (compression == GZIP_COMPRESSION) {
+        gzip.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        gzip.avail_in = size;
+
+        //Continue while there is input or while zlib may have more output
+        do {
+            gzip.next_out = reinterpret_cast<Bytef*>(buffer);
+            gzip.avail_out = sizeof(buffer);
+
+            int result = inflate(&gzip, Z_NO_FLUSH);
+
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+                ERROR cout << "ERROR : Invalid gzip stream" << endl;
+                return fail();
+            }
+
+            output.append(buffer, sizeof(buffer) - gzip.avail_out);
+
+            if (result == Z_BUF_ERROR) {
+                break;
+            }
+
+            //Several gzip members can be concatenated
+            if (result == Z_STREAM_END) {
+                inflateReset(&gzip);
+            }
+        } while (gzip.avail_in > 0 || gzip.avail_out == 0);
+    }
+
+#ifdef HAVE_ZSTD
+    if (compression == ZSTD_COMPRESSION) {
+        ZSTD_inBuffer input = {data, size, 0};
+        ZSTD_outBuffer out = {buffer, sizeof(buffer), 0};
+
+        //Continue while there is input or while zstd may have more output
+        do {
+            out.pos = 0;
+
+            size_t result = ZSTD_decompressStream(zstd, &out, &input);
+
+            if (ZSTD_isError(result)) {
+                ERROR cout << "ERROR : Invalid zstd stream : " << ZSTD_getErrorName(result) << endl;
+                return fail();
+            }
+
+            output.append(buffer, out.pos);
+        } while (input.pos < input.size || out.pos == out.size);
+    }
+#endif
+
+    return true;
+}
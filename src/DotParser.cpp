@@ -0,0 +1,457 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <cctype>
+#include <cstdlib>
+#include <algorithm>
+
+#include "DotParser.hpp"
+#include "Tokenizer.hpp"
+
+using std::string;
+
+using namespace inlining;
+
+static inline bool equals(const StringRef& ref, const char* literal) {
+    size_t length = strlen(literal);
+    return ref.size() == length && memcmp(ref.begin, literal, length) == 0;
+}
+
+static inline bool isIdStart(char c) {
+    return isalpha(static_cast<unsigned char>(c)) || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+static inline bool isIdChar(char c) {
+    return isIdStart(c) || isdigit(static_cast<unsigned char>(c));
+}
+
+static inline bool isNumeralChar(char c) {
+    return isdigit(static_cast<unsigned char>(c)) || c == '.';
+}
+
+bool DotParser::fail() {
+    error = true;
+    return false;
+}
+
+void DotParser::skipBlanks() {
+    while (it < end) {
+        char c = *it;
+
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            ++it;
+        } else if (c == '#' || (c == '/' && it + 1 < end && it[1] == '/')) {
+            //Line comment
+            while (it < end && *it != '\n') {
+                ++it;
+            }
+        } else if (c == '/' && it + 1 < end && it[1] == '*') {
+            //Block comment
+            it += 2;
+            while (it + 1 < end && !(it[0] == '*' && it[1] == '/')) {
+                ++it;
+            }
+            it += 2;
+        } else {
+            break;
+        }
+    }
+}
+
+bool DotParser::parseId(StringRef& id) {
+    bool quoted;
+    return parseId(id, quoted);
+}
+
+bool DotParser::parseId(StringRef& id, bool& quoted) {
+    skipBlanks();
+
+    if (it >= end) {
+        return fail();
+    }
+
+    quoted = *it == '"';
+
+    if (quoted) {
+        const char* begin = ++it;
+
+        while (it < end && *it != '"') {
+            //An escaped character cannot close the string
+            it += (*it == '\\' && it + 1 < end) ? 2 : 1;
+        }
+
+        if (it >= end) {
+            return fail();
+        }
+
+        id = StringRef(begin, it++);
+
+        //The concatenation of strings is not supported
+        skipBlanks();
+        if (it < end && *it == '+') {
+            return fail();
+        }
+
+        return true;
+    }
+
+    const char* begin = it;
+
+    if (isIdStart(*it)) {
+        while (it < end && isIdChar(*it)) {
+            ++it;
+        }
+    } else if (isNumeralChar(*it) || *it == '-') {
+        ++it;
+
+        while (it < end && isNumeralChar(*it)) {
+            ++it;
+        }
+    } else {
+        //HTML identifiers, anonymous subgraphs, ...
+        return fail();
+    }
+
+    id = StringRef(begin, it);
+
+    return true;
+}
+
+bool DotParser::parseHeader() {
+    StringRef keyword;
+    if (!parseId(keyword)) {
+        return false;
+    }
+
+    if (equals(keyword, "strict") && !parseId(keyword)) {
+        return false;
+    }
+
+    if (!equals(keyword, "digraph") && !equals(keyword, "graph")) {
+        return fail();
+    }
+
+    skipBlanks();
+
+    //The name of the graph is optional
+    StringRef name;
+    if (it < end && *it != '{' && !parseId(name)) {
+        return false;
+    }
+
+    skipBlanks();
+
+    if (it >= end || *it != '{') {
+        return fail();
+    }
+
+    ++it;
+    started = true;
+
+    return true;
+}
+
+bool DotParser::parseAttributes(DotStatement& statement) {
+    while (it < end && *it == '[') {
+        ++it;
+
+        while (true) {
+            skipBlanks();
+
+            if (it >= end) {
+                return fail();
+            }
+
+            if (*it == ']') {
+                ++it;
+                break;
+            }
+
+            if (*it == ',' || *it == ';') {
+                ++it;
+                continue;
+            }
+
+            StringRef key;
+            StringRef value;
+
+            if (!parseId(key)) {
+                return false;
+            }
+
+            skipBlanks();
+
+            if (it >= end || *it != '=') {
+                return fail();
+            }
+
+            ++it;
+
+            if (!parseId(value)) {
+                return false;
+            }
+
+            if (equals(key, "label")) {
+                statement.label = value;
+            } else if (equals(key, "module")) {
+                statement.module = value;
+            } else if (equals(key, "filename")) {
+                statement.fileName = value;
+            }
+        }
+
+        skipBlanks();
+    }
+
+    return true;
+}
+
+bool DotParser::next(DotStatement& statement) {
+    if (error) {
+        return false;
+    }
+
+    //Continue an edge chain
+    if (chainIndex + 1 < chain.size()) {
+        statement = chainStatement;
+        statement.source = chain[chainIndex];
+        statement.target = chain[chainIndex + 1];
+        ++chainIndex;
+
+        return true;
+    }
+
+    if (!started && !parseHeader()) {
+        return false;
+    }
+
+    while (true) {
+        skipBlanks();
+
+        if (it >= end) {
+            //The end of a part is not the end of the graph
+            return partial ? false : fail();
+        }
+
+        if (*it == '}') {
+            it = end;
+            closed = true;
+            return false;
+        }
+
+        if (*it == ';' || *it == ',') {
+            ++it;
+            continue;
+        }
+
+        StringRef id;
+        bool quoted;
+        if (!parseId(id, quoted)) {
+            return false;
+        }
+
+        //Keywords are never quoted
+        bool keyword = !quoted;
+
+        skipBlanks();
+
+        if (it >= end) {
+            if (!partial) {
+                return fail();
+            }
+
+            //A node statement without attributes at the end of a part
+            statement = DotStatement();
+            statement.source = id;
+
+            return true;
+        }
+
+        //Attribute statement (graph [...], node [...] or edge [...])
+        if (keyword && *it == '[' && (equals(id, "graph") || equals(id, "node") || equals(id, "edge"))) {
+            DotStatement ignored;
+
+            if (!parseAttributes(ignored)) {
+                return false;
+            }
+
+            continue;
+        }
+
+        if (keyword && equals(id, "subgraph")) {
+            return fail();
+        }
+
+        //Graph attribute (ID = ID)
+        if (*it == '=') {
+            ++it;
+
+            StringRef value;
+            if (!parseId(value)) {
+                return false;
+            }
+
+            continue;
+        }
+
+        //Ports are not supported
+        if (*it == ':') {
+            return fail();
+        }
+
+        statement = DotStatement();
+
+        //Edge statement
+        if (*it == '-' && it + 1 < end && (it[1] == '>' || it[1] == '-')) {
+            chain.clear();
+            chain.push_back(id);
+
+            while (it + 1 < end && *it == '-' && (it[1] == '>' || it[1] == '-')) {
+                it += 2;
+
+                StringRef target;
+                if (!parseId(target)) {
+                    return false;
+                }
+
+                chain.push_back(target);
+
+                skipBlanks();
+
+                if (it < end && *it == ':') {
+                    return fail();
+                }
+            }
+
+            statement.edge = true;
+
+            if (!parseAttributes(statement)) {
+                return false;
+            }
+
+            chainStatement = statement;
+            chainIndex = 1;
+
+            statement.source = chain[0];
+            statement.target = chain[1];
+
+            return true;
+        }
+
+        //Node statement
+        statement.source = id;
+
+        return parseAttributes(statement);
+    }
+}
+
+string inlining::unescape(const StringRef& id) {
+    //Only the escaped identifiers need to be rewritten
+    if (std::find(id.begin, id.end, '\\') == id.end) {
+        return id.str();
+    }
+
+    string value(id.size(), '\0');
+    value.resize(unescape(id, &value[0]));
+
+    return value;
+}
+
+size_t inlining::unescape(const StringRef& id, char* destination) {
+    char* value = destination;
+
+    for (const char* it = id.begin; it != id.end; ++it) {
+        if (*it == '\\' && it + 1 != id.end) {
+            if (it[1] == '"') {
+                *value++ = '"';
+                ++it;
+                continue;
+            } else if (it[1] == '\n') {
+                ++it;
+                continue;
+            } else if (it[1] == '\r' && it + 2 != id.end && it[2] == '\n') {
+                it += 2;
+                continue;
+            }
+        }
+
+        *value++ = *it;
+    }
+
+    return value - destination;
+}
+
+//Label of the form name\ninclusive%\n(self%)\ncalls×, the separators are always searched, only the requested numbers
+//are converted
+bool inlining::decodeFunctionLabel(const StringRef& label, double& inclusiveCost, double& selfCost, unsigned int& calls, unsigned int fields) {
+    StringRef parts[4];
+    if (splitLabel(label, parts, 4) != 4) {
+        return false;
+    }
+
+    if (fields & FUNCTION_INCLUSIVE_COST) {
+        inclusiveCost = parseDouble(labelNumber(parts[1]));
+    }
+
+    if (fields & FUNCTION_SELF_COST) {
+        selfCost = parseDouble(labelNumber(parts[2]));
+    }
+
+    if (fields & FUNCTION_CALLS) {
+        calls = parseUnsigned(labelNumber(parts[3]));
+    }
+
+    return true;
+}
+
+//Label of the form calls× or cost%\ncalls×
+void inlining::decodeCallSiteLabel(const StringRef& label, double& cost, unsigned int& calls, unsigned int fields) {
+    StringRef parts[2];
+    unsigned int count = splitLabel(label, parts, 2);
+
+    if (fields & CALL_SITE_COST) {
+        cost = count == 1 ? 0.0 : parseDouble(labelNumber(parts[0]));
+    }
+
+    if (fields & CALL_SITE_CALLS) {
+        calls = parseUnsigned(labelNumber(parts[count - 1]));
+    }
+}
+
+const char* inlining::nextStatement(const char* position, const char* end) {
+    while (position < end) {
+        const char* newLine = static_cast<const char*>(memchr(position, '\n', end - position));
+
+        if (!newLine) {
+            return end;
+        }
+
+        const char* last = newLine;
+        if (last > position && last[-1] == '\r') {
+            --last;
+        }
+
+        if (last > position && last[-1] == ';') {
+            return newLine + 1;
+        }
+
+        position = newLine + 1;
+    }
+
+    return end;
+}
@@ -0,0 +1,334 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "FoldedReader.hpp"
+#include "Decompressor.hpp"
+#include "CallGraph.hpp"
+#include "Logging.hpp"
+#include "Timer.hpp"
+#include "GraphBuilder.hpp"
+
+using namespace std;
+using namespace inlining;
+
+namespace {
+
+struct FoldedFunction {
+    string name;
+    string module;
+    double selfSamples;
+    double inclusiveSamples;
+    size_t lastStack;   //The last stack the function has been counted in
+
+    FoldedFunction(const string& n, const string& m) : name(n), module(m), selfSamples(0.0), inclusiveSamples(0.0), lastStack(0) {}
+};
+
+struct FoldedCall {
+    unsigned int caller;
+    unsigned int callee;
+    double samples;
+    size_t lastStack;   //The last stack the call site has been counted in
+
+    FoldedCall(unsigned int a, unsigned int b) : caller(a), callee(b), samples(0.0), lastStack(0) {}
+};
+
+/*!
+ * \brief The accumulated samples of the stacks read so far.
+ */
+struct FoldedState {
+    unordered_map<string, unsigned int> index;
+    vector<FoldedFunction> functions;
+
+    unordered_map<unsigned long long, unsigned int> callIndex;
+    vector<FoldedCall> calls;
+
+    vector<unsigned int> stack;
+    string key;
+
+    size_t stacks;
+    double samples;
+
+    FoldedState() : stacks(0), samples(0.0) {}
+
+    unsigned int intern(const char* begin, const char* end) {
+        //Remove the annotations of stackcollapse-perf.pl (kernel, jit and inlined functions)
+        if (end - begin > 4 && end[-4] == '_' && end[-3] == '[' && end[-1] == ']') {
+            end -= 4;
+        }
+
+        //The key contains the module, the same function can be in several modules
+        key.assign(begin, end);
+
+        auto found = index.find(key);
+        if (found != index.end()) {
+            return found->second;
+        }
+
+        unsigned int function = functions.size();
+        index[key] = function;
+
+        const char* separator = static_cast<const char*>(memchr(begin, '`', end - begin));
+        if (separator) {
+            functions.push_back(FoldedFunction(string(separator + 1, end), string(begin, separator)));
+        } else {
+            functions.push_back(FoldedFunction(key, string()));
+        }
+
+        return function;
+    }
+
+    unsigned int call(unsigned int caller, unsigned int callee) {
+        unsigned long long id = (static_cast<unsigned long long>(caller) << 32) | callee;
+
+        auto found = callIndex.find(id);
+        if (found != callIndex.end()) {
+            return found->second;
+        }
+
+        unsigned int index = calls.size();
+        callIndex[id] = index;
+        calls.push_back(FoldedCall(caller, callee));
+
+        return index;
+    }
+};
+
+} //end of anonymous namespace
+
+//Parse a stack of the form root;...;leaf count
+static bool parseStack(FoldedState& state, const char* begin, const char* end) {
+    while (end > begin && (end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) {
+        --end;
+    }
+
+    if (begin == end || *begin == '#') {
+        return true;
+    }
+
+    const char* separator = end;
+    while (separator > begin && separator[-1] != ' ' && separator[-1] != '\t') {
+        --separator;
+    }
+
+    if (separator == begin || separator == end) {
+        return false;
+    }
+
+    char buffer[64];
+    size_t length = min<size_t>(end - separator, sizeof(buffer) - 1);
+    memcpy(buffer, separator, length);
+    buffer[length] = '\0';
+
+    char* last;
+    double samples = strtod(buffer, &last);
+    if (*last != '\0' || samples < 0.0) {
+        return false;
+    }
+
+    const char* frames = separator - 1;
+    while (frames > begin && (frames[-1] == ' ' || frames[-1] == '\t')) {
+        --frames;
+    }
+
+    //Each stack has its own stamp to count the recursive functions and call sites only once
+    size_t stamp = ++state.stacks;
+
+    state.stack.clear();
+
+    const char* frame = begin;
+    while (frame < frames) {
+        const char* next = static_cast<const char*>(memchr(frame, ';', frames - frame));
+        if (!next) {
+            next = frames;
+        }
+
+        if (next > frame) {
+            state.stack.push_back(state.intern(frame, next));
+        }
+
+        frame = next + 1;
+    }
+
+    if (state.stack.empty()) {
+        return true;
+    }
+
+    state.samples += samples;
+    state.functions[state.stack.back()].selfSamples += samples;
+
+    for (size_t i = 0; i < state.stack.size(); ++i) {
+        FoldedFunction& function = state.functions[state.stack[i]];
+
+        if (function.lastStack != stamp) {
+            function.lastStack = stamp;
+            function.inclusiveSamples += samples;
+        }
+
+        if (i > 0) {
+            FoldedCall& call = state.calls[state.call(state.stack[i - 1], state.stack[i])];
+
+            if (call.lastStack != stamp) {
+                call.lastStack = stamp;
+                call.samples += samples;
+            }
+        }
+    }
+
+    return true;
+}
+
+CallGraph* FoldedReader::read(const string& file) {
+    DEBUG cout << "DEBUG : Importing the folded stacks " << file << endl;
+
+    Timer timer;
+
+    int fd = file == "-" ? 0 : open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ERROR cout << "ERROR : Unable to open " << file << endl;
+        return NULL;
+    }
+
+    FoldedState state;
+
+    vector<char> buffer(max<size_t>(blockSize, 4));
+    string pending;
+    size_t buffered = 0;
+    size_t lines = 0;
+    bool started = false;
+    bool valid = true;
+
+    Decompressor decompressor;
+
+    while (valid) {
+        ssize_t count = ::read(fd, &buffer[buffered], buffer.size() - buffered);
+
+        if (count < 0) {
+            ERROR cout << "ERROR : Unable to read " << file << endl;
+            valid = false;
+            break;
+        }
+
+        buffered += count;
+
+        //The compression is detected from the first bytes
+        if (!started && (buffered >= 4 || count == 0)) {
+            if (!decompressor.start(&buffer[0], buffered)) {
+                valid = false;
+                break;
+            }
+
+            started = true;
+        }
+
+        if (started && buffered > 0) {
+            if (!decompressor.feed(&buffer[0], buffered, pending)) {
+                valid = false;
+                break;
+            }
+
+            buffered = 0;
+
+            //Only the complete lines are parsed, the last one is kept for the next block
+            const char* begin = pending.data();
+            const char* end = begin + pending.size();
+
+            const char* newLine;
+            while ((newLine = static_cast<const char*>(memchr(begin, '\n', end - begin)))) {
+                ++lines;
+
+                if (!parseStack(state, begin, newLine)) {
+                    ERROR cout << "ERROR : Invalid stack at line " << lines << " of " << file << endl;
+                    valid = false;
+                    break;
+                }
+
+                begin = newLine + 1;
+            }
+
+            pending.erase(0, begin - pending.data());
+        }
+
+        if (count == 0) {
+            //The last line does not necessarily end with a new line
+            if (valid && !pending.empty() && !parseStack(state, pending.data(), pending.data() + pending.size())) {
+                ERROR cout << "ERROR : Invalid stack at line " << (lines + 1) << " of " << file << endl;
+                valid = false;
+            }
+
+            break;
+        }
+    }
+
+    if (fd != 0) {
+        close(fd);
+    }
+
+    if (!valid) {
+        return NULL;
+    }
+
+    Graph* graph = new Graph(state.functions.size());
+
+    //Compute the costs as percentages of the samples
+    double ratio = state.samples > 0.0 ? 100.0 / state.samples : 0.0;
+
+    for (unsigned int i = 0; i < state.functions.size(); ++i) {
+        FoldedFunction& function = state.functions[i];
+        vertex_info& info = (*graph)[vertex(i, *graph)];
+
+        info.name = arenaOf(*graph).store(function.name);
+        info.module = stringsOf(*graph).intern(function.module);
+        info.self_cost = function.selfSamples * ratio;
+        info.inclusive_cost = function.inclusiveSamples * ratio;
+        info.calls = toCalls(function.inclusiveSamples);
+    }
+
+    GraphBuilder builder(threads, memoryCap);
+    builder.reserve(state.calls.size());
+
+    for (auto& call : state.calls) {
+        builder.addCall(call.caller, call.callee, toCalls(call.samples), call.samples * ratio);
+    }
+
+    CallGraph* callGraph = builder.build(graph);
+
+    DEBUG cout << "DEBUG : Number of stacks : " << lines << endl;
+    DEBUG cout << "DEBUG : Number of edges : " << callGraph->numberOfCallSites() << endl;
+    DEBUG cout << "DEBUG : Number of vertices : " << num_vertices(*graph) << endl;
+    PERF cout << "PERF : Importation finished in " << timer.elapsed() << "ms" << endl;
+
+    Timer extraction;
+
+    completeGraph(*callGraph);
+
+    PERF cout << "PERF : Information extracted in " << extraction.elapsed() << "ms" << endl;
+
+    return callGraph;
+}
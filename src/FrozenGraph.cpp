@@ -0,0 +1,70 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <stdexcept>
+
+#include "FrozenGraph.hpp"
+#include "CallGraph.hpp"
+
+using namespace std;
+using namespace inlining;
+
+size_t FrozenGraph::footprint(size_t functions, size_t callSites) {
+    size_t perFunction = sizeof(StringId) + 3 * sizeof(unsigned int) + sizeof(char) + 3 * sizeof(double);
+    size_t perCallSite = sizeof(double);
+
+    return functions * perFunction + callSites * perCallSite;
+}
+
+FrozenGraph::FrozenGraph(const CallGraph& graph, bool map) : mapped(map), callSites(&graph.callSites()), strings(&graph.strings()) {
+    const Graph& g = *graph.getGraph();
+
+    size_t functions = num_vertices(g);
+
+    //The call sites that did not fit in the table are missing
+    if (callSites->overflowed()) {
+        throw length_error("The call graph is too large to be frozen with 32 bits indexes");
+    }
+
+    modules.allocate(functions, mapped);
+    functionCalls.allocate(functions, mapped);
+    sizes.allocate(functions, mapped);
+    functionParameters.allocate(functions, mapped);
+    virtualities.allocate(functions, mapped);
+    functionFrequencies.allocate(functions, mapped);
+    selfCosts.allocate(functions, mapped);
+    temperatures.allocate(functions, mapped);
+
+    for (Function function = 0; function < functions; ++function) {
+        const vertex_info& info = g[function];
+
+        modules[function] = info.module;
+        functionCalls[function] = info.calls;
+        sizes[function] = info.size;
+        functionParameters[function] = info.parameters;
+        virtualities[function] = info.virtuality;
+        functionFrequencies[function] = info.frequency;
+        selfCosts[function] = info.self_cost;
+    }
+
+    callSiteTemperatures.allocate(callSites->numberOfCallSites(), mapped);
+
+    //A column can fall back to the heap if its file cannot be created
+    mapped = modules.isMapped() || callSiteTemperatures.isMapped();
+}
@@ -0,0 +1,411 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "GmonReader.hpp"
+#include "CallGraph.hpp"
+#include "MappedFile.hpp"
+#include "Infos.hpp"
+#include "Logging.hpp"
+#include "Timer.hpp"
+#include "GraphBuilder.hpp"
+
+using namespace std;
+using namespace inlining;
+
+//The tags of the records of a gmon.out file (see gmon_out.h of binutils)
+static const unsigned char GMON_TAG_TIME_HIST = 0;
+static const unsigned char GMON_TAG_CG_ARC = 1;
+static const unsigned char GMON_TAG_BB_COUNT = 2;
+
+static const size_t GMON_HEADER_SIZE = 20;     //cookie, version and padding
+static const size_t GMON_DIMENSION_SIZE = 16;  //dimension and its abbreviation
+
+namespace {
+
+/*!
+ * \brief A cursor on the content of the profile. The values are in the byte order of the machine.
+ */
+struct GmonInput {
+    const char* it;
+    const char* end;
+    unsigned int pointerSize;
+
+    GmonInput(const char* b, const char* e, unsigned int p) : it(b), end(e), pointerSize(p) {}
+
+    bool skip(size_t size) {
+        if (static_cast<size_t>(end - it) < size) {
+            return false;
+        }
+
+        it += size;
+        return true;
+    }
+
+    bool readInt(uint32_t& value) {
+        if (end - it < 4) {
+            return false;
+        }
+
+        memcpy(&value, it, 4);
+        it += 4;
+        return true;
+    }
+
+    bool readAddress(uint64_t& value) {
+        if (static_cast<size_t>(end - it) < pointerSize) {
+            return false;
+        }
+
+        if (pointerSize == 4) {
+            uint32_t address;
+            memcpy(&address, it, 4);
+            value = address;
+        } else {
+            memcpy(&value, it, 8);
+        }
+
+        it += pointerSize;
+        return true;
+    }
+};
+
+struct GmonArc {
+    unsigned int caller;
+    unsigned int callee;
+    double calls;
+    double cost;
+};
+
+/*!
+ * \brief The functions and the arcs of the profile.
+ */
+struct GmonProfile {
+    Infos& infos;
+    const string& executable;
+
+    unordered_map<uint64_t, unsigned int> index;
+    vector<const FunctionSymbol*> functions;
+    vector<double> samples;
+
+    unordered_map<unsigned long long, size_t> arcIndex;
+    vector<GmonArc> arcs;
+
+    double unresolved;
+
+    GmonProfile(Infos& i, const string& e) : infos(i), executable(e), unresolved(0.0) {}
+
+    //Return the function containing the address or -1
+    int resolve(uint64_t address) {
+        const FunctionSymbol* symbol = infos.findFunction(executable, address);
+
+        if (!symbol) {
+            return -1;
+        }
+
+        auto result = index.insert(make_pair(static_cast<uint64_t>(symbol->address), static_cast<unsigned int>(functions.size())));
+
+        if (result.second) {
+            functions.push_back(symbol);
+            samples.push_back(0.0);
+        }
+
+        return result.first->second;
+    }
+
+    void addArc(unsigned int caller, unsigned int callee, uint32_t count) {
+        unsigned long long key = (static_cast<unsigned long long>(caller) << 32) | callee;
+
+        auto result = arcIndex.insert(make_pair(key, arcs.size()));
+
+        if (result.second) {
+            GmonArc arc;
+            arc.caller = caller;
+            arc.callee = callee;
+            arc.calls = 0.0;
+            arc.cost = 0.0;
+            arcs.push_back(arc);
+        }
+
+        arcs[result.first->second].calls += count;
+    }
+};
+
+} //end of anonymous namespace
+
+//Read the pointer size of the executable from its identification bytes
+static unsigned int pointerSizeOf(const string& executable) {
+    ifstream stream(executable.c_str(), ios::in | ios::binary);
+
+    unsigned char identification[EI_NIDENT];
+    if (!stream.read(reinterpret_cast<char*>(identification), EI_NIDENT) || memcmp(identification, ELFMAG, SELFMAG) != 0) {
+        return 0;
+    }
+
+    return identification[EI_CLASS] == ELFCLASS32 ? 4 : 8;
+}
+
+static bool readHistogram(GmonInput& input, GmonProfile& profile) {
+    uint64_t low;
+    uint64_t high;
+    uint32_t size;
+    uint32_t rate;
+
+    if (!input.readAddress(low) || !input.readAddress(high) || !input.readInt(size) || !input.readInt(rate)) {
+        return false;
+    }
+
+    if (!input.skip(GMON_DIMENSION_SIZE) || static_cast<size_t>(input.end - input.it) < size * 2ul) {
+        return false;
+    }
+
+    for (uint32_t bin = 0; bin < size; ++bin) {
+        uint16_t count;
+        memcpy(&count, input.it + bin * 2, 2);
+
+        if (count == 0) {
+            continue;
+        }
+
+        //The samples of a bin are attributed to the function of its first address
+        uint64_t address = low + (high - low) * bin / size;
+
+        int function = profile.resolve(address);
+
+        if (function < 0) {
+            profile.unresolved += count;
+        } else {
+            profile.samples[function] += count;
+        }
+    }
+
+    input.it += size * 2ul;
+
+    return true;
+}
+
+static bool readArc(GmonInput& input, GmonProfile& profile, vector<double>& spontaneous) {
+    uint64_t from;
+    uint64_t self;
+    uint32_t count;
+
+    if (!input.readAddress(from) || !input.readAddress(self) || !input.readInt(count)) {
+        return false;
+    }
+
+    int callee = profile.resolve(self);
+    if (callee < 0) {
+        return true;
+    }
+
+    int caller = profile.resolve(from);
+
+    //The calls coming from outside of the executable have no caller
+    if (caller < 0) {
+        spontaneous.resize(profile.functions.size());
+        spontaneous[callee] += count;
+    } else {
+        profile.addArc(caller, callee, count);
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Propagate the time of the callees to their callers, in proportion of the calls. The call graph is traversed
+ * in depth-first order, the back edges of the cycles are not propagated.
+ */
+static void propagate(GmonProfile& profile, const vector<double>& calls, vector<double>& inclusive) {
+    size_t n = profile.functions.size();
+
+    vector<vector<size_t>> children(n);
+    for (size_t i = 0; i < profile.arcs.size(); ++i) {
+        children[profile.arcs[i].caller].push_back(i);
+    }
+
+    inclusive = profile.samples;
+
+    vector<unsigned char> state(n, 0);      //0 : not visited, 1 : in the current path, 2 : done
+    vector<pair<unsigned int, size_t>> path;
+
+    for (unsigned int root = 0; root < n; ++root) {
+        if (state[root]) {
+            continue;
+        }
+
+        state[root] = 1;
+        path.push_back(make_pair(root, 0));
+
+        while (!path.empty()) {
+            unsigned int function = path.back().first;
+            size_t& next = path.back().second;
+
+            if (next < children[function].size()) {
+                unsigned int callee = profile.arcs[children[function][next++]].callee;
+
+                if (!state[callee]) {
+                    state[callee] = 1;
+                    path.push_back(make_pair(callee, 0));
+                }
+
+                continue;
+            }
+
+            //All the callees are done
+            for (auto arc : children[function]) {
+                GmonArc& call = profile.arcs[arc];
+
+                if (state[call.callee] == 2 && call.callee != function && calls[call.callee] > 0.0) {
+                    call.cost = inclusive[call.callee] * call.calls / calls[call.callee];
+                    inclusive[function] += call.cost;
+                }
+            }
+
+            state[function] = 2;
+            path.pop_back();
+        }
+    }
+}
+
+CallGraph* GmonReader::read(const string& file) {
+    DEBUG cout << "DEBUG : Importing the gmon file " << file << endl;
+
+    Timer timer;
+
+    MappedFile mapped(file);
+    if (!mapped.isOpen()) {
+        ERROR cout << "ERROR : Unable to open " << file << endl;
+        return NULL;
+    }
+
+    if (mapped.size() < GMON_HEADER_SIZE || memcmp(mapped.begin(), "gmon", 4) != 0) {
+        ERROR cout << "ERROR : " << file << " is not a gmon.out file" << endl;
+        return NULL;
+    }
+
+    unsigned int pointerSize = pointerSizeOf(executable);
+    if (!pointerSize) {
+        ERROR cout << "ERROR : " << executable << " is not an ELF executable, use --executable to set the profiled program" << endl;
+        return NULL;
+    }
+
+    GmonInput input(mapped.begin() + GMON_HEADER_SIZE, mapped.end(), pointerSize);
+    GmonProfile profile(infos, executable);
+    vector<double> spontaneous;
+
+    while (input.it < input.end) {
+        unsigned char tag = *input.it++;
+
+        bool valid;
+        if (tag == GMON_TAG_TIME_HIST) {
+            valid = readHistogram(input, profile);
+        } else if (tag == GMON_TAG_CG_ARC) {
+            valid = readArc(input, profile, spontaneous);
+        } else if (tag == GMON_TAG_BB_COUNT) {
+            //The basic-block counts are not used
+            uint32_t count;
+            valid = input.readInt(count) && input.skip(count * 2ul * pointerSize);
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            ERROR cout << "ERROR : " << file << " is truncated or corrupted" << endl;
+            return NULL;
+        }
+    }
+
+    if (profile.unresolved > 0.0) {
+        WARN cout << "WARNING : " << profile.unresolved << " samples are outside of the functions of " << executable << endl;
+    }
+
+    size_t n = profile.functions.size();
+
+    //The number of calls of each function, including the spontaneous ones
+    vector<double> calls(n, 0.0);
+    vector<double> incoming(n, 0.0);
+    spontaneous.resize(n);
+
+    for (auto& arc : profile.arcs) {
+        calls[arc.callee] += arc.calls;
+
+        if (arc.caller != arc.callee) {
+            incoming[arc.callee] += arc.calls;
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        calls[i] += spontaneous[i];
+        incoming[i] += spontaneous[i];
+    }
+
+    vector<double> inclusive;
+    propagate(profile, incoming, inclusive);
+
+    //Compute the costs as percentages of the samples
+    double total = 0.0;
+    for (auto sample : profile.samples) {
+        total += sample;
+    }
+
+    double ratio = total > 0.0 ? 100.0 / total : 0.0;
+
+    Graph* graph = new Graph(n);
+
+    StringId module = stringsOf(*graph).intern(executable);
+
+    for (unsigned int i = 0; i < n; ++i) {
+        vertex_info& info = (*graph)[vertex(i, *graph)];
+
+        info.name = arenaOf(*graph).store(profile.functions[i]->name);
+        info.module = module;
+        info.self_cost = profile.samples[i] * ratio;
+        info.inclusive_cost = inclusive[i] * ratio;
+        info.calls = toCalls(calls[i]);
+    }
+
+    GraphBuilder builder(threads, memoryCap);
+    builder.reserve(profile.arcs.size());
+
+    for (auto& arc : profile.arcs) {
+        builder.addCall(arc.caller, arc.callee, toCalls(arc.calls), arc.cost * ratio);
+    }
+
+    CallGraph* callGraph = builder.build(graph);
+
+    DEBUG cout << "DEBUG : Number of edges : " << callGraph->numberOfCallSites() << endl;
+    DEBUG cout << "DEBUG : Number of vertices : " << num_vertices(*graph) << endl;
+    PERF cout << "PERF : Importation finished in " << timer.elapsed() << "ms" << endl;
+
+    Timer extraction;
+
+    completeGraph(*callGraph);
+
+    PERF cout << "PERF : Information extracted in " << extraction.elapsed() << "ms" << endl;
+
+    return callGraph;
+}
@@ -0,0 +1,201 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <algorithm>
+#include <iostream>
+
+#include "GraphBuilder.hpp"
+#include "CallGraph.hpp"
+#include "Parallel.hpp"
+#include "Logging.hpp"
+
+using namespace std;
+using namespace inlining;
+
+unsigned int NameInterner::intern(const StringRef& name) {
+    size_t hash = StringRefHash()(name);
+    unsigned int index = (hash >> 32) & (SHARDS - 1);
+
+    Shard& shard = shards[index];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto result = shard.index.insert(std::make_pair(name, static_cast<unsigned int>(shard.names.size())));
+
+    if (result.second) {
+        shard.names.push_back(name);
+    }
+
+    return (result.first->second << SHARD_BITS) | index;
+}
+
+//Group the call sites by function with a counting sort. Each block counts and places the call sites of its own range of
+//functions, the call sites of a function stay in the order of their numbers
+static void groupBy(Column<FrozenFunction>& functions, size_t numberOfFunctions, Column<FrozenCallSite>& offsets, Column<FrozenCallSite>& callSites, unsigned int threads, bool mapped) {
+    size_t count = functions.size();
+    size_t blocks = threads <= 1 ? 1 : threads;
+
+    auto firstFunction = [&](size_t block){ return static_cast<FrozenFunction>(block * numberOfFunctions / blocks); };
+
+    offsets.allocate(numberOfFunctions + 1, mapped);
+    callSites.allocate(count, mapped);
+
+    //The histogram of each range, then its prefix sum without the previous ranges
+    vector<size_t> totals(blocks, 0);
+
+    parallelFor(blocks, threads, [&](size_t block){
+        FrozenFunction first = firstFunction(block);
+        FrozenFunction last = firstFunction(block + 1);
+
+        for (FrozenCallSite callSite = 0; callSite < count; ++callSite) {
+            FrozenFunction function = functions[callSite];
+
+            if (function >= first && function < last) {
+                ++offsets[function + 1];
+            }
+        }
+
+        size_t sum = 0;
+        for (size_t i = first + 1; i <= last; ++i) {
+            sum += offsets[i];
+            offsets[i] = sum;
+        }
+
+        totals[block] = sum;
+    });
+
+    vector<size_t> bases(blocks, 0);
+    for (size_t block = 1; block < blocks; ++block) {
+        bases[block] = bases[block - 1] + totals[block - 1];
+    }
+
+    Column<FrozenCallSite> positions;
+    positions.allocate(numberOfFunctions, mapped);
+
+    parallelFor(blocks, threads, [&](size_t block){
+        FrozenFunction first = firstFunction(block);
+        FrozenFunction last = firstFunction(block + 1);
+
+        for (size_t i = first + 1; i <= last; ++i) {
+            offsets[i] += bases[block];
+        }
+
+        for (FrozenFunction function = first; function < last; ++function) {
+            positions[function] = offsets[function];
+        }
+
+        for (FrozenCallSite callSite = 0; callSite < count; ++callSite) {
+            FrozenFunction function = functions[callSite];
+
+            if (function >= first && function < last) {
+                callSites[positions[function]++] = callSite;
+            }
+        }
+    });
+
+    //The pages of the mapped columns have all been written
+    functions.evict(0, functions.size());
+    offsets.evict(0, offsets.size());
+    callSites.evict(0, callSites.size());
+}
+
+void GraphBuilder::reserve(size_t size) {
+    if (size > capacity()) {
+        grow(size);
+    }
+}
+
+void GraphBuilder::grow(size_t size) {
+    //Above the cap, the calls are moved to a larger temporary file
+    if (memoryCap > 0 && size * sizeof(RawCall) > memoryCap) {
+        Column<RawCall> larger;
+        larger.allocate(size, true);
+
+        if (larger.isMapped()) {
+            for (size_t i = 0; i < count; ++i) {
+                larger[i] = call(i);
+            }
+
+            larger.evict(0, count);
+
+            spill.swap(larger);
+            vector<RawCall>().swap(heap);
+
+            return;
+        }
+    }
+
+    //The temporary file cannot be created, the calls go back to the heap
+    if (spill.isMapped()) {
+        heap.assign(spill.data(), spill.data() + count);
+        spill.allocate(0, false);
+    }
+
+    heap.reserve(size);
+}
+
+CallGraph* GraphBuilder::build(Graph* graph) {
+    CallGraph* callGraph = new CallGraph(graph);
+
+    build(callGraph->callSites(), callGraph->numberOfFunctions());
+
+    return callGraph;
+}
+
+void GraphBuilder::build(CallSiteTable& table, size_t functions) {
+    table.overflow = !CallSiteTable::fits(functions, count);
+
+    if (table.overflow) {
+        ERROR cout << "ERROR : " << count << " call sites between " << functions << " functions do not fit in 32 bits indexes" << endl;
+    }
+
+    size_t callSites = table.overflow ? 0 : count;
+
+    bool mapped = memoryCap > 0 && CallSiteTable::footprint(functions, callSites) > memoryCap;
+
+    table.sources.allocate(callSites, mapped);
+    table.targets.allocate(callSites, mapped);
+    table.callCounts.allocate(callSites, mapped);
+    table.costs.allocate(callSites, mapped);
+    table.frequencies.allocate(callSites, mapped);
+
+    //The fields are copied by blocks of calls
+    size_t blocks = threads <= 1 ? 1 : threads * 4;
+
+    parallelFor(blocks, threads, [&](size_t block){
+        size_t first = block * callSites / blocks;
+        size_t last = (block + 1) * callSites / blocks;
+
+        for (size_t i = first; i < last; ++i) {
+            const RawCall& raw = call(i);
+
+            table.sources[i] = raw.caller;
+            table.targets[i] = raw.callee;
+            table.callCounts[i] = raw.calls;
+            table.costs[i] = raw.cost;
+        }
+
+        spill.evict(first, last);
+        table.callCounts.evict(first, last);
+        table.costs.evict(first, last);
+    });
+
+    groupBy(table.sources, functions, table.outOffsets, table.outEdges, threads, mapped);
+    groupBy(table.targets, functions, table.inOffsets, table.inEdges, threads, mapped);
+}
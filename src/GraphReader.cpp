@@ -20,14 +20,18 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <iomanip>
 #include <fstream>
 #include <cctype>
+#include <algorithm>
 
 #include "GraphReader.hpp"
 #include "CallGraph.hpp"
-#include "Utils.hpp"
 #include "Timer.hpp"
 #include "Graph.hpp"
 #include "Logging.hpp"
 #include "Infos.hpp"
+#include "MappedFile.hpp"
+#include "DotParser.hpp"
+#include "Parallel.hpp"
+#include "GraphBuilder.hpp"
 
 #include "boost/graph/graphviz.hpp"
 #include "boost/graph/adjacency_list.hpp"
@@ -39,22 +43,40 @@ using namespace inlining;
 CallGraph* GraphReader::read(const string& file) {
     DEBUG cout << "DEBUG : Importing the .dot file " << file << endl;
 
+    if (!useBoost) {
+        CallGraph* callGraph = readFast(file);
+
+        if (callGraph) {
+            return callGraph;
+        }
+
+        WARN cout << "WARNING : " << file << " cannot be parsed by the fast reader, falling back to boost" << endl;
+    }
+
+    return readBoost(file);
+}
+
+CallGraph* GraphReader::readBoost(const string& file) {
     Timer timer;
 
     Graph* graph = new Graph();
     dynamic_properties dp;
 
-    dp.property("node_id", get(&vertex_info::name, *graph));
+    //In lean mode, the labels are only kept until the end of the reading
+    StringArena scratch;
+    StringArena& labels = lean ? scratch : arenaOf(*graph);
+
+    dp.property("node_id", arenaMap(*graph, &vertex_info::name));
 
     //Vertex properties
 
-    dp.property("label", get(&vertex_info::label, *graph));
-    dp.property("filename", get(&vertex_info::file_name, *graph));
-    dp.property("module", get(&vertex_info::module, *graph));
+    dp.property("label", arenaMap(*graph, &vertex_info::label, labels));
+    dp.property("filename", InternedPropertyMap(*graph, &vertex_info::file_name));
+    dp.property("module", InternedPropertyMap(*graph, &vertex_info::module));
 
     //Edge properties
 
-    dp.property("label", get(&edge_info::label, *graph));
+    dp.property("label", arenaMap(*graph, &edge_info::label, labels));
 
     // Use ref_property_map to turn a graph property into a property map
     ref_property_map<Graph*, string> gname(get_property(*graph, graph_name));
@@ -76,137 +98,329 @@ CallGraph* GraphReader::read(const string& file) {
 
     extractInformation(*callGraph);
 
+    if (lean) {
+        callGraph->releaseLabels();
+    }
+
     return callGraph;
 }
 
-//Must be called after parseVertices() in order to have the total of calls computed
-void GraphReader::parseEdges(CallGraph& graph) {
-    CallSiteIterator first, last;
-    for (boost::tie(first, last) = graph.callSites(); first != last; ++first) {
-        auto& callSite = graph[*first];
+namespace {
+
+struct DotNode {
+    unsigned int name;
+    StringRef label;
+    StringRef module;
+    StringRef fileName;
+};
+
+struct DotEdge {
+    unsigned int source;
+    unsigned int target;
+    unsigned int calls;
+    double cost;
+    StringRef label;
+};
+
+/*!
+ * \brief A part of the statements of the file, parsed by a single thread.
+ */
+struct DotChunk {
+    const char* begin;
+    const char* end;
+    bool failed;
+    bool closed;
+    vector<DotNode> nodes;      //The node statements in the order of the file
+    vector<DotEdge> edges;      //The edges in the order of the file
+};
+
+} //end of anonymous namespace
+
+static void parseChunk(DotChunk& chunk, NameInterner& table, unsigned int fields) {
+    DotParser parser(chunk.begin, chunk.end, true);
+
+    DotStatement statement;
+    while (parser.next(statement)) {
+        unsigned int source = table.intern(statement.source);
+
+        if (statement.edge) {
+            DotEdge edge;
+            edge.source = source;
+            edge.target = table.intern(statement.target);
+            edge.calls = 0;
+            edge.cost = 0.0;
+            edge.label = statement.label;
+
+            if (!statement.label.empty()) {
+                decodeCallSiteLabel(statement.label, edge.cost, edge.calls, fields);
+            }
 
-        string label = callSite.label;
+            chunk.edges.push_back(edge);
+        } else {
+            DotNode node;
+            node.name = source;
+            node.label = statement.label;
+            node.module = statement.module;
+            node.fileName = statement.fileName;
 
-        if (label.length() == 0) {
-            continue;
+            chunk.nodes.push_back(node);
         }
+    }
+
+    chunk.failed = parser.failed();
+    chunk.closed = parser.isClosed();
+}
 
-        //Only the number of calls is included
-        if (label.find("\\n") == string::npos) {
-            string callsToken;
-            callsToken = label.substr(0, label.length() - 2);
+CallGraph* GraphReader::readFast(const string& file) {
+    Timer timer;
+
+    MappedFile mapped(file);
+    if (!mapped.isOpen()) {
+        return NULL;
+    }
 
-            callSite.cost = 0.0;
-            callSite.calls = toNumber<unsigned int>(callsToken);
-        } else { //Both the number of calls and the cost are included
-            string::size_type mid = label.find("\\n");
+    DotParser headerParser(mapped.begin(), mapped.end());
+    if (!headerParser.header()) {
+        return NULL;
+    }
+
+    //Split the statements in chunks, the chunks always start at the beginning of a statement
+    const char* body = headerParser.position();
+    size_t length = mapped.end() - body;
+    size_t chunks = threads <= 1 ? 1 : threads * 4;
 
-            string costToken = label.substr(0, mid);
-            string callsToken = label.substr(mid + 2, label.length() - 2 - mid - 2);
+    vector<DotChunk> parts;
+    const char* begin = body;
+    for (size_t i = 1; i <= chunks && begin < mapped.end(); ++i) {
+        const char* end = i == chunks ? mapped.end() : nextStatement(body + i * (length / chunks), mapped.end());
 
-            callSite.cost = toNumber<double>(costToken);
-            callSite.calls = toNumber<unsigned int>(callsToken);
+        if (end <= begin) {
+            continue;
         }
 
-        callSite.frequency = callSite.calls / static_cast<double>(graph.getNumberOfCalls());
+        DotChunk chunk;
+        chunk.begin = begin;
+        chunk.end = end;
+        parts.push_back(chunk);
+
+        begin = end;
     }
-}
 
-static int countParameters(const string& name) {
-    string::size_type start = name.rfind(")");
+    NameInterner table;
+
+    parallelFor(parts.size(), threads, [&](size_t i){ parseChunk(parts[i], table, fields); });
 
-    if (start == string::npos) {
-        return 0;
+    //Only the last chunk can contain the end of the graph
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (parts[i].failed || parts[i].closed != (i + 1 == parts.size())) {
+            return NULL;
+        }
     }
 
-    string::size_type i = start - 1;
-    unsigned int parameters = 0;
-    unsigned int inTemplate = 0;    //To avoid counting parameters in a template declaration
-    unsigned int inParenth = 0;     //To avoid counting parameters in a function pointer declaration
+    PERF cout << "PERF : Statements parsed in " << timer.elapsed() << "ms" << endl;
 
-    //Parse from the right
-    while (!(inParenth == 0 && name[i] == '(')) {
-        if (!isspace(name[i]) && parameters == 0) {
-            parameters = 1;
+    //boost::read_graphviz numbers the vertices in the order of their identifiers
+    vector<unsigned int> names;
+    for (unsigned int shard = 0; shard < NameInterner::SHARDS; ++shard) {
+        for (unsigned int i = 0; i < table.names(shard).size(); ++i) {
+            names.push_back((i << NameInterner::SHARD_BITS) | shard);
         }
+    }
 
-        if (name[i] ==')') {
-            inParenth++;
-        } else if (name[i] == '(') {
-            inParenth--;
-        }
+    auto nameOf = [&table](unsigned int name) -> const StringRef& { return table.name(name); };
+
+    std::sort(names.begin(), names.end(), [&nameOf](unsigned int lhs, unsigned int rhs){ return nameOf(lhs) < nameOf(rhs); });
+
+    const unsigned int mask = NameInterner::SHARDS - 1;
+
+    vector<vector<Function>> functions(NameInterner::SHARDS);
+    for (unsigned int shard = 0; shard < NameInterner::SHARDS; ++shard) {
+        functions[shard].resize(table.names(shard).size());
+    }
+
+    for (unsigned int i = 0; i < names.size(); ++i) {
+        functions[names[i] & mask][names[i] >> NameInterner::SHARD_BITS] = i;
+    }
 
-        if (inParenth == 0) {
-            if (name[i] == '>') {
-                inTemplate++;
-            } else if (name[i] == '<') {
-                inTemplate--;
+    auto functionOf = [&functions, mask](unsigned int name){ return functions[name & mask][name >> NameInterner::SHARD_BITS]; };
+
+    //Like boost, the last value of an attribute wins
+    vector<DotNode> attributes(names.size());
+    for (auto& part : parts) {
+        for (auto& node : part.nodes) {
+            DotNode& attribute = attributes[functionOf(node.name)];
+
+            if (!node.label.empty()) {
+                attribute.label = node.label;
+            }
+
+            if (!node.module.empty()) {
+                attribute.module = node.module;
             }
 
-            if (name[i] == ',' && inTemplate == 0) {
-                ++parameters;
+            if (!node.fileName.empty()) {
+                attribute.fileName = node.fileName;
             }
         }
-        --i;
     }
 
-    return parameters;
-}
+    Graph* graph = new Graph(names.size());
 
-void GraphReader::parseVertices(CallGraph& graph) {
-    unsigned int totalCalls = 0;
-    unsigned int totalSize = 0;
+    //Each block of vertices has its own part of the arena, an unescaped name is never longer than the escaped one
+    size_t blocks = threads <= 1 ? 1 : threads * 4;
+    vector<char*> storage(blocks);
+    for (size_t block = 0; block < blocks; ++block) {
+        size_t size = 0;
+        for (size_t i = block * names.size() / blocks; i < (block + 1) * names.size() / blocks; ++i) {
+            size += nameOf(names[i]).size() + 1;
+        }
 
-    FunctionIterator first, last;
-    for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
-        auto& function = graph[*first];
+        storage[block] = arenaOf(*graph).allocate(size);
+    }
 
-        //Demangle only if necessary
-        if (infos.isDemangled()) {
-            function.parameters = countParameters(function.name);
-        } else {
-            function.parameters = countParameters(demangle(function.name));
+    //Each vertex is independent from the others
+    parallelFor(blocks, threads, [&](size_t block){
+        size_t first = block * names.size() / blocks;
+        size_t last = (block + 1) * names.size() / blocks;
+
+        char* position = storage[block];
+        for (size_t i = first; i < last; ++i) {
+            vertex_info& function = (*graph)[vertex(i, *graph)];
+
+            size_t size = unescape(nameOf(names[i]), position);
+            position[size] = '\0';
+            function.name = StringRef(position, position + size);
+            position += size + 1;
+
+            decodeFunctionLabel(attributes[i].label, function.inclusive_cost, function.self_cost, function.calls, fields);
         }
+    });
+
+    //The strings are interned by a single thread
+    StringPool& strings = stringsOf(*graph);
+    for (size_t i = 0; i < names.size(); ++i) {
+        vertex_info& function = (*graph)[vertex(i, *graph)];
+        function.module = strings.intern(unescape(attributes[i].module));
+        function.file_name = strings.intern(unescape(attributes[i].fileName));
+    }
+
+    size_t calls = 0;
+    for (auto& part : parts) {
+        calls += part.edges.size();
+    }
+
+    //The file is unmapped at the end of the reading, the labels are copied to decode the other fields later
+    Column<char> buffer;
+    Column<RawLabel> functionLabels;
+    Column<RawLabel> callSiteLabels;
 
-#ifdef BENCH
-        function.size = 1 + (rand() % 1000);
-        function.virtuality = (rand() % 6) < 2;
-#else
-        function.size = infos.sizeOf(function.module, function.name);
-        function.virtuality = infos.isVirtual(function.module, function.name);
-#endif
+    if (fields != ALL_FIELDS) {
+        size_t characters = 0;
+        for (size_t i = 0; i < names.size(); ++i) {
+            characters += attributes[i].label.size();
+        }
 
-        totalSize += function.size;
+        for (auto& part : parts) {
+            for (auto& edge : part.edges) {
+                characters += edge.label.size();
+            }
+        }
 
-        string label = function.label;
+        bool map = memoryCap > 0 && characters + (names.size() + calls) * sizeof(RawLabel) > memoryCap;
 
-        if (label.length() == 0) {
-            continue;
+        buffer.allocate(characters, map);
+        functionLabels.allocate(names.size(), map);
+        callSiteLabels.allocate(calls, map);
+
+        //The written pages are released by blocks of labels
+        const size_t BLOCK = 1 << 16;
+
+        size_t offset = 0;
+        size_t first = 0;
+        for (size_t i = 0; i < names.size(); ++i) {
+            functionLabels[i] = {offset, attributes[i].label.size()};
+            std::copy(attributes[i].label.begin, attributes[i].label.end, buffer.data() + offset);
+            offset += attributes[i].label.size();
+
+            if ((i + 1) % BLOCK == 0 || i + 1 == names.size()) {
+                functionLabels.evict(i - i % BLOCK, i + 1);
+                buffer.evict(first, offset);
+                first = offset;
+            }
+        }
+
+        size_t callSite = 0;
+        for (auto& part : parts) {
+            size_t first = offset;
+
+            for (auto& edge : part.edges) {
+                callSiteLabels[callSite++] = {offset, edge.label.size()};
+                std::copy(edge.label.begin, edge.label.end, buffer.data() + offset);
+                offset += edge.label.size();
+            }
+
+            callSiteLabels.evict(callSite - part.edges.size(), callSite);
+            buffer.evict(first, offset);
+        }
+    }
+
+    vector<DotNode>().swap(attributes);
+
+    GraphBuilder builder(threads, memoryCap);
+    builder.reserve(calls);
+
+    //The statements of each part are released once their calls are in the builder
+    for (auto& part : parts) {
+        for (auto& edge : part.edges) {
+            builder.addCall(functionOf(edge.source), functionOf(edge.target), edge.calls, edge.cost);
         }
 
-        string::size_type firstPos = label.find("\\n");
-        string::size_type secondPos = label.find("\\n", firstPos + 2);
-        string::size_type thirdPos = label.find("\\n", secondPos + 2);
+        vector<DotNode>().swap(part.nodes);
+        vector<DotEdge>().swap(part.edges);
+    }
 
-        string inclusiveCostToken = label.substr(firstPos + 2, secondPos - firstPos - 3);
-        string selfCostToken = label.substr(secondPos + 3, thirdPos - secondPos - 4);
-        string callsToken = label.substr(thirdPos + 2, label.length() - thirdPos - 4);
+    CallGraph* callGraph = builder.build(graph);
 
-        function.inclusive_cost = toNumber<double>(inclusiveCostToken);
-        function.self_cost = toNumber<double>(selfCostToken);
-        function.calls = toNumber<unsigned int>(callsToken);
+    DEBUG cout << "DEBUG : Number of edges : " << callGraph->numberOfCallSites() << endl;
+    DEBUG cout << "DEBUG : Number of vertices : " << num_vertices(*graph) << endl;
+    PERF cout << "PERF : Importation finished in " << timer.elapsed() << "ms" << endl;
 
-        totalCalls += function.calls;
+    if (fields != ALL_FIELDS) {
+        callGraph->setRawLabels(buffer, functionLabels, callSiteLabels);
     }
 
-    //Once we have the total of calls we can compute the frequency
+    callGraph->setDecodedFields(fields);
+
+    completeGraph(*callGraph);
+
+    return callGraph;
+}
+
+//Must be called after parseVertices() in order to have the total of calls computed
+void GraphReader::parseEdges(CallGraph& graph) {
+    //The labels of the call sites have been moved in the raw labels of the graph
+    graph.setDecodedFields(graph.getDecodedFields() & ~(CALL_SITE_CALLS | CALL_SITE_COST));
+    graph.decodeLabels(fields & (CALL_SITE_CALLS | CALL_SITE_COST));
+
+    if (complete) {
+        completeCallSites(graph);
+    }
+}
+
+void GraphReader::parseVertices(CallGraph& graph) {
+    FunctionIterator first, last;
     for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
         auto& function = graph[*first];
-        function.frequency = static_cast<double>(function.calls) / static_cast<double>(totalCalls);
+
+        //The labels are kept in the functions, the other fields can be decoded later
+        if (!function.label.empty()) {
+            decodeFunctionLabel(function.label, function.inclusive_cost, function.self_cost, function.calls, fields);
+        }
     }
 
-    graph.setNumberOfCalls(totalCalls);
-    graph.setApplicationSize(totalSize);
+    if (complete) {
+        completeFunctions(graph);
+    }
 }
 
 void GraphReader::extractInformation(CallGraph& graph) {
@@ -215,5 +429,7 @@ void GraphReader::extractInformation(CallGraph& graph) {
     parseVertices(graph);
     parseEdges(graph);
 
+    graph.setDecodedFields(fields);
+
     PERF cout << "PERF : Information extracted in " << timer.elapsed() << "ms" << endl;
 }
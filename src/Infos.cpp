@@ -34,6 +34,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <stddef.h>
 
 #include "Utils.hpp"
+#include "Tokenizer.hpp"
 #include "Logging.hpp"
 #include "Infos.hpp"
 #include "Timer.hpp"
@@ -51,24 +52,81 @@ using std::set;
 
 using namespace inlining;
 
-unsigned int Infos::sizeOf(const string& file, const string& function) {
+void Infos::loadLibrary(const string& file) {
     if (files.find(file) == files.end()) {
         parseFile(file);
         files.insert(file);
     }
+}
+
+unsigned int Infos::sizeOf(const string& file, const string& function) {
+    loadLibrary(file);
 
     return functionSizes[file + "##" + function];
 }
 
 bool Infos::isVirtual(const string& file, const string& function) {
-    if (files.find(file) == files.end()) {
-        parseFile(file);
-        files.insert(file);
-    }
+    loadLibrary(file);
 
     return virtualFunctions.find(file + "##" + function) != virtualFunctions.end();
 }
 
+const SymbolTable& Infos::symbolsOf(const string& file) {
+    auto found = symbolTables.find(file);
+
+    if (found != symbolTables.end()) {
+        return found->second;
+    }
+
+    //The functions are only kept when they are needed
+    m_keepSymbols = true;
+    parseFile(file);
+    files.insert(file);
+    m_keepSymbols = false;
+
+    SymbolTable& table = symbolTables[file];
+
+    sort(table.begin(), table.end(), [](const FunctionSymbol& a, const FunctionSymbol& b){ return a.address < b.address; });
+
+    //Keep only one of the aliases of a function
+    table.erase(unique(table.begin(), table.end(), [](const FunctionSymbol& a, const FunctionSymbol& b){ return a.address == b.address; }), table.end());
+
+    return table;
+}
+
+bool Infos::isExecutable(const string& file) const {
+    std::ifstream stream(file.c_str(), std::ios::in | std::ios::binary);
+
+    //The type follows the identification bytes
+    unsigned char identification[EI_NIDENT + 2];
+    if (!stream.read(reinterpret_cast<char*>(identification), sizeof(identification)) || memcmp(identification, ELFMAG, SELFMAG) != 0) {
+        return false;
+    }
+
+    uint16_t type;
+    memcpy(&type, identification + EI_NIDENT, sizeof(type));
+
+    return type == ET_EXEC;
+}
+
+const FunctionSymbol* inlining::findFunction(const SymbolTable& table, Elf64_Addr address) {
+    //The last function starting before the address
+    auto it = upper_bound(table.begin(), table.end(), address, [](Elf64_Addr a, const FunctionSymbol& b){ return a < b.address; });
+
+    if (it == table.begin()) {
+        return NULL;
+    }
+
+    --it;
+
+    //A function without size extends until the next one
+    if (it->size > 0 && address >= it->address + it->size) {
+        return NULL;
+    }
+
+    return &*it;
+}
+
 /* Types */
 
 struct Relocation {
@@ -98,7 +156,7 @@ void Infos::parseFile(const string& file) {
     Timer timer;
 
     //Can happen in the call graph
-    if (trim(file).size() == 0) {
+    if (trimRef(StringRef(file)).empty()) {
         return;
     }
 
@@ -322,6 +380,11 @@ void Infos::extractSymbols(const string& file, Elf* elf, Elf_Scn* section, vecto
         if (GELF_ST_TYPE(symbol.st_info) == STT_FUNC) {
             functions[symbol.st_value] = i;
 
+            //The undefined functions are not in this file
+            if (m_keepSymbols && symbol.st_shndx != SHN_UNDEF) {
+                symbolTables[file].push_back(FunctionSymbol(symbol.st_value, symbol.st_size, storeName));
+            }
+
             Elf64_Xword size = symbol.st_size;
 
             //If size == 0, we do not have enough information
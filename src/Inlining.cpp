@@ -24,10 +24,21 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Timer.hpp"
 #include "CallGraph.hpp"
 #include "GraphReader.hpp"
+#include "CallgrindReader.hpp"
+#include "SnapshotReader.hpp"
+#include "StreamReader.hpp"
+#include "FoldedReader.hpp"
+#include "GmonReader.hpp"
+#include "PerfReader.hpp"
+#include "PprofReader.hpp"
+#include "Decompressor.hpp"
+#include "ProfileMerger.hpp"
+#include "SnapshotWriter.hpp"
 #include "Sorters.hpp"
 #include "Reports.hpp"
 #include "Infos.hpp"
 #include "Parameters.hpp"
+#include "Logging.hpp"
 
 using std::string;
 using std::cout;
@@ -39,8 +50,83 @@ using namespace inlining;
 void Inlining::analyze(const string& file) {
     Parameters::init();
 
-    GraphReader reader(infos);
-    CallGraph* graph = reader.read(file);
+    //Only the fields of the enabled reports are decoded
+    unsigned int fields = Analyzer::requiredFields();
+
+    if (m_statistic) {
+        fields |= Reports::statisticFields();
+    }
+
+    if (m_issues) {
+        fields |= Reports::issueFields();
+    }
+
+    ProfileReader* reader = createReader(file, infos, m_threads);
+    reader->setFields(fields);
+
+    CallGraph* graph = reader->read(file);
+    delete reader;
+
+    analyze(file, graph);
+}
+
+void Inlining::analyze(const vector<string>& files) {
+    if (files.size() == 1 && m_weights.empty()) {
+        analyze(files[0]);
+        return;
+    }
+
+    Parameters::init();
+
+    //Each run is read by a single thread
+    ProfileMerger merger(infos, [this](const string& file, Infos& local){ return createReader(file, local, 1); });
+    merger.setThreads(m_threads);
+    merger.setMemoryCap(m_memoryCap * 1024 * 1024);
+
+    for (unsigned int i = 0; i < files.size(); ++i) {
+        merger.addRun(files[i], i < m_weights.size() ? m_weights[i] : 1.0);
+    }
+
+    CallGraph* graph = merger.merge();
+
+    string description;
+    for (auto& file : files) {
+        description += description.empty() ? file : ", " + file;
+    }
+
+    analyze(description, graph);
+}
+
+void Inlining::analyze(const string& file, CallGraph* graph) {
+    if (!graph) {
+        return;
+    }
+
+    //The call sites that do not fit in the table are missing, the graph cannot be saved or analyzed
+    if (!graph->canFreeze()) {
+        ERROR cout << "ERROR : " << file << " has too many functions or call sites to be analyzed" << endl;
+        delete graph;
+        return;
+    }
+
+    if (!m_snapshot.empty()) {
+        //A snapshot contains all the fields
+        graph->decodeLabels(ALL_FIELDS);
+
+        SnapshotWriter writer(infos);
+        writer.write(*graph, m_snapshot);
+    }
+
+    graph->setMemoryCap(m_memoryCap * 1024 * 1024);
+
+    //The snapshot keeps the order of the profile
+    if (m_order != ORIGINAL_ORDER) {
+        graph->reorder(computeOrder(*graph, m_order));
+    }
+
+    if (m_lean) {
+        graph->compressNames();
+    }
 
     Analyzer analyzer(*graph, infos);
 
@@ -83,6 +169,51 @@ void Inlining::analyze(const string& file) {
     delete graph;
 }
 
+ProfileReader* Inlining::createReader(const string& file, Infos& readerInfos, unsigned int threads) {
+    //The standard input cannot be read twice to detect its format
+    InputFormat format = m_format != AUTO_FORMAT ? m_format : file == "-" ? DOT_FORMAT : detectFormat(file);
+
+    ProfileReader* reader;
+
+    //The folded stacks, the pprof profiles and the compressed .dot files are streamed, the other formats decompress
+    //a compressed profile or the standard input in memory before reading it
+    if (format == FOLDED_FORMAT) {
+        reader = new FoldedReader(readerInfos);
+    } else if (format == PPROF_FORMAT) {
+        PprofReader* pprofReader = new PprofReader(readerInfos);
+        pprofReader->setSampleType(m_event);
+        reader = pprofReader;
+    } else if (format == CALLGRIND_FORMAT) {
+        CallgrindReader* callgrindReader = new CallgrindReader(readerInfos);
+        callgrindReader->setEvent(m_event);
+        reader = callgrindReader;
+    } else if (format == SNAPSHOT_FORMAT) {
+        reader = new SnapshotReader(readerInfos);
+    } else if (format == GMON_FORMAT) {
+        GmonReader* gmonReader = new GmonReader(readerInfos);
+
+        if (!m_executable.empty()) {
+            gmonReader->setExecutable(m_executable);
+        }
+
+        reader = gmonReader;
+    } else if (format == PERF_FORMAT) {
+        reader = new PerfReader(readerInfos);
+    } else if (file == "-" || detectCompression(file) != NO_COMPRESSION) {
+        reader = new StreamReader(readerInfos);
+    } else {
+        GraphReader* graphReader = new GraphReader(readerInfos);
+        graphReader->setUseBoost(m_boost);
+        reader = graphReader;
+    }
+
+    reader->setThreads(threads);
+    reader->setLean(m_lean);
+    reader->setMemoryCap(m_memoryCap * 1024 * 1024);
+
+    return reader;
+}
+
 void Inlining::printHeader(const string& file, const CallGraph& graph) const {
     cout << "# ATLAS Inlining Analyzer" << endl;
     cout << "# file: " << file << endl;
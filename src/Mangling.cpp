@@ -0,0 +1,828 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <cctype>
+
+#include "Mangling.hpp"
+
+using namespace inlining;
+
+namespace {
+
+/*!
+ * \brief Walks a mangled name without resolving it. Every method returns false if the encoding cannot be walked.
+ */
+class ManglingWalker {
+    public:
+        ManglingWalker(const char* b, const char* e) : it(b), end(e), depth(0), lastArgs(NULL), firstParameter(-1), arguments(0) {}
+
+        bool encoding(int& parameters);
+        int packSize(int index);
+
+        bool atEnd() const {
+            //The clones have a vendor suffix (.constprop.0, .isra.0, ...)
+            return it == end || *it == '.';
+        }
+
+    private:
+        const char* it;
+        const char* end;
+
+        unsigned int depth;         //The nesting level of the template arguments
+        const char* lastArgs;       //The last template arguments of a name, referenced by the template parameters
+        int firstParameter;         //The first template parameter referenced by a type
+        size_t arguments;           //The number of template arguments walked so far
+
+        char peek(size_t offset = 0) const {
+            return it + offset < end ? it[offset] : '\0';
+        }
+
+        bool consume(char c) {
+            if (peek() == c) {
+                ++it;
+                return true;
+            }
+
+            return false;
+        }
+
+        bool number();
+        bool sequenceId();
+        bool templateParameter();
+        bool callOffset();
+        bool sourceName();
+        bool name(bool& templated, bool& special);
+        bool unqualifiedName(bool& special);
+        bool nestedName(bool& templated, bool& special);
+        bool localName(bool& templated, bool& special);
+        bool substitution();
+        bool templateArgs();
+        bool templateArg();
+        bool type();
+        bool functionType();
+};
+
+//[n] <digits>
+bool ManglingWalker::number() {
+    consume('n');
+
+    if (!isdigit(peek())) {
+        return false;
+    }
+
+    while (isdigit(peek())) {
+        ++it;
+    }
+
+    return true;
+}
+
+//[<seq-id>] _, the seq-id are in base 36
+bool ManglingWalker::sequenceId() {
+    while (isdigit(peek()) || isupper(peek())) {
+        ++it;
+    }
+
+    return consume('_');
+}
+
+//T_ is the first template parameter, T <seq-id> _ the next ones
+bool ManglingWalker::templateParameter() {
+    if (!consume('T')) {
+        return false;
+    }
+
+    size_t index = 0;
+
+    if (!consume('_')) {
+        while (isdigit(peek()) || isupper(peek())) {
+            index = index * 36 + (isdigit(*it) ? *it - '0' : *it - 'A' + 10);
+            ++it;
+
+            //A template parameter can only reference template arguments that have already been walked
+            if (index >= arguments) {
+                return false;
+            }
+        }
+
+        if (!consume('_') || ++index >= arguments) {
+            return false;
+        }
+    }
+
+    if (firstParameter < 0) {
+        firstParameter = static_cast<int>(index);
+    }
+
+    return true;
+}
+
+//h <offset> _ | v <offset> _ <offset> _
+bool ManglingWalker::callOffset() {
+    if (consume('h')) {
+        return number() && consume('_');
+    }
+
+    if (consume('v')) {
+        return number() && consume('_') && number() && consume('_');
+    }
+
+    return false;
+}
+
+//<length> <identifier>
+bool ManglingWalker::sourceName() {
+    size_t length = 0;
+
+    if (!isdigit(peek())) {
+        return false;
+    }
+
+    while (isdigit(peek())) {
+        length = length * 10 + (*it++ - '0');
+    }
+
+    if (static_cast<size_t>(end - it) < length) {
+        return false;
+    }
+
+    it += length;
+
+    return true;
+}
+
+bool ManglingWalker::substitution() {
+    if (!consume('S')) {
+        return false;
+    }
+
+    //std::allocator, std::basic_string, std::string, std::istream, std::ostream and std::iostream
+    char c = peek();
+    if (c == 'a' || c == 'b' || c == 's' || c == 'i' || c == 'o' || c == 'd') {
+        ++it;
+        return true;
+    }
+
+    return sequenceId();
+}
+
+//Constructors, destructors and conversion operators are special, their template arguments do not imply a return type
+bool ManglingWalker::unqualifiedName(bool& special) {
+    special = false;
+
+    //Internal linkage (GCC)
+    consume('L');
+
+    char c = peek();
+
+    if (isdigit(c)) {
+        if (!sourceName()) {
+            return false;
+        }
+    } else if (c == 'C') {
+        ++it;
+
+        //Inheriting constructor
+        bool inheriting = consume('I');
+
+        if (peek() < '1' || peek() > '5') {
+            return false;
+        }
+
+        ++it;
+
+        if (inheriting && !type()) {
+            return false;
+        }
+
+        special = true;
+    } else if (c == 'D' && (peek(1) == '0' || peek(1) == '1' || peek(1) == '2' || peek(1) == '4' || peek(1) == '5')) {
+        it += 2;
+        special = true;
+    } else if (c == 'U' && peek(1) == 't') {
+        //Unnamed type
+        it += 2;
+
+        if (isdigit(peek()) && !number()) {
+            return false;
+        }
+
+        if (!consume('_')) {
+            return false;
+        }
+    } else if (c == 'U' && peek(1) == 'l') {
+        //Closure type, the parameters of the lambda until E
+        it += 2;
+
+        while (peek() != 'E') {
+            if (!type()) {
+                return false;
+            }
+        }
+
+        ++it;
+
+        if (isdigit(peek()) && !number()) {
+            return false;
+        }
+
+        if (!consume('_')) {
+            return false;
+        }
+    } else if (c == 'c' && peek(1) == 'v') {
+        //Conversion operator
+        it += 2;
+
+        if (!type()) {
+            return false;
+        }
+
+        special = true;
+    } else if (c == 'l' && peek(1) == 'i') {
+        //Literal operator
+        it += 2;
+
+        if (!sourceName()) {
+            return false;
+        }
+    } else if (c == 'v' && isdigit(peek(1))) {
+        //Vendor extended operator
+        it += 2;
+
+        if (!sourceName()) {
+            return false;
+        }
+    } else if (islower(c) && isalpha(peek(1))) {
+        //Operator
+        it += 2;
+    } else {
+        return false;
+    }
+
+    //ABI tags
+    while (consume('B')) {
+        if (!sourceName()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//N [<CV-qualifiers>] [<ref-qualifier>] <prefix> <unqualified-name> E
+bool ManglingWalker::nestedName(bool& templated, bool& special) {
+    if (!consume('N')) {
+        return false;
+    }
+
+    while (consume('r') || consume('V') || consume('K')) {}
+
+    if (!consume('R')) {
+        consume('O');
+    }
+
+    templated = false;
+    special = false;
+
+    while (!consume('E')) {
+        char c = peek();
+
+        if (c == 'I') {
+            if (!templateArgs()) {
+                return false;
+            }
+
+            templated = true;
+        } else if (c == 'S' && peek(1) == 't') {
+            it += 2;
+            templated = false;
+        } else if (c == 'S') {
+            if (!substitution()) {
+                return false;
+            }
+
+            templated = false;
+        } else if (c == 'T') {
+            if (!templateParameter()) {
+                return false;
+            }
+
+            templated = false;
+        } else if (c == 'M') {
+            //Closure in the initializer of a data member
+            ++it;
+        } else if (c == '\0' || (c == 'D' && (peek(1) == 't' || peek(1) == 'T'))) {
+            return false;
+        } else {
+            if (!unqualifiedName(special)) {
+                return false;
+            }
+
+            templated = false;
+        }
+    }
+
+    return true;
+}
+
+//Z <function encoding> E <entity name> [<discriminator>] or Z <function encoding> E s [<discriminator>]
+bool ManglingWalker::localName(bool& templated, bool& special) {
+    if (!consume('Z')) {
+        return false;
+    }
+
+    int parameters = 0;
+    if (!encoding(parameters) || !consume('E')) {
+        return false;
+    }
+
+    templated = false;
+    special = false;
+
+    if (consume('s')) {
+        //String literal
+    } else {
+        //Default argument
+        if (consume('d')) {
+            if (isdigit(peek()) && !number()) {
+                return false;
+            }
+
+            if (!consume('_')) {
+                return false;
+            }
+        }
+
+        if (!name(templated, special)) {
+            return false;
+        }
+    }
+
+    //Discriminator _ <digit> or __ <number> _
+    if (peek() == '_' && peek(1) == '_') {
+        it += 2;
+        return number() && consume('_');
+    }
+
+    if (peek() == '_' && isdigit(peek(1))) {
+        it += 2;
+    }
+
+    return true;
+}
+
+bool ManglingWalker::name(bool& templated, bool& special) {
+    templated = false;
+    special = false;
+
+    char c = peek();
+
+    if (c == 'N') {
+        return nestedName(templated, special);
+    }
+
+    if (c == 'Z') {
+        return localName(templated, special);
+    }
+
+    if (c == 'S' && peek(1) == 't') {
+        it += 2;
+
+        if (!unqualifiedName(special)) {
+            return false;
+        }
+    } else if (c == 'S') {
+        //A substitution is only a name when it is followed by template arguments
+        if (!substitution() || peek() != 'I') {
+            return false;
+        }
+    } else if (!unqualifiedName(special)) {
+        return false;
+    }
+
+    if (peek() == 'I') {
+        if (!templateArgs()) {
+            return false;
+        }
+
+        templated = true;
+    }
+
+    return true;
+}
+
+//I <template-arg>+ E
+bool ManglingWalker::templateArgs() {
+    if (depth == 0) {
+        lastArgs = it;
+    }
+
+    if (!consume('I')) {
+        return false;
+    }
+
+    ++depth;
+
+    while (!consume('E')) {
+        if (!templateArg()) {
+            return false;
+        }
+
+        ++arguments;
+    }
+
+    --depth;
+
+    return true;
+}
+
+//The number of arguments of the argument pack at the given index of the template arguments at the current position
+int ManglingWalker::packSize(int index) {
+    if (!consume('I')) {
+        return -1;
+    }
+
+    ++depth;
+
+    for (int i = 0; !consume('E'); ++i) {
+        if (i == index) {
+            if (!consume('J')) {
+                return -1;
+            }
+
+            int size = 0;
+            while (!consume('E')) {
+                if (!templateArg()) {
+                    return -1;
+                }
+
+                ++size;
+            }
+
+            return size;
+        }
+
+        if (!templateArg()) {
+            return -1;
+        }
+    }
+
+    return -1;
+}
+
+bool ManglingWalker::templateArg() {
+    char c = peek();
+
+    if (c == 'L') {
+        ++it;
+
+        //External name
+        if (peek() == 'Z' || (peek() == '_' && peek(1) == 'Z')) {
+            consume('_');
+            ++it;
+
+            int parameters = 0;
+            return encoding(parameters) && consume('E');
+        }
+
+        //Literal, the type and then the value
+        if (!type()) {
+            return false;
+        }
+
+        while (it < end && *it != 'E') {
+            ++it;
+        }
+
+        return consume('E');
+    }
+
+    if (c == 'J') {
+        //Argument pack
+        ++it;
+
+        while (!consume('E')) {
+            if (!templateArg()) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //The expressions are not supported
+    if (c == 'X') {
+        return false;
+    }
+
+    return type();
+}
+
+//F [Y] <return type> <parameter types> [<ref-qualifier>] E
+bool ManglingWalker::functionType() {
+    if (!consume('F')) {
+        return false;
+    }
+
+    consume('Y');
+
+    while (!consume('E')) {
+        if ((peek() == 'R' || peek() == 'O') && peek(1) == 'E') {
+            ++it;
+            continue;
+        }
+
+        if (!type()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ManglingWalker::type() {
+    char c = peek();
+
+    switch (c) {
+        //Builtin types
+        case 'v': case 'w': case 'b': case 'c': case 'a': case 'h': case 's': case 't': case 'i': case 'j': case 'l':
+        case 'm': case 'x': case 'y': case 'n': case 'o': case 'f': case 'd': case 'e': case 'g': case 'z':
+            ++it;
+            return true;
+
+        //Vendor extended type
+        case 'u':
+            ++it;
+            return sourceName() && (peek() != 'I' || templateArgs());
+
+        //Qualifiers
+        case 'r': case 'V': case 'K':
+        case 'P': case 'R': case 'O': case 'C': case 'G':
+            ++it;
+            return type();
+
+        case 'F':
+            return functionType();
+
+        //Array A <number> _ <type> or A _ <type>
+        case 'A':
+            ++it;
+
+            if (isdigit(peek()) && !number()) {
+                return false;
+            }
+
+            return consume('_') && type();
+
+        //Pointer to member M <class type> <member type>
+        case 'M':
+            ++it;
+            return type() && type();
+
+        case 'T':
+            //Elaborated type specifiers
+            if (peek(1) == 's' || peek(1) == 'u' || peek(1) == 'e') {
+                it += 2;
+
+                bool templated;
+                bool special;
+                return name(templated, special);
+            }
+
+            //Template parameter, possibly a template template parameter
+            return templateParameter() && (peek() != 'I' || templateArgs());
+
+        case 'S':
+            if (peek(1) == 't') {
+                it += 2;
+
+                bool special;
+                if (!unqualifiedName(special)) {
+                    return false;
+                }
+            } else if (!substitution()) {
+                return false;
+            }
+
+            return peek() != 'I' || templateArgs();
+
+        case 'N': {
+            bool templated;
+            bool special;
+            return nestedName(templated, special);
+        }
+
+        case 'Z': {
+            bool templated;
+            bool special;
+            return localName(templated, special);
+        }
+
+        case 'D':
+            switch (peek(1)) {
+                //decltype(auto), std::nullptr_t, char8_t, char16_t, char32_t, decimal and half floats, auto
+                case 'a': case 'c': case 'n': case 'u': case 's': case 'i': case 'h': case 'f': case 'd': case 'e':
+                    it += 2;
+                    return true;
+
+                //Pack expansion
+                case 'p':
+                    it += 2;
+                    return type();
+
+                //Vector type Dv <number> _ <type>
+                case 'v':
+                    it += 2;
+                    return number() && consume('_') && type();
+
+                //_FloatN DF <number> _ or DF <number> x
+                case 'F':
+                    it += 2;
+                    return number() && (consume('_') || consume('x') || consume('b'));
+
+                //Transaction safe function type
+                case 'x':
+                    it += 2;
+                    return type();
+
+                default:
+                    return false;
+            }
+
+        case 'U':
+            //Unnamed and closure types are names, the other are vendor qualifiers U <source-name> [<template-args>] <type>
+            if (peek(1) == 't' || peek(1) == 'l') {
+                bool templated;
+                bool special;
+                return name(templated, special);
+            }
+
+            ++it;
+            return sourceName() && (peek() != 'I' || templateArgs()) && type();
+
+        default:
+            //Unscoped class names
+            if (isdigit(c) || c == 'L') {
+                bool templated;
+                bool special;
+                return name(templated, special);
+            }
+
+            return false;
+    }
+}
+
+//<name> <bare-function-type> or <name> for the data or <special-name>
+bool ManglingWalker::encoding(int& parameters) {
+    parameters = 0;
+
+    //Special names
+    if (peek() == 'T') {
+        char c = peek(1);
+
+        //Virtual table, VTT, typeinfo and typeinfo name
+        if (c == 'V' || c == 'T' || c == 'I' || c == 'S') {
+            it += 2;
+            return type();
+        }
+
+        //TLS init and wrapper functions
+        if (c == 'H' || c == 'W') {
+            it += 2;
+
+            bool templated;
+            bool special;
+            return name(templated, special);
+        }
+
+        //Thunks
+        if (c == 'h' || c == 'v') {
+            ++it;
+            return callOffset() && encoding(parameters);
+        }
+
+        if (c == 'c') {
+            it += 2;
+            return callOffset() && callOffset() && encoding(parameters);
+        }
+
+        return false;
+    }
+
+    if (peek() == 'G') {
+        char c = peek(1);
+
+        //Guard variable
+        if (c == 'V') {
+            it += 2;
+
+            bool templated;
+            bool special;
+            return name(templated, special);
+        }
+
+        //Reference temporary
+        if (c == 'R') {
+            it += 2;
+
+            bool templated;
+            bool special;
+            return name(templated, special) && sequenceId();
+        }
+
+        //Transaction clone
+        if (c == 'T' && (peek(2) == 'n' || peek(2) == 't')) {
+            it += 3;
+            return encoding(parameters);
+        }
+
+        return false;
+    }
+
+    bool templated;
+    bool special;
+    if (!name(templated, special)) {
+        return false;
+    }
+
+    const char* args = lastArgs;
+
+    //A data
+    if (atEnd() || peek() == 'E') {
+        return true;
+    }
+
+    //The template functions are followed by their return type
+    if (templated && !special && !type()) {
+        return false;
+    }
+
+    //A single void is a function without parameters
+    int types = 0;
+    bool single = peek() == 'v';
+
+    while (!atEnd() && peek() != 'E') {
+        //A pack expansion is replaced by the arguments of the pack it expands
+        if (peek() == 'D' && peek(1) == 'p') {
+            it += 2;
+            firstParameter = -1;
+
+            if (!type() || firstParameter < 0 || !args) {
+                return false;
+            }
+
+            ManglingWalker pack(args, end);
+            int size = pack.packSize(firstParameter);
+
+            if (size < 0) {
+                return false;
+            }
+
+            types += size;
+            continue;
+        }
+
+        if (!type()) {
+            return false;
+        }
+
+        ++types;
+    }
+
+    parameters = types == 1 && single ? 0 : types;
+
+    return true;
+}
+
+} //end of anonymous namespace
+
+int inlining::countMangledParameters(const StringRef& name) {
+    if (name.size() < 2 || name.begin[0] != '_' || name.begin[1] != 'Z') {
+        return 0;
+    }
+
+    ManglingWalker walker(name.begin + 2, name.end);
+
+    int parameters = 0;
+    if (!walker.encoding(parameters) || !walker.atEnd()) {
+        return -1;
+    }
+
+    return parameters;
+}
@@ -0,0 +1,140 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "MappedFile.hpp"
+#include "Decompressor.hpp"
+#include "Logging.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace inlining;
+
+MappedFile::MappedFile(const std::string& file) : data(NULL), length(0), opened(false) {
+    if (file == "-") {
+        opened = load(0, file);
+        return;
+    }
+
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ERROR cout << "ERROR : open " << file << " failed" << endl;
+        return;
+    }
+
+    struct stat infos;
+    if (fstat(fd, &infos) < 0) {
+        ERROR cout << "ERROR : stat " << file << " failed" << endl;
+        close(fd);
+        return;
+    }
+
+    length = infos.st_size;
+
+    //An empty file cannot be mapped but is still a valid file
+    if (length > 0) {
+        void* address = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (address == MAP_FAILED) {
+            ERROR cout << "ERROR : mmap " << file << " failed" << endl;
+            close(fd);
+            length = 0;
+            return;
+        }
+
+        //The file is read from the beginning to the end
+        madvise(address, length, MADV_SEQUENTIAL);
+
+        data = static_cast<const char*>(address);
+    }
+
+    if (detectCompression(data, length) != NO_COMPRESSION) {
+        munmap(const_cast<char*>(data), length);
+
+        data = NULL;
+        length = 0;
+
+        //The file has been read to detect the compression
+        lseek(fd, 0, SEEK_SET);
+
+        opened = load(fd, file);
+    } else {
+        opened = true;
+    }
+
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data && content.empty()) {
+        munmap(const_cast<char*>(data), length);
+    }
+}
+
+bool MappedFile::load(int fd, const std::string& file) {
+    std::vector<char> buffer(1 << 18);
+
+    Decompressor decompressor;
+    size_t buffered = 0;
+    bool started = false;
+
+    while (true) {
+        ssize_t count = ::read(fd, &buffer[buffered], buffer.size() - buffered);
+
+        if (count < 0) {
+            ERROR cout << "ERROR : read " << file << " failed" << endl;
+            return false;
+        }
+
+        buffered += count;
+
+        //The compression is detected from the first bytes
+        if (!started && (buffered >= 4 || count == 0)) {
+            if (!decompressor.start(&buffer[0], buffered)) {
+                return false;
+            }
+
+            started = true;
+        }
+
+        if (started && buffered > 0) {
+            if (!decompressor.feed(&buffer[0], buffered, content)) {
+                return false;
+            }
+
+            buffered = 0;
+        }
+
+        if (count == 0) {
+            break;
+        }
+    }
+
+    data = content.data();
+    length = content.size();
+
+    return true;
+}
@@ -0,0 +1,668 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "PerfReader.hpp"
+#include "CallGraph.hpp"
+#include "MappedFile.hpp"
+#include "Infos.hpp"
+#include "Logging.hpp"
+#include "Timer.hpp"
+#include "GraphBuilder.hpp"
+
+using namespace std;
+using namespace inlining;
+
+//The layout of perf.data (see tools/perf/util/header.h and include/uapi/linux/perf_event.h of Linux)
+
+static const uint64_t PERF_MAGIC = 0x32454c4946524550ULL;      //PERFILE2
+
+static const uint32_t PERF_RECORD_MMAP = 1;
+static const uint32_t PERF_RECORD_COMM = 3;
+static const uint32_t PERF_RECORD_FORK = 7;
+static const uint32_t PERF_RECORD_SAMPLE = 9;
+static const uint32_t PERF_RECORD_MMAP2 = 10;
+
+static const uint16_t PERF_RECORD_MISC_COMM_EXEC = 1 << 13;
+
+static const uint64_t PERF_SAMPLE_IP = 1 << 0;
+static const uint64_t PERF_SAMPLE_TID = 1 << 1;
+static const uint64_t PERF_SAMPLE_TIME = 1 << 2;
+static const uint64_t PERF_SAMPLE_ADDR = 1 << 3;
+static const uint64_t PERF_SAMPLE_READ = 1 << 4;
+static const uint64_t PERF_SAMPLE_CALLCHAIN = 1 << 5;
+static const uint64_t PERF_SAMPLE_ID = 1 << 6;
+static const uint64_t PERF_SAMPLE_CPU = 1 << 7;
+static const uint64_t PERF_SAMPLE_PERIOD = 1 << 8;
+static const uint64_t PERF_SAMPLE_STREAM_ID = 1 << 9;
+static const uint64_t PERF_SAMPLE_IDENTIFIER = 1 << 16;
+
+static const uint64_t PERF_FORMAT_TOTAL_TIME_ENABLED = 1 << 0;
+static const uint64_t PERF_FORMAT_TOTAL_TIME_RUNNING = 1 << 1;
+static const uint64_t PERF_FORMAT_ID = 1 << 2;
+static const uint64_t PERF_FORMAT_GROUP = 1 << 3;
+static const uint64_t PERF_FORMAT_LOST = 1 << 4;
+
+//The callchains contain markers of the context (kernel, user, ...) above this value
+static const uint64_t PERF_CONTEXT_MAX = static_cast<uint64_t>(-4095);
+
+static const uint32_t KERNEL_PID = static_cast<uint32_t>(-1);
+static const uint32_t UNKNOWN_SYMBOL = static_cast<uint32_t>(-1);
+
+namespace {
+
+struct PerfFileSection {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct PerfFileHeader {
+    uint64_t magic;
+    uint64_t size;
+    uint64_t attrSize;
+    PerfFileSection attrs;
+    PerfFileSection data;
+    PerfFileSection eventTypes;
+    uint64_t features[4];
+};
+
+struct PerfEventHeader {
+    uint32_t type;
+    uint16_t misc;
+    uint16_t size;
+};
+
+struct PerfModule {
+    string name;
+    const SymbolTable* symbols;     //NULL if the module has no symbols
+    bool relative;                  //The symbols of a shared object are relative to the file
+
+    PerfModule(const string& n) : name(n), symbols(NULL), relative(true) {}
+};
+
+struct PerfMapping {
+    uint64_t end;
+    uint64_t offset;
+    unsigned int module;
+};
+
+//The mappings of a process, by start address
+typedef map<uint64_t, PerfMapping> AddressSpace;
+
+/*!
+ * \brief The result of the first pass: the modules, the mappings and the batches of samples.
+ */
+struct PerfLayout {
+    vector<PerfModule> modules;
+    unordered_map<string, unsigned int> moduleIndex;
+    unordered_map<uint32_t, AddressSpace> processes;
+    vector<pair<const char*, const char*>> batches;
+
+    uint64_t sampleType;
+    uint64_t readFormat;
+};
+
+struct PerfNode {
+    double selfPeriod;
+    double inclusivePeriod;
+    double samples;
+    size_t lastStack;
+
+    PerfNode() : selfPeriod(0.0), inclusivePeriod(0.0), samples(0.0), lastStack(0) {}
+};
+
+struct PerfEdge {
+    double period;
+    double samples;
+    size_t lastStack;
+
+    PerfEdge() : period(0.0), samples(0.0), lastStack(0) {}
+};
+
+struct PerfEdgeHash {
+    size_t operator()(const pair<uint64_t, uint64_t>& edge) const {
+        return std::hash<uint64_t>()(edge.first * 0x9E3779B97F4A7C15ULL ^ edge.second);
+    }
+};
+
+typedef unordered_map<uint64_t, PerfNode> NodeMap;
+typedef unordered_map<pair<uint64_t, uint64_t>, PerfEdge, PerfEdgeHash> EdgeMap;
+
+/*!
+ * \brief The samples accumulated by a thread. A function is identified by (module << 32) | symbol.
+ */
+struct PerfPartial {
+    NodeMap nodes;
+    EdgeMap edges;
+    double period;
+
+    vector<uint64_t> stack;
+    size_t stacks;
+
+    PerfPartial() : period(0.0), stacks(0) {}
+};
+
+} //end of anonymous namespace
+
+static unsigned int getModule(PerfLayout& layout, Infos& infos, const char* name, const char* end) {
+    string file(name, std::find(name, end, '\0'));
+
+    auto result = layout.moduleIndex.insert(make_pair(file, static_cast<unsigned int>(layout.modules.size())));
+
+    if (result.second) {
+        PerfModule module(file);
+
+        //The pseudo files ([kernel.kallsyms], [vdso], //anon, ...) have no symbols
+        if (!file.empty() && file[0] == '/' && file.compare(0, 6, "//anon") != 0) {
+            module.symbols = &infos.symbolsOf(file);
+            module.relative = !infos.isExecutable(file);
+        }
+
+        layout.modules.push_back(module);
+    }
+
+    return result.first->second;
+}
+
+static void addMapping(AddressSpace& space, uint64_t start, uint64_t length, uint64_t offset, unsigned int module) {
+    uint64_t end = start + length;
+
+    //A new mapping replaces the mappings it overlaps
+    auto it = space.lower_bound(start);
+
+    if (it != space.begin()) {
+        auto previous = it;
+        --previous;
+
+        if (previous->second.end > start) {
+            previous->second.end = start;
+        }
+    }
+
+    while (it != space.end() && it->first < end) {
+        it = space.erase(it);
+    }
+
+    PerfMapping mapping;
+    mapping.end = end;
+    mapping.offset = offset;
+    mapping.module = module;
+
+    space[start] = mapping;
+}
+
+template<typename T>
+static inline T load(const char* data) {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+//First pass : the mappings of the processes and the batches of samples
+static bool readLayout(const char* begin, const char* end, PerfLayout& layout, Infos& infos, size_t batchSize) {
+    const char* batch = NULL;
+    size_t samples = 0;
+
+    const char* it = begin;
+    while (it < end) {
+        if (end - it < static_cast<ptrdiff_t>(sizeof(PerfEventHeader))) {
+            return false;
+        }
+
+        PerfEventHeader header = load<PerfEventHeader>(it);
+
+        if (header.size < sizeof(PerfEventHeader) || end - it < header.size) {
+            return false;
+        }
+
+        const char* record = it + sizeof(PerfEventHeader);
+        const char* next = it + header.size;
+
+        if (header.type == PERF_RECORD_SAMPLE) {
+            if (!batch) {
+                batch = it;
+            }
+
+            if (++samples % batchSize == 0) {
+                layout.batches.push_back(make_pair(batch, next));
+                batch = NULL;
+            }
+        } else if (header.type == PERF_RECORD_MMAP || header.type == PERF_RECORD_MMAP2) {
+            //pid, tid, address, length and offset, then the device and the protection of MMAP2
+            size_t name = header.type == PERF_RECORD_MMAP ? 32 : 64;
+
+            if (record + name > next) {
+                return false;
+            }
+
+            uint32_t pid = load<uint32_t>(record);
+            unsigned int module = getModule(layout, infos, record + name, next);
+
+            addMapping(layout.processes[pid], load<uint64_t>(record + 8), load<uint64_t>(record + 16), load<uint64_t>(record + 24), module);
+        } else if (header.type == PERF_RECORD_FORK) {
+            if (record + 8 > next) {
+                return false;
+            }
+
+            uint32_t pid = load<uint32_t>(record);
+            uint32_t parent = load<uint32_t>(record + 4);
+
+            //A new process inherits the mappings of its parent, a new thread shares them
+            if (pid != parent) {
+                layout.processes[pid] = layout.processes[parent];
+            }
+        } else if (header.type == PERF_RECORD_COMM && (header.misc & PERF_RECORD_MISC_COMM_EXEC)) {
+            if (record + 4 > next) {
+                return false;
+            }
+
+            layout.processes[load<uint32_t>(record)].clear();
+        }
+
+        //The other records (exit, lost, throttle, the records of perf itself, ...) are not useful
+
+        it = next;
+    }
+
+    if (batch) {
+        layout.batches.push_back(make_pair(batch, end));
+    }
+
+    return true;
+}
+
+//Return the function of the address, (module << 32) | symbol
+static uint64_t resolve(const PerfLayout& layout, const AddressSpace* process, const AddressSpace* kernel, uint64_t address) {
+    const AddressSpace* spaces[] = {process, kernel};
+
+    for (auto space : spaces) {
+        if (!space) {
+            continue;
+        }
+
+        auto it = space->upper_bound(address);
+
+        if (it == space->begin()) {
+            continue;
+        }
+
+        --it;
+
+        if (address >= it->second.end) {
+            continue;
+        }
+
+        const PerfModule& module = layout.modules[it->second.module];
+        uint64_t key = static_cast<uint64_t>(it->second.module) << 32;
+
+        if (module.symbols) {
+            uint64_t relative = module.relative ? address - it->first + it->second.offset : address;
+
+            const FunctionSymbol* symbol = findFunction(*module.symbols, relative);
+
+            if (symbol) {
+                return key | static_cast<uint64_t>(symbol - &(*module.symbols)[0]);
+            }
+        }
+
+        return key | UNKNOWN_SYMBOL;
+    }
+
+    //Module 0 is the unknown module
+    return UNKNOWN_SYMBOL;
+}
+
+static bool skipRead(const char*& it, const char* end, uint64_t readFormat) {
+    size_t values = 1;
+
+    if (readFormat & PERF_FORMAT_GROUP) {
+        if (end - it < 8) {
+            return false;
+        }
+
+        values = load<uint64_t>(it);
+        it += 8;
+    }
+
+    size_t header = ((readFormat & PERF_FORMAT_TOTAL_TIME_ENABLED) ? 8 : 0) + ((readFormat & PERF_FORMAT_TOTAL_TIME_RUNNING) ? 8 : 0);
+    size_t value = 8 + ((readFormat & PERF_FORMAT_ID) ? 8 : 0) + ((readFormat & PERF_FORMAT_LOST) ? 8 : 0);
+
+    //Without group, the times are between the value and its id
+    size_t size = header + values * value;
+
+    if (static_cast<size_t>(end - it) < size) {
+        return false;
+    }
+
+    it += size;
+
+    return true;
+}
+
+static void addStack(PerfPartial& partial, double period) {
+    vector<uint64_t>& stack = partial.stack;
+
+    if (stack.empty()) {
+        return;
+    }
+
+    //Each stack has its own stamp to count the recursive functions and call sites only once
+    size_t stamp = ++partial.stacks;
+
+    partial.nodes[stack[0]].selfPeriod += period;
+
+    for (size_t i = 0; i < stack.size(); ++i) {
+        PerfNode& node = partial.nodes[stack[i]];
+
+        if (node.lastStack != stamp) {
+            node.lastStack = stamp;
+            node.inclusivePeriod += period;
+            node.samples += 1.0;
+        }
+
+        //The callchain goes from the leaf to the root
+        if (i > 0) {
+            PerfEdge& edge = partial.edges[make_pair(stack[i], stack[i - 1])];
+
+            if (edge.lastStack != stamp) {
+                edge.lastStack = stamp;
+                edge.period += period;
+                edge.samples += 1.0;
+            }
+        }
+    }
+}
+
+//Second pass : symbolize and accumulate the samples of a batch
+static bool readSamples(const PerfLayout& layout, const char* begin, const char* end, PerfPartial& partial) {
+    uint64_t type = layout.sampleType;
+
+    auto kernel = layout.processes.find(KERNEL_PID);
+    const AddressSpace* kernelSpace = kernel == layout.processes.end() ? NULL : &kernel->second;
+
+    const char* it = begin;
+    while (it < end) {
+        PerfEventHeader header = load<PerfEventHeader>(it);
+        const char* next = it + header.size;
+
+        if (header.type != PERF_RECORD_SAMPLE) {
+            it = next;
+            continue;
+        }
+
+        const char* field = it + sizeof(PerfEventHeader);
+
+        //The fields before the callchain, in the order of the record
+        uint64_t ip = 0;
+        uint32_t pid = KERNEL_PID;
+        uint64_t period = 1;
+
+        size_t fixed = ((type & PERF_SAMPLE_IDENTIFIER) ? 8 : 0) + ((type & PERF_SAMPLE_IP) ? 8 : 0) + ((type & PERF_SAMPLE_TID) ? 8 : 0)
+            + ((type & PERF_SAMPLE_TIME) ? 8 : 0) + ((type & PERF_SAMPLE_ADDR) ? 8 : 0) + ((type & PERF_SAMPLE_ID) ? 8 : 0)
+            + ((type & PERF_SAMPLE_STREAM_ID) ? 8 : 0) + ((type & PERF_SAMPLE_CPU) ? 8 : 0) + ((type & PERF_SAMPLE_PERIOD) ? 8 : 0);
+
+        if (static_cast<size_t>(next - field) < fixed) {
+            return false;
+        }
+
+        if (type & PERF_SAMPLE_IDENTIFIER) {
+            field += 8;
+        }
+
+        if (type & PERF_SAMPLE_IP) {
+            ip = load<uint64_t>(field);
+            field += 8;
+        }
+
+        if (type & PERF_SAMPLE_TID) {
+            pid = load<uint32_t>(field);
+            field += 8;
+        }
+
+        field += ((type & PERF_SAMPLE_TIME) ? 8 : 0) + ((type & PERF_SAMPLE_ADDR) ? 8 : 0) + ((type & PERF_SAMPLE_ID) ? 8 : 0)
+            + ((type & PERF_SAMPLE_STREAM_ID) ? 8 : 0) + ((type & PERF_SAMPLE_CPU) ? 8 : 0);
+
+        if (type & PERF_SAMPLE_PERIOD) {
+            period = load<uint64_t>(field);
+            field += 8;
+        }
+
+        if ((type & PERF_SAMPLE_READ) && !skipRead(field, next, layout.readFormat)) {
+            return false;
+        }
+
+        auto process = layout.processes.find(pid);
+        const AddressSpace* processSpace = process == layout.processes.end() ? NULL : &process->second;
+
+        partial.stack.clear();
+
+        if (type & PERF_SAMPLE_CALLCHAIN) {
+            if (next - field < 8) {
+                return false;
+            }
+
+            uint64_t frames = load<uint64_t>(field);
+            field += 8;
+
+            if (static_cast<uint64_t>(next - field) / 8 < frames) {
+                return false;
+            }
+
+            for (uint64_t i = 0; i < frames; ++i) {
+                uint64_t address = load<uint64_t>(field + i * 8);
+
+                if (address >= PERF_CONTEXT_MAX) {
+                    continue;
+                }
+
+                //The return addresses are after the call instruction, which can be the last one of the function
+                if (!partial.stack.empty()) {
+                    --address;
+                }
+
+                partial.stack.push_back(resolve(layout, processSpace, kernelSpace, address));
+            }
+        } else if (type & PERF_SAMPLE_IP) {
+            partial.stack.push_back(resolve(layout, processSpace, kernelSpace, ip));
+        }
+
+        partial.period += period;
+
+        addStack(partial, period);
+
+        it = next;
+    }
+
+    return true;
+}
+
+CallGraph* PerfReader::read(const string& file) {
+    DEBUG cout << "DEBUG : Importing the perf file " << file << endl;
+
+    Timer timer;
+
+    MappedFile mapped(file);
+    if (!mapped.isOpen()) {
+        ERROR cout << "ERROR : Unable to open " << file << endl;
+        return NULL;
+    }
+
+    if (mapped.size() < sizeof(PerfFileHeader) || load<uint64_t>(mapped.begin()) != PERF_MAGIC) {
+        ERROR cout << "ERROR : " << file << " is not a perf.data file (the pipe mode is not supported)" << endl;
+        return NULL;
+    }
+
+    PerfFileHeader header = load<PerfFileHeader>(mapped.begin());
+
+    if (header.attrs.offset + header.attrs.size > mapped.size() || header.data.offset + header.data.size > mapped.size() || header.attrSize < 40) {
+        ERROR cout << "ERROR : " << file << " is truncated or corrupted" << endl;
+        return NULL;
+    }
+
+    PerfLayout layout;
+
+    //The layout of the samples is given by the attributes of the events
+    size_t events = header.attrs.size / header.attrSize;
+    for (size_t i = 0; i < events; ++i) {
+        const char* attr = mapped.begin() + header.attrs.offset + i * header.attrSize;
+
+        uint64_t sampleType = load<uint64_t>(attr + 24);
+        uint64_t readFormat = load<uint64_t>(attr + 32);
+
+        if (i > 0 && (sampleType != layout.sampleType || readFormat != layout.readFormat)) {
+            ERROR cout << "ERROR : The events of " << file << " have different sample types, record a single event" << endl;
+            return NULL;
+        }
+
+        layout.sampleType = sampleType;
+        layout.readFormat = readFormat;
+    }
+
+    if (events == 0) {
+        ERROR cout << "ERROR : " << file << " does not contain any event" << endl;
+        return NULL;
+    }
+
+    //The addresses outside of every mapping
+    layout.modules.push_back(PerfModule("[unknown]"));
+    layout.moduleIndex["[unknown]"] = 0;
+
+    const char* data = mapped.begin() + header.data.offset;
+
+    if (!readLayout(data, data + header.data.size, layout, infos, batchSize)) {
+        ERROR cout << "ERROR : " << file << " is truncated or corrupted" << endl;
+        return NULL;
+    }
+
+    PERF cout << "PERF : Mappings read in " << timer.elapsed() << "ms" << endl;
+
+    vector<PerfPartial> partials(threads);
+    vector<char> failed(layout.batches.size(), 0);
+
+    parallelForWorker(layout.batches.size(), threads, [&](unsigned int worker, size_t batch){
+        failed[batch] = !readSamples(layout, layout.batches[batch].first, layout.batches[batch].second, partials[worker]);
+    });
+
+    if (std::find(failed.begin(), failed.end(), 1) != failed.end()) {
+        ERROR cout << "ERROR : " << file << " contains invalid samples" << endl;
+        return NULL;
+    }
+
+    //Reduce the partials in the first one
+    PerfPartial& total = partials[0];
+    for (size_t i = 1; i < partials.size(); ++i) {
+        for (auto& node : partials[i].nodes) {
+            PerfNode& reduced = total.nodes[node.first];
+            reduced.selfPeriod += node.second.selfPeriod;
+            reduced.inclusivePeriod += node.second.inclusivePeriod;
+            reduced.samples += node.second.samples;
+        }
+
+        for (auto& edge : partials[i].edges) {
+            PerfEdge& reduced = total.edges[edge.first];
+            reduced.period += edge.second.period;
+            reduced.samples += edge.second.samples;
+        }
+
+        total.period += partials[i].period;
+
+        //Release the memory as soon as possible
+        NodeMap().swap(partials[i].nodes);
+        EdgeMap().swap(partials[i].edges);
+    }
+
+    auto nameOf = [&layout](uint64_t key) -> const string& {
+        static const string unknown = "[unknown]";
+
+        const PerfModule& module = layout.modules[key >> 32];
+        uint32_t symbol = key & 0xFFFFFFFF;
+
+        return symbol == UNKNOWN_SYMBOL ? unknown : (*module.symbols)[symbol].name;
+    };
+
+    //The vertices are sorted by module and by name to be independent of the threads
+    vector<uint64_t> keys;
+    keys.reserve(total.nodes.size());
+    for (auto& node : total.nodes) {
+        keys.push_back(node.first);
+    }
+
+    std::sort(keys.begin(), keys.end(), [&](uint64_t a, uint64_t b){
+        const string& moduleA = layout.modules[a >> 32].name;
+        const string& moduleB = layout.modules[b >> 32].name;
+
+        return moduleA != moduleB ? moduleA < moduleB : nameOf(a) < nameOf(b);
+    });
+
+    unordered_map<uint64_t, Function> functions;
+
+    double ratio = total.period > 0.0 ? 100.0 / total.period : 0.0;
+
+    Graph* graph = new Graph(keys.size());
+
+    for (unsigned int i = 0; i < keys.size(); ++i) {
+        const PerfNode& node = total.nodes[keys[i]];
+        vertex_info& info = (*graph)[vertex(i, *graph)];
+
+        info.name = arenaOf(*graph).store(nameOf(keys[i]));
+        info.module = stringsOf(*graph).intern(layout.modules[keys[i] >> 32].name);
+        info.self_cost = node.selfPeriod * ratio;
+        info.inclusive_cost = node.inclusivePeriod * ratio;
+        info.calls = toCalls(node.samples);
+
+        functions[keys[i]] = i;
+    }
+
+    vector<pair<pair<uint64_t, uint64_t>, const PerfEdge*>> edges;
+    edges.reserve(total.edges.size());
+    for (auto& edge : total.edges) {
+        edges.push_back(make_pair(make_pair(functions[edge.first.first], functions[edge.first.second]), &edge.second));
+    }
+
+    std::sort(edges.begin(), edges.end(), [](const pair<pair<uint64_t, uint64_t>, const PerfEdge*>& a, const pair<pair<uint64_t, uint64_t>, const PerfEdge*>& b){ return a.first < b.first; });
+
+    GraphBuilder builder(threads, memoryCap);
+    builder.reserve(edges.size());
+
+    for (auto& edge : edges) {
+        builder.addCall(edge.first.first, edge.first.second, toCalls(edge.second->samples), edge.second->period * ratio);
+    }
+
+    CallGraph* callGraph = builder.build(graph);
+
+    DEBUG cout << "DEBUG : Number of edges : " << callGraph->numberOfCallSites() << endl;
+    DEBUG cout << "DEBUG : Number of vertices : " << num_vertices(*graph) << endl;
+    PERF cout << "PERF : Importation finished in " << timer.elapsed() << "ms" << endl;
+
+    Timer extraction;
+
+    completeGraph(*callGraph);
+
+    PERF cout << "PERF : Information extracted in " << extraction.elapsed() << "ms" << endl;
+
+    return callGraph;
+}
@@ -0,0 +1,668 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "PprofReader.hpp"
+#include "ProtoDecoder.hpp"
+#include "Decompressor.hpp"
+#include "CallGraph.hpp"
+#include "Infos.hpp"
+#include "Logging.hpp"
+#include "Timer.hpp"
+#include "GraphBuilder.hpp"
+
+using namespace std;
+using namespace inlining;
+
+//The fields of the messages of profile.proto
+static const uint32_t PROFILE_SAMPLE_TYPE = 1;
+static const uint32_t PROFILE_SAMPLE = 2;
+static const uint32_t PROFILE_MAPPING = 3;
+static const uint32_t PROFILE_LOCATION = 4;
+static const uint32_t PROFILE_FUNCTION = 5;
+static const uint32_t PROFILE_STRING_TABLE = 6;
+static const uint32_t PROFILE_DEFAULT_SAMPLE_TYPE = 14;
+
+static const unsigned int NO_INDEX = static_cast<unsigned int>(-1);
+
+namespace {
+
+/*!
+ * \brief Read the top-level fields of a possibly compressed protocol buffer from a file, without loading the file.
+ */
+class ProtoStream {
+    public:
+        explicit ProtoStream(size_t b) : fd(-1), blockSize(b), position(0), started(false), eof(false), error(false) {}
+
+        ~ProtoStream() {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        bool open(const string& file) {
+            fd = ::open(file.c_str(), O_RDONLY);
+            return fd >= 0;
+        }
+
+        //Read the next field, the bytes of a length-delimited field are valid until the next call
+        bool next(uint32_t& field, uint32_t& wire, uint64_t& value, StringRef& bytes) {
+            //The key and the length of a field are at most 20 bytes
+            fill(20);
+
+            if (error || position == buffer.size()) {
+                return false;
+            }
+
+            const char* begin = buffer.data() + position;
+            const char* it = begin;
+            const char* end = buffer.data() + buffer.size();
+
+            uint64_t key;
+            if (!decodeVarint(it, end, key) || (key >> 3) == 0) {
+                return fail();
+            }
+
+            field = key >> 3;
+            wire = key & 7;
+
+            size_t size = 0;
+            if (wire == WIRE_VARINT || wire == WIRE_LENGTH) {
+                if (!decodeVarint(it, end, value)) {
+                    return fail();
+                }
+
+                size = wire == WIRE_LENGTH ? value : 0;
+            } else if (wire == WIRE_FIXED64) {
+                size = 8;
+            } else if (wire == WIRE_FIXED32) {
+                size = 4;
+            } else {
+                return fail();
+            }
+
+            position += it - begin;
+
+            if (!fill(size)) {
+                return fail();
+            }
+
+            bytes = StringRef(buffer.data() + position, buffer.data() + position + size);
+            position += size;
+
+            return true;
+        }
+
+        bool failed() const {
+            return error;
+        }
+
+    private:
+        int fd;
+        size_t blockSize;
+
+        Decompressor decompressor;
+        vector<char> input;
+        string buffer;
+        size_t position;
+
+        bool started;
+        bool eof;
+        bool error;
+
+        bool fail() {
+            error = true;
+            return false;
+        }
+
+        //Make sure that size bytes are available after the position
+        bool fill(size_t size) {
+            if (buffer.size() - position >= size) {
+                return true;
+            }
+
+            buffer.erase(0, position);
+            position = 0;
+
+            input.resize(max<size_t>(blockSize, 4));
+
+            while (buffer.size() < size && !eof && !error) {
+                size_t buffered = 0;
+
+                //The compression is detected from the first bytes
+                while (buffered < 4) {
+                    ssize_t count = ::read(fd, &input[buffered], input.size() - buffered);
+
+                    if (count < 0) {
+                        ERROR cout << "ERROR : Unable to read the profile" << endl;
+                        return fail();
+                    }
+
+                    if (count == 0) {
+                        eof = true;
+                        break;
+                    }
+
+                    buffered += count;
+
+                    if (started) {
+                        break;
+                    }
+                }
+
+                if (!started) {
+                    if (!decompressor.start(&input[0], buffered)) {
+                        return fail();
+                    }
+
+                    started = true;
+                }
+
+                if (buffered > 0 && !decompressor.feed(&input[0], buffered, buffer)) {
+                    return fail();
+                }
+            }
+
+            return buffer.size() >= size;
+        }
+};
+
+struct PprofMapping {
+    uint64_t start;
+    uint64_t offset;
+    uint64_t fileName;
+};
+
+struct PprofLocation {
+    uint64_t mapping;
+    uint64_t address;
+    size_t firstLine;       //The functions of the location, the innermost first
+    size_t lines;
+};
+
+struct PprofFunction {
+    uint64_t name;
+    uint64_t systemName;
+};
+
+/*!
+ * \brief The metadata of the profile, read by the first pass.
+ */
+struct PprofProfile {
+    vector<string> strings;
+    vector<pair<uint64_t, uint64_t>> sampleTypes;
+    uint64_t defaultSampleType;
+
+    unordered_map<uint64_t, PprofMapping> mappings;
+    unordered_map<uint64_t, PprofFunction> functions;
+    unordered_map<uint64_t, PprofLocation> locations;
+    vector<uint64_t> lines;
+
+    PprofProfile() : defaultSampleType(0) {}
+
+    const string& text(uint64_t index) const {
+        static const string empty;
+        return index < strings.size() ? strings[index] : empty;
+    }
+};
+
+struct PprofCall {
+    double value;
+    double samples;
+    size_t lastStack;
+
+    PprofCall() : value(0.0), samples(0.0), lastStack(0) {}
+};
+
+} //end of anonymous namespace
+
+static bool readMapping(ProtoDecoder decoder, PprofProfile& profile) {
+    uint64_t id = 0;
+    PprofMapping mapping = {0, 0, 0};
+
+    uint32_t field, wire;
+    while (decoder.next(field, wire)) {
+        if (wire == WIRE_VARINT && field == 1) {
+            decoder.varint(id);
+        } else if (wire == WIRE_VARINT && field == 2) {
+            decoder.varint(mapping.start);
+        } else if (wire == WIRE_VARINT && field == 4) {
+            decoder.varint(mapping.offset);
+        } else if (wire == WIRE_VARINT && field == 5) {
+            decoder.varint(mapping.fileName);
+        } else {
+            decoder.skip(wire);
+        }
+    }
+
+    profile.mappings[id] = mapping;
+
+    return !decoder.failed();
+}
+
+static bool readLocation(ProtoDecoder decoder, PprofProfile& profile) {
+    uint64_t id = 0;
+    PprofLocation location = {0, 0, profile.lines.size(), 0};
+
+    uint32_t field, wire;
+    while (decoder.next(field, wire)) {
+        if (wire == WIRE_VARINT && field == 1) {
+            decoder.varint(id);
+        } else if (wire == WIRE_VARINT && field == 2) {
+            decoder.varint(location.mapping);
+        } else if (wire == WIRE_VARINT && field == 3) {
+            decoder.varint(location.address);
+        } else if (wire == WIRE_LENGTH && field == 4) {
+            StringRef line;
+            decoder.bytes(line);
+
+            ProtoDecoder lineDecoder(line);
+            uint64_t function = 0;
+
+            uint32_t lineField, lineWire;
+            while (lineDecoder.next(lineField, lineWire)) {
+                if (lineWire == WIRE_VARINT && lineField == 1) {
+                    lineDecoder.varint(function);
+                } else {
+                    lineDecoder.skip(lineWire);
+                }
+            }
+
+            if (lineDecoder.failed()) {
+                return false;
+            }
+
+            profile.lines.push_back(function);
+            ++location.lines;
+        } else {
+            decoder.skip(wire);
+        }
+    }
+
+    profile.locations[id] = location;
+
+    return !decoder.failed();
+}
+
+static bool readFunction(ProtoDecoder decoder, PprofProfile& profile) {
+    uint64_t id = 0;
+    PprofFunction function = {0, 0};
+
+    uint32_t field, wire;
+    while (decoder.next(field, wire)) {
+        if (wire == WIRE_VARINT && field == 1) {
+            decoder.varint(id);
+        } else if (wire == WIRE_VARINT && field == 2) {
+            decoder.varint(function.name);
+        } else if (wire == WIRE_VARINT && field == 3) {
+            decoder.varint(function.systemName);
+        } else {
+            decoder.skip(wire);
+        }
+    }
+
+    profile.functions[id] = function;
+
+    return !decoder.failed();
+}
+
+static bool readSampleType(ProtoDecoder decoder, PprofProfile& profile) {
+    uint64_t type = 0;
+    uint64_t unit = 0;
+
+    uint32_t field, wire;
+    while (decoder.next(field, wire)) {
+        if (wire == WIRE_VARINT && field == 1) {
+            decoder.varint(type);
+        } else if (wire == WIRE_VARINT && field == 2) {
+            decoder.varint(unit);
+        } else {
+            decoder.skip(wire);
+        }
+    }
+
+    profile.sampleTypes.push_back(make_pair(type, unit));
+
+    return !decoder.failed();
+}
+
+//First pass : everything but the samples
+static bool readProfile(ProtoStream& stream, PprofProfile& profile) {
+    uint32_t field, wire;
+    uint64_t value;
+    StringRef bytes;
+
+    while (stream.next(field, wire, value, bytes)) {
+        bool valid = true;
+
+        if (wire == WIRE_LENGTH) {
+            if (field == PROFILE_SAMPLE_TYPE) {
+                valid = readSampleType(ProtoDecoder(bytes), profile);
+            } else if (field == PROFILE_MAPPING) {
+                valid = readMapping(ProtoDecoder(bytes), profile);
+            } else if (field == PROFILE_LOCATION) {
+                valid = readLocation(ProtoDecoder(bytes), profile);
+            } else if (field == PROFILE_FUNCTION) {
+                valid = readFunction(ProtoDecoder(bytes), profile);
+            } else if (field == PROFILE_STRING_TABLE) {
+                profile.strings.push_back(bytes.str());
+            }
+        } else if (wire == WIRE_VARINT && field == PROFILE_DEFAULT_SAMPLE_TYPE) {
+            profile.defaultSampleType = value;
+        }
+
+        if (!valid) {
+            return false;
+        }
+    }
+
+    return !stream.failed();
+}
+
+//The name of the function of an address without line information
+static string symbolize(Infos& infos, const PprofProfile& profile, const PprofLocation& location) {
+    auto mapping = profile.mappings.find(location.mapping);
+
+    if (mapping != profile.mappings.end()) {
+        const string& file = profile.text(mapping->second.fileName);
+
+        if (!file.empty() && file[0] == '/') {
+            uint64_t address = infos.isExecutable(file) ? location.address : location.address - mapping->second.start + mapping->second.offset;
+
+            const FunctionSymbol* symbol = infos.findFunction(file, address);
+
+            if (symbol) {
+                return symbol->name;
+            }
+        }
+    }
+
+    return "[unknown]";
+}
+
+CallGraph* PprofReader::read(const string& file) {
+    DEBUG cout << "DEBUG : Importing the pprof profile " << file << endl;
+
+    Timer timer;
+
+    PprofProfile profile;
+
+    {
+        ProtoStream stream(blockSize);
+
+        if (!stream.open(file)) {
+            ERROR cout << "ERROR : Unable to open " << file << endl;
+            return NULL;
+        }
+
+        if (!readProfile(stream, profile)) {
+            ERROR cout << "ERROR : " << file << " is not a valid pprof profile" << endl;
+            return NULL;
+        }
+    }
+
+    if (profile.sampleTypes.empty()) {
+        ERROR cout << "ERROR : " << file << " does not contain any sample type" << endl;
+        return NULL;
+    }
+
+    //The value used for the costs, by default the one pprof displays
+    unsigned int valueIndex = profile.sampleTypes.size() - 1;
+    unsigned int callsIndex = NO_INDEX;
+
+    for (unsigned int i = 0; i < profile.sampleTypes.size(); ++i) {
+        const string& type = profile.text(profile.sampleTypes[i].first);
+
+        if (sampleType.empty() ? profile.defaultSampleType != 0 && profile.sampleTypes[i].first == profile.defaultSampleType : type == sampleType) {
+            valueIndex = i;
+        }
+
+        if (callsIndex == NO_INDEX && (type == "samples" || profile.text(profile.sampleTypes[i].second) == "count")) {
+            callsIndex = i;
+        }
+    }
+
+    if (!sampleType.empty() && profile.text(profile.sampleTypes[valueIndex].first) != sampleType) {
+        ERROR cout << "ERROR : The sample type " << sampleType << " is not in the profile, the last one is used" << endl;
+    }
+
+    //The functions of the graph are identified by their module and their name
+    unordered_map<string, unsigned int> index;
+    vector<string> keys;
+
+    auto intern = [&](const string& module, const string& name) -> unsigned int {
+        auto result = index.insert(make_pair(module + '\0' + name, static_cast<unsigned int>(keys.size())));
+
+        if (result.second) {
+            keys.push_back(result.first->first);
+        }
+
+        return result.first->second;
+    };
+
+    //The frames of each location, the innermost first
+    unordered_map<uint64_t, pair<size_t, size_t>> locationFrames;
+    vector<unsigned int> frames;
+
+    for (auto& location : profile.locations) {
+        auto mapping = profile.mappings.find(location.second.mapping);
+        const string& module = mapping == profile.mappings.end() ? profile.text(0) : profile.text(mapping->second.fileName);
+
+        size_t first = frames.size();
+
+        for (size_t i = 0; i < location.second.lines; ++i) {
+            auto function = profile.functions.find(profile.lines[location.second.firstLine + i]);
+
+            if (function != profile.functions.end()) {
+                const string& name = profile.text(function->second.name);
+                frames.push_back(intern(module, name.empty() ? profile.text(function->second.systemName) : name));
+            }
+        }
+
+        if (frames.size() == first) {
+            frames.push_back(intern(module, symbolize(infos, profile, location.second)));
+        }
+
+        locationFrames[location.first] = make_pair(first, frames.size() - first);
+    }
+
+    //The vertices are sorted by module and name
+    vector<unsigned int> order(keys.size());
+    for (unsigned int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(), [&keys](unsigned int a, unsigned int b){ return keys[a] < keys[b]; });
+
+    vector<unsigned int> vertexOf(keys.size());
+    for (unsigned int i = 0; i < order.size(); ++i) {
+        vertexOf[order[i]] = i;
+    }
+
+    for (auto& frame : frames) {
+        frame = vertexOf[frame];
+    }
+
+    //Second pass : the samples
+    vector<double> selfValues(keys.size(), 0.0);
+    vector<double> inclusiveValues(keys.size(), 0.0);
+    vector<double> samples(keys.size(), 0.0);
+    vector<size_t> lastStack(keys.size(), 0);
+    unordered_map<unsigned long long, PprofCall> calls;
+
+    double total = 0.0;
+    size_t stacks = 0;
+    size_t unknownLocations = 0;
+
+    {
+        ProtoStream stream(blockSize);
+
+        if (!stream.open(file)) {
+            ERROR cout << "ERROR : Unable to open " << file << endl;
+            return NULL;
+        }
+
+        vector<uint64_t> locations;
+        vector<uint64_t> values;
+        vector<unsigned int> stack;
+
+        uint32_t field, wire;
+        uint64_t value;
+        StringRef bytes;
+
+        while (stream.next(field, wire, value, bytes)) {
+            if (field != PROFILE_SAMPLE || wire != WIRE_LENGTH) {
+                continue;
+            }
+
+            locations.clear();
+            values.clear();
+
+            ProtoDecoder decoder(bytes);
+
+            uint32_t sampleField, sampleWire;
+            while (decoder.next(sampleField, sampleWire)) {
+                if (sampleField == 1) {
+                    decoder.repeated(sampleWire, locations);
+                } else if (sampleField == 2) {
+                    decoder.repeated(sampleWire, values);
+                } else {
+                    decoder.skip(sampleWire);
+                }
+            }
+
+            if (decoder.failed()) {
+                ERROR cout << "ERROR : " << file << " contains an invalid sample" << endl;
+                return NULL;
+            }
+
+            double cost = valueIndex < values.size() ? static_cast<double>(static_cast<int64_t>(values[valueIndex])) : 0.0;
+            double count = callsIndex == NO_INDEX ? 1.0 : callsIndex < values.size() ? static_cast<double>(static_cast<int64_t>(values[callsIndex])) : 0.0;
+
+            //The first location is the leaf
+            stack.clear();
+            for (auto location : locations) {
+                auto found = locationFrames.find(location);
+
+                if (found == locationFrames.end()) {
+                    ++unknownLocations;
+                    continue;
+                }
+
+                stack.insert(stack.end(), frames.begin() + found->second.first, frames.begin() + found->second.first + found->second.second);
+            }
+
+            total += cost;
+
+            if (stack.empty()) {
+                continue;
+            }
+
+            //Each stack has its own stamp to count the recursive functions and call sites only once
+            size_t stamp = ++stacks;
+
+            selfValues[stack[0]] += cost;
+
+            for (size_t i = 0; i < stack.size(); ++i) {
+                if (lastStack[stack[i]] != stamp) {
+                    lastStack[stack[i]] = stamp;
+                    inclusiveValues[stack[i]] += cost;
+                    samples[stack[i]] += count;
+                }
+
+                if (i > 0) {
+                    PprofCall& call = calls[(static_cast<unsigned long long>(stack[i]) << 32) | stack[i - 1]];
+
+                    if (call.lastStack != stamp) {
+                        call.lastStack = stamp;
+                        call.value += cost;
+                        call.samples += count;
+                    }
+                }
+            }
+        }
+
+        if (stream.failed()) {
+            ERROR cout << "ERROR : " << file << " is not a valid pprof profile" << endl;
+            return NULL;
+        }
+    }
+
+    if (unknownLocations > 0) {
+        WARN cout << "WARNING : " << unknownLocations << " frames reference unknown locations" << endl;
+    }
+
+    double ratio = total != 0.0 ? 100.0 / total : 0.0;
+
+    Graph* graph = new Graph(keys.size());
+
+    for (unsigned int i = 0; i < order.size(); ++i) {
+        const string& key = keys[order[i]];
+        size_t separator = key.find('\0');
+
+        vertex_info& info = (*graph)[vertex(i, *graph)];
+
+        info.module = stringsOf(*graph).intern(StringRef(key.data(), key.data() + separator));
+        info.name = arenaOf(*graph).store(StringRef(key.data() + separator + 1, key.data() + key.size()));
+        info.self_cost = selfValues[i] * ratio;
+        info.inclusive_cost = inclusiveValues[i] * ratio;
+        info.calls = static_cast<unsigned int>(max(0.0, min(samples[i], 4294967295.0)));
+    }
+
+    vector<unsigned long long> edges;
+    edges.reserve(calls.size());
+    for (auto& call : calls) {
+        edges.push_back(call.first);
+    }
+
+    std::sort(edges.begin(), edges.end());
+
+    GraphBuilder builder(threads, memoryCap);
+    builder.reserve(edges.size());
+
+    for (auto edge : edges) {
+        const PprofCall& call = calls[edge];
+
+        builder.addCall(edge >> 32, edge & 0xFFFFFFFF, static_cast<unsigned int>(max(0.0, min(call.samples, 4294967295.0))), call.value * ratio);
+    }
+
+    CallGraph* callGraph = builder.build(graph);
+
+    DEBUG cout << "DEBUG : Number of edges : " << callGraph->numberOfCallSites() << endl;
+    DEBUG cout << "DEBUG : Number of vertices : " << num_vertices(*graph) << endl;
+    PERF cout << "PERF : Importation finished in " << timer.elapsed() << "ms" << endl;
+
+    Timer extraction;
+
+    completeGraph(*callGraph);
+
+    PERF cout << "PERF : Information extracted in " << extraction.elapsed() << "ms" << endl;
+
+    return callGraph;
+}
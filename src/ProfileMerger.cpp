@@ -0,0 +1,289 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+#include "ProfileMerger.hpp"
+#include "CallGraph.hpp"
+#include "Infos.hpp"
+#include "Logging.hpp"
+#include "Timer.hpp"
+#include "GraphBuilder.hpp"
+
+using namespace std;
+using namespace inlining;
+
+namespace {
+
+struct MergedFunction {
+    const string* key;      //module\0name, owned by the index
+    string fileName;
+    double calls;
+    double selfCost;
+    double inclusiveCost;
+
+    explicit MergedFunction(const string* k) : key(k), calls(0.0), selfCost(0.0), inclusiveCost(0.0) {}
+};
+
+struct MergedCallSite {
+    double calls;
+    double cost;
+
+    MergedCallSite() : calls(0.0), cost(0.0) {}
+};
+
+/*!
+ * \brief The runs folded by a single thread.
+ */
+struct PartialMerge {
+    unordered_map<string, unsigned int> index;
+    vector<MergedFunction> functions;
+    unordered_map<uint64_t, MergedCallSite> callSites;     //(source << 32) | target
+    double weight;
+
+    PartialMerge() : weight(0.0) {}
+
+    unsigned int intern(const string& key) {
+        auto result = index.insert(make_pair(key, static_cast<unsigned int>(functions.size())));
+
+        if (result.second) {
+            functions.push_back(MergedFunction(&result.first->first));
+        }
+
+        return result.first->second;
+    }
+};
+
+} //end of anonymous namespace
+
+static string keyOf(const string& module, const vertex_info& function) {
+    string key;
+    key.reserve(module.size() + 1 + function.name.size());
+    key += module;
+    key += '\0';
+    key.append(function.name.begin, function.name.size());
+    return key;
+}
+
+static string nameOf(const string& key) {
+    return key.substr(key.find('\0') + 1);
+}
+
+static string moduleOf(const string& key) {
+    return key.substr(0, key.find('\0'));
+}
+
+static void fold(PartialMerge& partial, const CallGraph& graph, double weight) {
+    vector<unsigned int> ids(graph.numberOfFunctions());
+
+    FunctionIterator first, last;
+    for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
+        const vertex_info& function = graph[*first];
+
+        unsigned int id = partial.intern(keyOf(graph.moduleOf(*first), function));
+        ids[*first] = id;
+
+        MergedFunction& merged = partial.functions[id];
+        merged.calls += weight * function.calls;
+        merged.selfCost += weight * function.self_cost;
+        merged.inclusiveCost += weight * function.inclusive_cost;
+
+        if (merged.fileName.empty()) {
+            merged.fileName = graph.fileNameOf(*first);
+        }
+    }
+
+    const CallSiteTable& table = graph.callSites();
+
+    for (FrozenCallSite callSite = 0; callSite < table.numberOfCallSites(); ++callSite) {
+        uint64_t key = (static_cast<uint64_t>(ids[table.source(callSite)]) << 32) | ids[table.target(callSite)];
+
+        MergedCallSite& merged = partial.callSites[key];
+        merged.calls += weight * table.calls(callSite);
+        merged.cost += weight * table.cost(callSite);
+    }
+
+    partial.weight += weight;
+}
+
+static void reduce(PartialMerge& merged, PartialMerge& partial) {
+    vector<unsigned int> ids(partial.functions.size());
+
+    for (unsigned int i = 0; i < partial.functions.size(); ++i) {
+        const MergedFunction& function = partial.functions[i];
+
+        unsigned int id = merged.intern(*function.key);
+        ids[i] = id;
+
+        MergedFunction& target = merged.functions[id];
+        target.calls += function.calls;
+        target.selfCost += function.selfCost;
+        target.inclusiveCost += function.inclusiveCost;
+
+        if (target.fileName.empty()) {
+            target.fileName = function.fileName;
+        }
+    }
+
+    for (auto& callSite : partial.callSites) {
+        uint64_t key = (static_cast<uint64_t>(ids[callSite.first >> 32]) << 32) | ids[callSite.first & 0xFFFFFFFF];
+
+        MergedCallSite& target = merged.callSites[key];
+        target.calls += callSite.second.calls;
+        target.cost += callSite.second.cost;
+    }
+
+    merged.weight += partial.weight;
+
+    //Release the partial graph as soon as possible
+    partial = PartialMerge();
+}
+
+void ProfileMerger::addRun(const string& file, double weight) {
+    files.push_back(file);
+    weights.push_back(weight);
+}
+
+CallGraph* ProfileMerger::read(const string& file) {
+    addRun(file);
+
+    return merge();
+}
+
+CallGraph* ProfileMerger::merge() {
+    DEBUG cout << "DEBUG : Merging " << files.size() << " runs" << endl;
+
+    Timer timer;
+
+    unsigned int workers = std::max(1u, std::min<unsigned int>(threads, files.size()));
+
+    //Each run is folded in its own partial, the partials are reduced in the order of the runs as soon as they are
+    //ready, the sums and the file names do not depend on the scheduling of the runs
+    vector<PartialMerge> partials(files.size());
+    vector<char> folded(files.size(), 0);
+
+    PartialMerge merged;
+    size_t reduced = 0;
+    std::mutex mutex;
+
+    //The readers only read the profiles, each worker has its own Infos
+    vector<Infos> localInfos(workers);
+    for (auto& local : localInfos) {
+        local.setDemangled(infos.isDemangled());
+    }
+
+    parallelForWorker(files.size(), workers, [&](unsigned int worker, size_t run){
+        ProfileReader* reader = factory(files[run], localInfos[worker]);
+        reader->setComplete(false);
+
+        CallGraph* graph = reader->read(files[run]);
+        delete reader;
+
+        if (!graph) {
+            ERROR cout << "ERROR : The run " << files[run] << " cannot be read, it is not merged" << endl;
+        } else {
+            //The costs of every run are merged
+            graph->decodeLabels(ALL_FIELDS);
+
+            fold(partials[run], *graph, weights[run]);
+
+            delete graph;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        folded[run] = 1;
+
+        for (; reduced < files.size() && folded[reduced]; ++reduced) {
+            reduce(merged, partials[reduced]);
+        }
+    });
+
+    PERF cout << "PERF : Runs folded in " << timer.elapsed() << "ms" << endl;
+
+    //The vertices are numbered in the order of their names, like in the graphs of a single run
+    vector<unsigned int> order(merged.functions.size());
+    for (unsigned int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+
+    vector<string> names(merged.functions.size());
+    for (unsigned int i = 0; i < names.size(); ++i) {
+        names[i] = nameOf(*merged.functions[i].key);
+    }
+
+    std::sort(order.begin(), order.end(), [&](unsigned int lhs, unsigned int rhs){
+        return names[lhs] < names[rhs] || (names[lhs] == names[rhs] && *merged.functions[lhs].key < *merged.functions[rhs].key);
+    });
+
+    //The costs are percentages of each run
+    double weight = merged.weight > 0.0 ? merged.weight : 1.0;
+
+    vector<Function> functions(order.size());
+
+    Graph* graph = new Graph(order.size());
+
+    StringPool& strings = stringsOf(*graph);
+
+    for (unsigned int i = 0; i < order.size(); ++i) {
+        const MergedFunction& merge = merged.functions[order[i]];
+
+        functions[order[i]] = i;
+
+        vertex_info& function = (*graph)[vertex(i, *graph)];
+        function.name = arenaOf(*graph).store(names[order[i]]);
+        function.module = strings.intern(moduleOf(*merge.key));
+        function.file_name = strings.intern(merge.fileName);
+        function.calls = toCalls(merge.calls);
+        function.self_cost = merge.selfCost / weight;
+        function.inclusive_cost = merge.inclusiveCost / weight;
+    }
+
+    vector<pair<uint64_t, MergedCallSite>> callSites;
+    callSites.reserve(merged.callSites.size());
+
+    for (auto& callSite : merged.callSites) {
+        uint64_t key = (static_cast<uint64_t>(functions[callSite.first >> 32]) << 32) | functions[callSite.first & 0xFFFFFFFF];
+        callSites.push_back(make_pair(key, callSite.second));
+    }
+
+    //Add the call sites in a deterministic order
+    std::sort(callSites.begin(), callSites.end(), [](const pair<uint64_t, MergedCallSite>& lhs, const pair<uint64_t, MergedCallSite>& rhs){ return lhs.first < rhs.first; });
+
+    GraphBuilder builder(threads, memoryCap);
+    builder.reserve(callSites.size());
+
+    for (auto& callSite : callSites) {
+        builder.addCall(callSite.first >> 32, callSite.first & 0xFFFFFFFF, toCalls(callSite.second.calls), callSite.second.cost / weight);
+    }
+
+    CallGraph* callGraph = builder.build(graph);
+
+    DEBUG cout << "DEBUG : Number of edges : " << callGraph->numberOfCallSites() << endl;
+    DEBUG cout << "DEBUG : Number of vertices : " << num_vertices(*graph) << endl;
+
+    completeGraph(*callGraph);
+
+    PERF cout << "PERF : Runs merged in " << timer.elapsed() << "ms" << endl;
+
+    return callGraph;
+}
@@ -0,0 +1,335 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <unordered_set>
+
+#include "ProfileReader.hpp"
+#include "Snapshot.hpp"
+#include "CallGraph.hpp"
+#include "Utils.hpp"
+#include "Infos.hpp"
+#include "Decompressor.hpp"
+#include "ProtoDecoder.hpp"
+#include "Tokenizer.hpp"
+#include "Mangling.hpp"
+
+using namespace std;
+using namespace inlining;
+
+//The number of bytes read to detect the format of a file
+static const size_t HEAD_SIZE = 4096;
+
+static int countParameters(const string& name) {
+    string::size_type start = name.rfind(")");
+
+    if (start == string::npos) {
+        return 0;
+    }
+
+    string::size_type i = start - 1;
+    unsigned int parameters = 0;
+    unsigned int inTemplate = 0;    //To avoid counting parameters in a template declaration
+    unsigned int inParenth = 0;     //To avoid counting parameters in a function pointer declaration
+
+    //Parse from the right
+    while (!(inParenth == 0 && name[i] == '(')) {
+        if (!isspace(name[i]) && parameters == 0) {
+            parameters = 1;
+        }
+
+        if (name[i] ==')') {
+            inParenth++;
+        } else if (name[i] == '(') {
+            inParenth--;
+        }
+
+        if (inParenth == 0) {
+            if (name[i] == '>') {
+                inTemplate++;
+            } else if (name[i] == '<') {
+                inTemplate--;
+            }
+
+            if (name[i] == ',' && inTemplate == 0) {
+                ++parameters;
+            }
+        }
+        --i;
+    }
+
+    return parameters;
+}
+
+void ProfileReader::completeFunctions(CallGraph& graph) {
+    size_t functions = graph.numberOfFunctions();
+    size_t blocks = threads <= 1 ? 1 : threads * 4;
+
+    auto firstOf = [functions, blocks](size_t block){ return block * functions / blocks; };
+
+#ifndef BENCH
+    //The libraries are loaded beforehand in the order of the functions, the workers only read the tables of the Infos
+    vector<vector<StringId>> modules(blocks);
+    parallelFor(blocks, threads, [&](size_t block){
+        unordered_set<StringId> seen;
+
+        for (size_t i = firstOf(block); i < firstOf(block + 1); ++i) {
+            StringId module = graph[i].module;
+
+            if (seen.insert(module).second) {
+                modules[block].push_back(module);
+            }
+        }
+    });
+
+    vector<char> loaded(graph.strings().size(), false);
+    for (auto& block : modules) {
+        for (auto module : block) {
+            if (!loaded[module]) {
+                loaded[module] = true;
+                infos.loadLibrary(graph.strings()[module]);
+            }
+        }
+    }
+#endif
+
+#ifdef BENCH
+    //The random sizes are drawn in the order of the functions, the benchmarks do not depend on the number of threads
+    for (size_t i = 0; i < functions; ++i) {
+        graph[i].size = 1 + (rand() % 1000);
+        graph[i].virtuality = (rand() % 6) < 2;
+    }
+#endif
+
+    //Each block has its own totals and its own buffer for the hashes
+    vector<unsigned int> partialCalls(blocks, 0);
+    vector<unsigned int> partialSizes(blocks, 0);
+
+    parallelFor(blocks, threads, [&](size_t block){
+        unsigned int calls = 0;
+        unsigned int sizes = 0;
+
+#ifndef BENCH
+        string hash;
+#endif
+
+        for (size_t i = firstOf(block); i < firstOf(block + 1); ++i) {
+            auto& function = graph[i];
+
+            //The mangled names are demangled only if they cannot be walked directly
+            if (infos.isDemangled()) {
+                function.parameters = countParameters(function.name.str());
+            } else {
+                int parameters = countMangledParameters(function.name);
+                function.parameters = parameters >= 0 ? parameters : countParameters(demangle(function.name.str()));
+            }
+
+#ifndef BENCH
+            hash.assign(graph.moduleOf(i));
+            hash += "##";
+            hash.append(function.name.begin, function.name.size());
+
+            function.size = infos.sizeOfHash(hash);
+            function.virtuality = infos.isVirtualHash(hash);
+#endif
+
+            sizes += function.size;
+            calls += function.calls;
+        }
+
+        //The totals are written once per block, the workers do not share their cache lines in the loop
+        partialCalls[block] = calls;
+        partialSizes[block] = sizes;
+    });
+
+    unsigned int totalCalls = 0;
+    unsigned int totalSize = 0;
+
+    for (size_t block = 0; block < blocks; ++block) {
+        totalCalls += partialCalls[block];
+        totalSize += partialSizes[block];
+    }
+
+    //Once we have the total of calls we can compute the frequency
+    parallelFor(blocks, threads, [&](size_t block){
+        for (size_t i = firstOf(block); i < firstOf(block + 1); ++i) {
+            auto& function = graph[i];
+            function.frequency = static_cast<double>(function.calls) / static_cast<double>(totalCalls);
+        }
+    });
+
+    graph.setNumberOfCalls(totalCalls);
+    graph.setApplicationSize(totalSize);
+}
+
+void ProfileReader::completeCallSites(CallGraph& graph) {
+    CallSiteTable& table = graph.callSites();
+
+    size_t callSites = table.numberOfCallSites();
+    size_t blocks = threads <= 1 ? 1 : threads * 4;
+
+    double totalCalls = graph.getNumberOfCalls();
+
+    //The call sites are distributed by blocks of the table
+    parallelFor(blocks, threads, [&](size_t block){
+        for (size_t i = block * callSites / blocks; i < (block + 1) * callSites / blocks; ++i) {
+            table.setFrequency(i, table.calls(i) / totalCalls);
+        }
+    });
+}
+
+void ProfileReader::completeGraph(CallGraph& graph) {
+    if (complete) {
+        completeFunctions(graph);
+        completeCallSites(graph);
+    }
+}
+
+//The top-level fields of profile.proto and their wire types
+static bool isProfileField(uint32_t field, uint32_t wire) {
+    if (wire == WIRE_LENGTH) {
+        return (field >= 1 && field <= 6) || field == 11 || field == 13;
+    }
+
+    return wire == WIRE_VARINT && field >= 7 && field <= 14 && field != 11;
+}
+
+//A pprof profile starts with its sample types, the fields are checked until the end of the head of the file
+static bool isProfileProto(const string& head) {
+    if (head.empty() || head[0] != 0x0A) {
+        return false;
+    }
+
+    const char* it = head.data();
+    const char* end = it + head.size();
+
+    bool first = true;
+
+    while (it < end) {
+        uint64_t key;
+        uint64_t value;
+
+        if (!decodeVarint(it, end, key) || !decodeVarint(it, end, value)) {
+            return !first;
+        }
+
+        if (!isProfileField(key >> 3, key & 7)) {
+            return false;
+        }
+
+        if ((key & 7) == WIRE_LENGTH) {
+            //The field continues after the head
+            if (value > static_cast<uint64_t>(end - it)) {
+                return !first;
+            }
+
+            //The sample type only contains its type and its unit
+            if (first) {
+                ProtoDecoder decoder(it, it + value);
+
+                uint32_t field, wire;
+                uint64_t index;
+                while (decoder.next(field, wire)) {
+                    if (wire != WIRE_VARINT || !decoder.varint(index)) {
+                        return false;
+                    }
+                }
+
+                if (decoder.failed()) {
+                    return false;
+                }
+            }
+
+            it += value;
+        }
+
+        first = false;
+    }
+
+    return true;
+}
+
+InputFormat inlining::detectFormat(const string& file) {
+    ifstream stream(file.c_str(), ios::in | ios::binary);
+
+    //The format is detected from the first bytes, decompressed if necessary
+    char buffer[HEAD_SIZE];
+    stream.read(buffer, sizeof(buffer));
+    size_t size = stream.gcount();
+
+    string head;
+    if (detectCompression(buffer, size) == NO_COMPRESSION) {
+        head.assign(buffer, size);
+    } else {
+        Decompressor decompressor;
+
+        //A truncated stream is not an error
+        if (decompressor.start(buffer, size)) {
+            decompressor.feed(buffer, size, head);
+        }
+    }
+
+    if (head.size() >= sizeof(SNAPSHOT_MAGIC) && memcmp(head.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0) {
+        return SNAPSHOT_FORMAT;
+    }
+
+    if (head.compare(0, 4, "gmon") == 0) {
+        return GMON_FORMAT;
+    }
+
+    if (head.compare(0, 8, "PERFILE2") == 0) {
+        return PERF_FORMAT;
+    }
+
+    if (isProfileProto(head)) {
+        return PPROF_FORMAT;
+    }
+
+    istringstream lines(head);
+
+    string line;
+    while (getline(lines, line)) {
+        //Skip the empty lines before the content
+        if (trimRef(StringRef(line)).empty()) {
+            continue;
+        }
+
+        //callgrind.out files start with a format comment or with the header lines
+        if (line.compare(0, 18, "# callgrind format") == 0 || line.compare(0, 8, "version:") == 0
+                || line.compare(0, 8, "creator:") == 0 || line.compare(0, 7, "events:") == 0) {
+            return CALLGRIND_FORMAT;
+        }
+
+        //Folded stacks are lines of frames followed by a number of samples, a dot graph starts with its header
+        string::size_type last = line.find_last_not_of(" \t\r");
+        string::size_type separator = line.find_last_of(" \t", last);
+        if (separator != string::npos && line.find_first_not_of("0123456789.", separator + 1) > last) {
+            return FOLDED_FORMAT;
+        }
+
+        break;
+    }
+
+    return DOT_FORMAT;
+}
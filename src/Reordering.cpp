@@ -0,0 +1,176 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <algorithm>
+
+#include "Reordering.hpp"
+#include "CallGraph.hpp"
+
+using namespace std;
+using namespace inlining;
+
+//The callers and the callees of a function, in the order of the graph
+static void neighbours(const CallSiteTable& table, Function function, vector<Function>& result) {
+    const FrozenCallSite* it;
+    const FrozenCallSite* end;
+    for (boost::tie(it, end) = table.outCallSites(function); it != end; ++it) {
+        result.push_back(table.target(*it));
+    }
+
+    for (boost::tie(it, end) = table.inCallSites(function); it != end; ++it) {
+        result.push_back(table.source(*it));
+    }
+}
+
+static vector<Function> rcmOrder(const CallGraph& graph) {
+    const CallSiteTable& table = graph.callSites();
+    size_t functions = graph.numberOfFunctions();
+
+    vector<size_t> degrees(functions);
+    vector<Function> starts(functions);
+    for (Function function = 0; function < functions; ++function) {
+        degrees[function] = table.outDegree(function) + table.inDegree(function);
+        starts[function] = function;
+    }
+
+    auto byDegree = [&degrees](Function lhs, Function rhs){ return degrees[lhs] < degrees[rhs]; };
+
+    //Each component starts from its function of lowest degree
+    stable_sort(starts.begin(), starts.end(), byDegree);
+
+    vector<Function> order;
+    order.reserve(functions);
+
+    vector<char> visited(functions, false);
+    vector<Function> next;
+
+    for (auto start : starts) {
+        if (visited[start]) {
+            continue;
+        }
+
+        visited[start] = true;
+        order.push_back(start);
+
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            next.clear();
+            neighbours(table, order[head], next);
+
+            size_t first = order.size();
+            for (auto function : next) {
+                if (!visited[function]) {
+                    visited[function] = true;
+                    order.push_back(function);
+                }
+            }
+
+            stable_sort(order.begin() + first, order.end(), byDegree);
+        }
+    }
+
+    reverse(order.begin(), order.end());
+
+    return order;
+}
+
+static vector<Function> bfsOrder(const CallGraph& graph) {
+    const CallSiteTable& table = graph.callSites();
+    size_t functions = graph.numberOfFunctions();
+
+    //main is the first root, the functions never reached from it are the next ones, in the order of the graph
+    vector<Function> roots;
+    roots.reserve(functions + 1);
+
+    for (Function function = 0; function < functions; ++function) {
+        if (graph.nameOf(function) == "main") {
+            roots.push_back(function);
+        }
+    }
+
+    for (Function function = 0; function < functions; ++function) {
+        roots.push_back(function);
+    }
+
+    vector<Function> order;
+    order.reserve(functions);
+
+    vector<char> visited(functions, false);
+
+    for (auto root : roots) {
+        if (visited[root]) {
+            continue;
+        }
+
+        visited[root] = true;
+        order.push_back(root);
+
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            const FrozenCallSite* it;
+            const FrozenCallSite* end;
+            for (boost::tie(it, end) = table.outCallSites(order[head]); it != end; ++it) {
+                Function callee = table.target(*it);
+
+                if (!visited[callee]) {
+                    visited[callee] = true;
+                    order.push_back(callee);
+                }
+            }
+        }
+    }
+
+    return order;
+}
+
+static vector<Function> moduleOrder(const CallGraph& graph) {
+    vector<Function> order(graph.numberOfFunctions());
+    for (Function function = 0; function < order.size(); ++function) {
+        order[function] = function;
+    }
+
+    stable_sort(order.begin(), order.end(), [&graph](Function lhs, Function rhs){
+        //The modules are kept in the order they have been met
+        if (graph[lhs].module != graph[rhs].module) {
+            return graph[lhs].module < graph[rhs].module;
+        }
+
+        return graph[lhs].calls > graph[rhs].calls;
+    });
+
+    return order;
+}
+
+vector<Function> inlining::computeOrder(const CallGraph& graph, VertexOrder order) {
+    switch (order) {
+        case RCM_ORDER:
+            return rcmOrder(graph);
+        case BFS_ORDER:
+            return bfsOrder(graph);
+        case MODULE_ORDER:
+            return moduleOrder(graph);
+        default:
+            break;
+    }
+
+    vector<Function> identity(graph.numberOfFunctions());
+    for (Function function = 0; function < identity.size(); ++function) {
+        identity[function] = function;
+    }
+
+    return identity;
+}
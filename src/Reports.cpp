@@ -35,7 +35,11 @@ using std::string;
 using namespace inlining;
 
 void Reports::addFilter(const std::string& filter) {
-    filters.insert(filter);
+    if (!filter.empty() && filter[filter.size() - 1] == '*') {
+        prefixes.push_back(filter.substr(0, filter.size() - 1));
+    } else {
+        filters.insert(filter);
+    }
 }
 
 void Reports::enableDefaultFilters() {
@@ -47,83 +51,133 @@ void Reports::enableDefaultFilters() {
 }
 
 bool Reports::filter(const Function& function) const {
-    return filters.find(graph[function].name) != filters.end();
+    string name = graph.nameOf(function);
+
+    if (filters.find(name) != filters.end()) {
+        return true;
+    }
+
+    for (vector<string>::const_iterator it = prefixes.begin(); it != prefixes.end(); ++it) {
+        if (name.compare(0, it->size(), *it) == 0) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
-bool Reports::filter(const CallSite& callSite) const {
-    return filter(target(callSite, *graph.getGraph())) || filter(source(callSite, *graph.getGraph()));
+bool Reports::filterCallSite(FrozenCallSite callSite) const {
+    return filter(graph.target(callSite)) || filter(graph.source(callSite));
+}
+
+std::vector<char> Reports::filteredFunctions() const {
+    std::vector<char> filtered(graph.numberOfFunctions(), false);
+
+    if (filters.empty() && prefixes.empty()) {
+        return filtered;
+    }
+
+    const CompressedNames& names = graph.compressedNames();
+
+    if (names.empty()) {
+        for (Function function = 0; function < filtered.size(); ++function) {
+            filtered[function] = filter(function);
+        }
+    } else {
+        vector<size_t> matches;
+
+        for (set<string>::const_iterator it = filters.begin(); it != filters.end(); ++it) {
+            names.find(StringRef(*it), matches);
+        }
+
+        for (vector<string>::const_iterator it = prefixes.begin(); it != prefixes.end(); ++it) {
+            names.findPrefix(StringRef(*it), matches);
+        }
+
+        for (vector<size_t>::const_iterator it = matches.begin(); it != matches.end(); ++it) {
+            filtered[*it] = true;
+        }
+    }
+
+    return filtered;
 }
 
 std::vector<Function> Reports::getBiggestFunctions(unsigned int top) const {
-    return getTopFunctions(top, SortBySize(graph));
+    return getTopFunctions(top, SortBySize(graph.getFrozenGraph()));
 }
 
 std::vector<Function> Reports::getMostCostlyFunctions(unsigned int top) const {
-    return getTopFunctions(top, SortBySelfCosts(graph));
+    return getTopFunctions(top, SortBySelfCosts(graph.getFrozenGraph()));
 }
 
 std::vector<Function> Reports::getMostInterestingFunctions(unsigned int top) const {
-    return getTopFunctions(top, SortByTemperature(graph));
+    return getTopFunctions(top, SortByTemperature(graph.getFrozenGraph()));
 }
 
 std::vector<Function> Reports::getMostCalledFunctions(unsigned int top) const {
-    return getTopFunctions(top, SortByCalls(graph));
+    return getTopFunctions(top, SortByCalls(graph.getFrozenGraph()));
 }
 
-std::vector<CallSite> Reports::getMostCalledCallSites(unsigned int top) const {
-    return getTopCallSites(top, SortByCalls(graph));
+std::vector<FrozenCallSite> Reports::getMostCalledCallSites(unsigned int top) const {
+    return getTopCallSites(top, SortCallSitesByCalls(graph.getFrozenGraph()));
 }
 
 std::vector<Function> Reports::getMostParameterizedFunctions(unsigned int top) const {
-    return getTopFunctions(top, SortByParameters(graph));
+    return getTopFunctions(top, SortByParameters(graph.getFrozenGraph()));
 }
 
-std::vector<CallSite> Reports::getMostInterestingCallSites(unsigned int top) const {
-    return getTopCallSites(top, SortByTemperature(graph));
+std::vector<FrozenCallSite> Reports::getMostInterestingCallSites(unsigned int top) const {
+    return getTopCallSites(top, SortCallSitesByTemperature(graph.getFrozenGraph()));
 }
 
 std::vector<Function> Reports::getTiniestFunctions(unsigned int top) const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
+    std::vector<char> filtered = filteredFunctions();
     std::vector<Function> functions;
 
-    FunctionIterator first, last;
-    for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
-        if (graph[*first].size > 0 && !filter(*first)) {
-            functions.push_back(*first);
+    for (Function function = 0; function < frozen.numberOfFunctions(); ++function) {
+        if (frozen.size(function) > 0 && !filtered[function]) {
+            functions.push_back(function);
         }
     }
 
-    keepMin(top, SortBySize(graph), functions);
+    keepMin(top, SortBySize(frozen), functions);
 
     return functions;
 }
 
-std::vector<CallSite> Reports::getHeaviestInterLibraryCalls(unsigned int top) const {
-    std::vector<CallSite> callSites = analyzer.findInterLibraryCalls();
+std::vector<FrozenCallSite> Reports::getHeaviestInterLibraryCalls(unsigned int top) const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
+    std::vector<FrozenCallSite> callSites = analyzer.findInterLibraryCalls();
 
-    std::vector<CallSite> filtered;
-    for (std::vector<CallSite>::const_iterator it = callSites.begin(); it != callSites.end(); ++it) {
-        if (!filter(*it)) {
+    std::vector<char> ignored = filteredFunctions();
+
+    std::vector<FrozenCallSite> filtered;
+    for (std::vector<FrozenCallSite>::const_iterator it = callSites.begin(); it != callSites.end(); ++it) {
+        if (!ignored[frozen.source(*it)] && !ignored[frozen.target(*it)]) {
             filtered.push_back(*it);
         }
     }
 
-    keepTop(top, SortByCalls(graph), filtered);
+    keepTop(top, SortCallSitesByCalls(frozen), filtered);
 
     return filtered;
 }
 
-std::vector<CallSite> Reports::getHeaviestVirtualCalls(unsigned int top) const {
-    std::vector<CallSite> callSites = analyzer.findVirtualCalls();
+std::vector<FrozenCallSite> Reports::getHeaviestVirtualCalls(unsigned int top) const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
+    std::vector<FrozenCallSite> callSites = analyzer.findVirtualCalls();
 
-    std::vector<CallSite> filtered;
+    std::vector<char> ignored = filteredFunctions();
 
-    for (std::vector<CallSite>::const_iterator it = callSites.begin(); it != callSites.end(); ++it) {
-        if (!filter(*it)) {
+    std::vector<FrozenCallSite> filtered;
+    for (std::vector<FrozenCallSite>::const_iterator it = callSites.begin(); it != callSites.end(); ++it) {
+        if (!ignored[frozen.source(*it)] && !ignored[frozen.target(*it)]) {
             filtered.push_back(*it);
         }
     }
 
-    keepTop(top, SortByCalls(graph), filtered);
+    keepTop(top, SortCallSitesByCalls(frozen), filtered);
 
     return filtered;
 }
@@ -149,16 +203,17 @@ void Reports::printStatisticReports(unsigned int top) const {
 }
 
 std::vector<Function> Reports::getOverParameterizedFunctions() const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
+    std::vector<char> filtered = filteredFunctions();
     std::vector<Function> functions;
 
-    FunctionIterator first, last;
-    for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
-        if (graph[*first].parameters > Parameters::get(PARAMETERS_THRESHOLD) && !filter(*first)) {
-            functions.push_back(*first);
+    for (Function function = 0; function < frozen.numberOfFunctions(); ++function) {
+        if (frozen.parameters(function) > Parameters::get(PARAMETERS_THRESHOLD) && !filtered[function]) {
+            functions.push_back(function);
         }
     }
 
-    sort(functions.rbegin(), functions.rend(), SortByParameters(graph));
+    sort(functions.rbegin(), functions.rend(), SortByParameters(frozen));
 
     return functions;
 }
@@ -190,7 +245,7 @@ void Reports::printLibraryIssues() const {
                 continue;
             }
 
-            cout << "\tFunctions " << graph[it->src].name << "[" << graph[it->src].module << "] and  " << graph[it->dest].name << "[" << graph[it->dest].module << "] should be in the same library " << endl;
+            cout << "\tFunctions " << graph.nameOf(it->src) << "[" << graph.moduleOf(it->src) << "] and  " << graph.nameOf(it->dest) << "[" << graph.moduleOf(it->dest) << "] should be in the same library " << endl;
 
             for (vector<string>::const_iterator sit = it->solutions.begin(); sit != it->solutions.end(); ++sit) {
                 cout << "\t\t" << *sit << endl;
@@ -210,7 +265,7 @@ void Reports::printClusters() const {
         for (vector<Cluster>::const_iterator it = clusters.begin(); it != clusters.end(); ++it) {
             cout << "\tCluster of " << it->callSites.size() << " call sites" << endl;
 
-            for (vector<CallSite>::const_iterator cit = it->callSites.begin(); cit != it->callSites.end(); ++cit) {
+            for (vector<FrozenCallSite>::const_iterator cit = it->callSites.begin(); cit != it->callSites.end(); ++cit) {
                 cout << "\t\t" << graph.getDescription(*cit) << endl;
             }
 
@@ -263,104 +318,115 @@ void Reports::printVirtualHierarchyIssues() const {
 }
 
 void Reports::printFunctionsWithTooManyParameters() const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
     vector<Function> overParameterized = getOverParameterizedFunctions();
 
     if (!overParameterized.empty()) {
         cout << "Functions with too many parameters" << endl;
 
         for (vector<Function>::const_iterator it = overParameterized.begin(); it != overParameterized.end(); ++it) {
-            cout << "\t" << graph[*it].name << " : " << graph[*it].parameters << " parameters" << endl;
+            cout << "\t" << graph.nameOf(*it) << " : " << frozen.parameters(*it) << " parameters" << endl;
         }
     }
 }
 
 void Reports::printBiggestFunctions(unsigned int top) const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
     vector<Function> functions = getBiggestFunctions(top);
 
     cout << "Top " << top << " biggest functions : " << endl;
     for (vector<Function>::const_iterator iterator = functions.begin(); iterator != functions.end(); ++iterator) {
-        cout << "\tFunction " << graph[*iterator].name << " = " << graph[*iterator].size << endl;
+        cout << "\tFunction " << graph.nameOf(*iterator) << " = " << frozen.size(*iterator) << endl;
     }
 }
 
 void Reports::printFunctionHeuristics(unsigned int top) const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
     vector<Function> functions = getMostInterestingFunctions(top);
 
     cout << "Top " << top << " function temperature : " << endl;
     for (vector<Function>::const_iterator iterator = functions.begin(); iterator != functions.end(); ++iterator) {
-        cout << "\tFunction " << graph[*iterator].name << " = " << graph[*iterator].temperature << endl;
+        cout << "\tFunction " << graph.nameOf(*iterator) << " = " << frozen.temperature(*iterator) << endl;
     }
 }
 
 void Reports::printCallSiteHeuristics(unsigned int top) const {
-    vector<CallSite> callSites = getMostInterestingCallSites(top);
+    const FrozenGraph& frozen = graph.getFrozenGraph();
+    vector<FrozenCallSite> callSites = getMostInterestingCallSites(top);
 
     cout << "Top " << top << " call site temperature : " << endl;
-    for (vector<CallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
-        cout << "\tCall site " << graph.getDescription(*iterator) << " = " << graph[*iterator].temperature << endl;
+    for (vector<FrozenCallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
+        cout << "\tCall site " << graph.getDescription(*iterator) << " = " << frozen.callSiteTemperature(*iterator) << endl;
     }
 }
 
 void Reports::printHeavyInterLibrariesCalls(unsigned int top) const {
-    vector<CallSite> callSites = getHeaviestInterLibraryCalls(top);
+    const FrozenGraph& frozen = graph.getFrozenGraph();
+    vector<FrozenCallSite> callSites = getHeaviestInterLibraryCalls(top);
 
     cout << "Top " << top << "  heavy calls between libraries : " << endl;
-    for (vector<CallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
-        cout << "\tCall site " << graph.getDescription(*iterator) << " = " << graph[*iterator].calls << endl;
+    for (vector<FrozenCallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
+        cout << "\tCall site " << graph.getDescription(*iterator) << " = " << frozen.callSiteCalls(*iterator) << endl;
     }
 }
 
 void Reports::printHeavyVirtualCalls(unsigned int top) const {
-    vector<CallSite> callSites = getHeaviestVirtualCalls(top);
+    const FrozenGraph& frozen = graph.getFrozenGraph();
+    vector<FrozenCallSite> callSites = getHeaviestVirtualCalls(top);
 
     cout << "Top " << top << "  heavy virtual calls : " << endl;
-    for (vector<CallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
-        cout << "\tCall site " << graph.getDescription(*iterator) << " = " << graph[*iterator].calls << endl;
+    for (vector<FrozenCallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
+        cout << "\tCall site " << graph.getDescription(*iterator) << " = " << frozen.callSiteCalls(*iterator) << endl;
     }
 }
 
 void Reports::printMostCalledFunctions(unsigned int top) const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
     vector<Function> functions = getMostCalledFunctions(top);
 
     cout << "Top " << top << " most called functions : " << endl;
     for (vector<Function>::const_iterator iterator = functions.begin(); iterator != functions.end(); ++iterator) {
-        cout << "\tFunction " << graph[*iterator].name << " = " << graph[*iterator].calls << endl;
+        cout << "\tFunction " << graph.nameOf(*iterator) << " = " << frozen.calls(*iterator) << endl;
     }
 }
 
 void Reports::printMostCalledCallSites(unsigned int top) const {
-    vector<CallSite> callSites = getMostCalledCallSites(top);
+    const FrozenGraph& frozen = graph.getFrozenGraph();
+    vector<FrozenCallSite> callSites = getMostCalledCallSites(top);
 
     cout << "Top " << top << " most called call sites : " << endl;
-    for (vector<CallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
-        cout << "\tCall site " << graph.getDescription(*iterator) << " = " << graph[*iterator].calls << endl;
+    for (vector<FrozenCallSite>::const_iterator iterator = callSites.begin(); iterator != callSites.end(); ++iterator) {
+        cout << "\tCall site " << graph.getDescription(*iterator) << " = " << frozen.callSiteCalls(*iterator) << endl;
     }
 }
 
 void Reports::printTiniestFunctions(unsigned int top) const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
     vector<Function> functions = getTiniestFunctions(top);
 
     cout << "Top " << top << " tiniest functions : " << endl;
     for (vector<Function>::const_iterator iterator = functions.begin(); iterator != functions.end(); ++iterator) {
-        cout << "\tFunction " << graph[*iterator].name << " = " << graph[*iterator].size << endl;
+        cout << "\tFunction " << graph.nameOf(*iterator) << " = " << frozen.size(*iterator) << endl;
     }
 }
 
 void Reports::printMostParameterizedFunctions(unsigned int top) const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
     vector<Function> functions = getMostParameterizedFunctions(top);
 
     cout << "Top " << top << " most parameterized : " << endl;
     for (vector<Function>::const_iterator iterator = functions.begin(); iterator != functions.end(); ++iterator) {
-        cout << "\tFunction " << graph[*iterator].name << " = " << graph[*iterator].parameters << endl;
+        cout << "\tFunction " << graph.nameOf(*iterator) << " = " << frozen.parameters(*iterator) << endl;
     }
 }
 
 void Reports::printMostCostlyFunctions(unsigned int top) const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
     vector<Function> functions = getMostCostlyFunctions(top);
 
     cout << "Top " << top << " most costly : " << endl;
     for (vector<Function>::const_iterator iterator = functions.begin(); iterator != functions.end(); ++iterator) {
-        cout << "\tFunction " << graph[*iterator].name << " = " << graph[*iterator].self_cost << endl;
+        cout << "\tFunction " << graph.nameOf(*iterator) << " = " << frozen.selfCost(*iterator) << endl;
     }
 }
 
@@ -370,7 +436,7 @@ void Reports::printFunctionsCalledOnce() const {
     cout << "Functions called once" << endl;
     for (vector<Function>::const_iterator iterator = functions.begin(); iterator != functions.end(); ++iterator) {
         if (!filter(*iterator)) {
-            cout << "\tFunction " << graph[*iterator].name << endl;
+            cout << "\tFunction " << graph.nameOf(*iterator) << endl;
         }
     }
 }
@@ -381,12 +447,13 @@ void Reports::printLeafFunctions() const {
     cout << "Leaf functions " << endl;
     for (vector<Function>::const_iterator iterator = functions.begin(); iterator != functions.end(); ++iterator) {
         if (!filter(*iterator)) {
-            cout << "\tFunction " << graph[*iterator].name << endl;
+            cout << "\tFunction " << graph.nameOf(*iterator) << endl;
         }
     }
 }
 
 void Reports::printParetoFunctions() const {
+    const FrozenGraph& frozen = graph.getFrozenGraph();
     vector<Function> functions;
 
     FunctionIterator first, last;
@@ -394,14 +461,14 @@ void Reports::printParetoFunctions() const {
         functions.push_back(*first);
     }
 
-    sort(functions.rbegin(), functions.rend(), SortBySelfCosts(graph));
+    sort(functions.rbegin(), functions.rend(), SortBySelfCosts(frozen));
 
     double cumulativeCost = 0;
     unsigned int number = 0;
 
     cout << "Functions taking 80% of the run time" << endl;
     for (vector<Function>::const_iterator iterator = functions.begin(); iterator != functions.end(); ++iterator) {
-        cumulativeCost += graph[*iterator].self_cost;
+        cumulativeCost += frozen.selfCost(*iterator);
 
         if (cumulativeCost > 80.0) {
             break;
@@ -409,7 +476,7 @@ void Reports::printParetoFunctions() const {
 
         ++number;
 
-        cout << "\tFunction " << graph[*iterator].name << endl;
+        cout << "\tFunction " << graph.nameOf(*iterator) << endl;
     }
 
     cout << (100.0 * static_cast<double>(number) / static_cast<double>(graph.numberOfFunctions())) << "% of the functions take 80% of the run time" << endl;
@@ -0,0 +1,174 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <cstring>
+
+#include "SnapshotReader.hpp"
+#include "Snapshot.hpp"
+#include "MappedFile.hpp"
+#include "CallGraph.hpp"
+#include "GraphBuilder.hpp"
+#include "Infos.hpp"
+#include "Logging.hpp"
+#include "Timer.hpp"
+
+using namespace std;
+using namespace inlining;
+
+CallGraph* SnapshotReader::read(const string& file) {
+    DEBUG cout << "DEBUG : Loading the snapshot " << file << endl;
+
+    Timer timer;
+
+    MappedFile mapped(file);
+    if (!mapped.isOpen()) {
+        return NULL;
+    }
+
+    if (mapped.size() < sizeof(SnapshotHeader)) {
+        ERROR cout << "ERROR : " << file << " is not a snapshot" << endl;
+        return NULL;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, mapped.begin(), sizeof(header));
+
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        ERROR cout << "ERROR : " << file << " is not a snapshot" << endl;
+        return NULL;
+    }
+
+    if (header.byteOrder != SNAPSHOT_BYTE_ORDER) {
+        ERROR cout << "ERROR : The snapshot " << file << " has been written on another architecture" << endl;
+        return NULL;
+    }
+
+    if (header.version != SNAPSHOT_VERSION) {
+        ERROR cout << "ERROR : Unsupported snapshot version " << header.version << ", expected " << SNAPSHOT_VERSION << endl;
+        return NULL;
+    }
+
+    //Locate the sections
+    uint64_t functionsOffset = sizeof(SnapshotHeader);
+    uint64_t callSitesOffset = functionsOffset + alignSection(header.functions * sizeof(SnapshotFunction));
+    uint64_t offsetsOffset = callSitesOffset + alignSection(header.callSites * sizeof(SnapshotCallSite));
+    uint64_t librariesOffset = offsetsOffset + alignSection((header.strings + 1ULL) * sizeof(uint64_t));
+    uint64_t virtualsOffset = librariesOffset + alignSection(header.libraries * sizeof(uint32_t));
+    uint64_t charactersOffset = virtualsOffset + alignSection(header.virtualFunctions * sizeof(uint32_t));
+
+    if (charactersOffset + header.characters != mapped.size()) {
+        ERROR cout << "ERROR : The snapshot " << file << " is truncated or corrupted" << endl;
+        return NULL;
+    }
+
+    const SnapshotFunction* functions = reinterpret_cast<const SnapshotFunction*>(mapped.begin() + functionsOffset);
+    const SnapshotCallSite* callSites = reinterpret_cast<const SnapshotCallSite*>(mapped.begin() + callSitesOffset);
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(mapped.begin() + offsetsOffset);
+    const uint32_t* libraries = reinterpret_cast<const uint32_t*>(mapped.begin() + librariesOffset);
+    const uint32_t* virtuals = reinterpret_cast<const uint32_t*>(mapped.begin() + virtualsOffset);
+    const char* characters = mapped.begin() + charactersOffset;
+
+    if (offsets[header.strings] != header.characters) {
+        ERROR cout << "ERROR : The snapshot " << file << " is truncated or corrupted" << endl;
+        return NULL;
+    }
+
+    //The strings reference the mapped file, they must be copied to outlive the reading
+    auto stringAt = [&](uint32_t index) -> StringRef {
+        if (index >= header.strings || offsets[index] > offsets[index + 1] || offsets[index + 1] > header.characters) {
+            return StringRef();
+        }
+
+        return StringRef(characters + offsets[index], characters + offsets[index + 1]);
+    };
+
+    Graph* graph = new Graph(header.functions);
+
+    StringPool& strings = stringsOf(*graph);
+    StringArena& arena = arenaOf(*graph);
+
+    //The totals of the header are checked against the functions, the analysis divides by them
+    unsigned int totalCalls = 0;
+    unsigned int totalSize = 0;
+
+    for (uint32_t i = 0; i < header.functions; ++i) {
+        const SnapshotFunction& record = functions[i];
+        vertex_info& function = (*graph)[vertex(i, *graph)];
+
+        function.name = arena.store(stringAt(record.name));
+        function.module = strings.intern(stringAt(record.module));
+        function.file_name = strings.intern(stringAt(record.fileName));
+        function.self_cost = record.selfCost;
+        function.inclusive_cost = record.inclusiveCost;
+        function.frequency = record.frequency;
+        function.calls = record.calls;
+        function.parameters = record.parameters;
+        function.size = record.size;
+        function.virtuality = record.virtuality != 0;
+
+        totalCalls += record.calls;
+        totalSize += record.size;
+    }
+
+    if (totalCalls != header.calls || totalSize != header.applicationSize) {
+        ERROR cout << "ERROR : The snapshot " << file << " is truncated or corrupted" << endl;
+        delete graph;
+        return NULL;
+    }
+
+    GraphBuilder builder(threads, memoryCap);
+    builder.reserve(header.callSites);
+
+    for (uint32_t i = 0; i < header.callSites; ++i) {
+        const SnapshotCallSite& record = callSites[i];
+
+        if (record.source >= header.functions || record.target >= header.functions) {
+            ERROR cout << "ERROR : The snapshot " << file << " is truncated or corrupted" << endl;
+            delete graph;
+            return NULL;
+        }
+
+        builder.addCall(record.source, record.target, record.calls, record.cost);
+    }
+
+    //A snapshot is already complete, its Infos are only restored for a complete graph
+    for (uint32_t i = 0; complete && i < header.libraries; ++i) {
+        infos.addLibrary(stringAt(libraries[i]).str());
+    }
+
+    for (uint32_t i = 0; complete && i < header.virtualFunctions; ++i) {
+        infos.addVirtualFunction(stringAt(virtuals[i]).str());
+    }
+
+    CallGraph* callGraph = builder.build(graph);
+    callGraph->setNumberOfCalls(header.calls);
+    callGraph->setApplicationSize(header.applicationSize);
+
+    //The frequencies are restored, the graph is not completed again
+    CallSiteTable& table = callGraph->callSites();
+    for (FrozenCallSite callSite = 0; callSite < table.numberOfCallSites(); ++callSite) {
+        table.setFrequency(callSite, callSites[callSite].frequency);
+    }
+
+    DEBUG cout << "DEBUG : Number of edges : " << callGraph->numberOfCallSites() << endl;
+    DEBUG cout << "DEBUG : Number of vertices : " << num_vertices(*graph) << endl;
+    PERF cout << "PERF : Snapshot loaded in " << timer.elapsed() << "ms" << endl;
+
+    return callGraph;
+}
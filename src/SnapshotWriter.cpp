@@ -0,0 +1,184 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+
+#include "SnapshotWriter.hpp"
+#include "Snapshot.hpp"
+#include "CallGraph.hpp"
+#include "Infos.hpp"
+#include "Logging.hpp"
+#include "Timer.hpp"
+
+using namespace std;
+using namespace inlining;
+
+namespace {
+
+/*!
+ * \brief Gives a unique index to each distinct string.
+ */
+struct StringTable {
+    vector<const string*> strings;
+    unordered_map<string, uint32_t> indexes;
+    uint64_t characters;
+
+    StringTable() : characters(0) {}
+
+    uint32_t intern(const string& value) {
+        auto result = indexes.insert(make_pair(value, static_cast<uint32_t>(strings.size())));
+
+        if (result.second) {
+            strings.push_back(&result.first->first);
+            characters += value.size();
+        }
+
+        return result.first->second;
+    }
+};
+
+} //end of anonymous namespace
+
+static void writePadding(ofstream& stream, uint64_t size) {
+    static const char zeros[8] = {0};
+    stream.write(zeros, alignSection(size) - size);
+}
+
+template<typename T>
+static void writeSection(ofstream& stream, const vector<T>& section) {
+    uint64_t size = section.size() * sizeof(T);
+
+    if (size > 0) {
+        stream.write(reinterpret_cast<const char*>(&section[0]), size);
+    }
+
+    writePadding(stream, size);
+}
+
+bool SnapshotWriter::write(const CallGraph& graph, const string& file) {
+    Timer timer;
+
+    StringTable table;
+
+    vector<SnapshotFunction> functions;
+    functions.reserve(graph.numberOfFunctions());
+
+    FunctionIterator first, last;
+    for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
+        const vertex_info& function = graph[*first];
+
+        SnapshotFunction record;
+        record.selfCost = function.self_cost;
+        record.inclusiveCost = function.inclusive_cost;
+        record.frequency = function.frequency;
+        record.calls = function.calls;
+        record.parameters = function.parameters;
+        record.size = function.size;
+        record.virtuality = function.virtuality ? 1 : 0;
+        record.name = table.intern(function.name.str());
+        record.module = table.intern(graph.moduleOf(*first));
+        record.fileName = table.intern(graph.fileNameOf(*first));
+        record.padding = 0;
+
+        functions.push_back(record);
+    }
+
+    vector<SnapshotCallSite> callSites;
+    callSites.reserve(graph.numberOfCallSites());
+
+    const CallSiteTable& sites = graph.callSites();
+
+    for (FrozenCallSite callSite = 0; callSite < sites.numberOfCallSites(); ++callSite) {
+        SnapshotCallSite record;
+        record.cost = sites.cost(callSite);
+        record.frequency = sites.frequency(callSite);
+        record.source = sites.source(callSite);
+        record.target = sites.target(callSite);
+        record.calls = sites.calls(callSite);
+        record.padding = 0;
+
+        callSites.push_back(record);
+    }
+
+    vector<uint32_t> libraries;
+    for (auto& library : infos.getLibraries()) {
+        libraries.push_back(table.intern(library));
+    }
+
+    vector<uint32_t> virtualFunctions;
+    for (auto& function : infos.getVirtualFunctions()) {
+        virtualFunctions.push_back(table.intern(function));
+    }
+
+    //The offset of each string in the characters and the end of the last one
+    vector<uint64_t> offsets;
+    offsets.reserve(table.strings.size() + 1);
+
+    uint64_t offset = 0;
+    for (auto value : table.strings) {
+        offsets.push_back(offset);
+        offset += value->size();
+    }
+    offsets.push_back(offset);
+
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.functions = functions.size();
+    header.callSites = callSites.size();
+    header.strings = table.strings.size();
+    header.libraries = libraries.size();
+    header.virtualFunctions = virtualFunctions.size();
+    header.calls = graph.getNumberOfCalls();
+    header.applicationSize = graph.getApplicationSize();
+    header.padding = 0;
+    header.characters = table.characters;
+
+    ofstream stream(file.c_str(), ios::out | ios::binary | ios::trunc);
+
+    if (!stream) {
+        ERROR cout << "ERROR : cannot open " << file << " for writing" << endl;
+        return false;
+    }
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    writeSection(stream, functions);
+    writeSection(stream, callSites);
+    writeSection(stream, offsets);
+    writeSection(stream, libraries);
+    writeSection(stream, virtualFunctions);
+
+    for (auto value : table.strings) {
+        stream.write(value->data(), value->size());
+    }
+
+    if (!stream) {
+        ERROR cout << "ERROR : cannot write the snapshot " << file << endl;
+        return false;
+    }
+
+    PERF cout << "PERF : Snapshot written in " << timer.elapsed() << "ms" << endl;
+
+    return true;
+}
@@ -0,0 +1,417 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <iostream>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "StreamReader.hpp"
+#include "Decompressor.hpp"
+#include "BoundedQueue.hpp"
+#include "DotParser.hpp"
+#include "CallGraph.hpp"
+#include "Infos.hpp"
+#include "Logging.hpp"
+#include "Timer.hpp"
+#include "GraphBuilder.hpp"
+
+using namespace std;
+using namespace inlining;
+
+namespace {
+
+struct StreamNode {
+    StringRef name;
+    StringRef label;
+    StringRef module;
+    StringRef fileName;
+    double inclusiveCost;
+    double selfCost;
+    unsigned int calls;
+
+    explicit StreamNode(const StringRef& n) : name(n), inclusiveCost(0.0), selfCost(0.0), calls(0) {}
+};
+
+struct StreamEdge {
+    unsigned int source;
+    unsigned int target;
+    unsigned int calls;
+    double cost;
+    StringRef label;
+};
+
+/*!
+ * \brief The state of the parsing stage. The blocks are kept alive, the nodes reference them.
+ */
+struct StreamGraph {
+    deque<string> blocks;
+    unordered_map<StringRef, unsigned int, StringRefHash> index;
+    unordered_set<StringRef, StringRefHash> modules;
+    vector<StreamNode> nodes;
+    vector<StreamEdge> edges;
+    bool started;
+    bool closed;
+    bool failed;
+
+    StreamGraph() : started(false), closed(false), failed(false) {}
+
+    unsigned int intern(const StringRef& name) {
+        auto result = index.insert(make_pair(name, static_cast<unsigned int>(nodes.size())));
+
+        if (result.second) {
+            nodes.push_back(StreamNode(name));
+        }
+
+        return result.first->second;
+    }
+};
+
+} //end of anonymous namespace
+
+//Return the end of the last complete statement of the buffer, the lines before scanned have already been examined and
+//scanned is moved after the last complete line
+static const char* lastStatement(const char* begin, const char* end, const char*& scanned) {
+    const char* last = begin;
+
+    const char* next;
+    while ((next = nextStatement(scanned, end)) != end) {
+        last = next;
+        scanned = next;
+    }
+
+    //The complete lines after the last statement do not end a statement, only the last line can still end one
+    const char* newLine = static_cast<const char*>(memrchr(scanned, '\n', end - scanned));
+    if (newLine) {
+        scanned = newLine + 1;
+    }
+
+    return last;
+}
+
+//Stage 1 : Read and decompress the stream and cut it in blocks of complete statements
+static void readBlocks(int fd, size_t blockSize, BoundedQueue<string>& blocks, bool& failed) {
+    string pending;
+    vector<char> buffer(std::max<size_t>(blockSize, 4));
+
+    Decompressor decompressor;
+    size_t buffered = 0;
+    size_t scanned = 0;
+    bool started = false;
+
+    while (true) {
+        ssize_t count = ::read(fd, &buffer[buffered], buffer.size() - buffered);
+
+        if (count < 0) {
+            ERROR cout << "ERROR : Unable to read the stream" << endl;
+            failed = true;
+            break;
+        }
+
+        if (count > 0) {
+            buffered += count;
+        }
+
+        //The compression is detected from the first bytes
+        if (!started && (buffered >= 4 || count <= 0)) {
+            if (!decompressor.start(&buffer[0], buffered)) {
+                failed = true;
+                break;
+            }
+
+            started = true;
+        }
+
+        if (started && buffered > 0) {
+            if (!decompressor.feed(&buffer[0], buffered, pending)) {
+                failed = true;
+                break;
+            }
+
+            buffered = 0;
+
+            //Only the new lines are examined, a statement that does not end is not scanned again at each read
+            const char* position = pending.data() + scanned;
+            const char* cut = lastStatement(pending.data(), pending.data() + pending.size(), position);
+            scanned = position - pending.data();
+
+            if (cut > pending.data()) {
+                size_t length = cut - pending.data();
+
+                blocks.push(pending.substr(0, length));
+                pending.erase(0, length);
+                scanned -= length;
+            }
+        }
+
+        if (count <= 0) {
+            break;
+        }
+    }
+
+    //The end of the graph, a stream that cannot be read is not parsed
+    if (!failed && !pending.empty()) {
+        blocks.push(pending);
+    }
+
+    blocks.close();
+}
+
+//Stage 2 : Parse a block and send the new modules to the ELF stage
+static void parseBlock(StreamGraph& graph, const string& block, BoundedQueue<string>& libraries, unsigned int fields) {
+    const char* begin = block.data();
+    const char* end = begin + block.size();
+
+    if (!graph.started) {
+        DotParser header(begin, end);
+
+        if (!header.header()) {
+            graph.failed = true;
+            return;
+        }
+
+        begin = header.position();
+        graph.started = true;
+    }
+
+    DotParser parser(begin, end, true);
+
+    DotStatement statement;
+    while (parser.next(statement)) {
+        unsigned int source = graph.intern(statement.source);
+
+        if (statement.edge) {
+            StreamEdge edge;
+            edge.source = source;
+            edge.target = graph.intern(statement.target);
+            edge.calls = 0;
+            edge.cost = 0.0;
+            edge.label = statement.label;
+
+            if (!statement.label.empty()) {
+                decodeCallSiteLabel(statement.label, edge.cost, edge.calls, fields);
+            }
+
+            graph.edges.push_back(edge);
+
+            continue;
+        }
+
+        //Like boost, the last value of an attribute wins
+        StreamNode& node = graph.nodes[source];
+
+        if (!statement.label.empty()) {
+            node.label = statement.label;
+            decodeFunctionLabel(statement.label, node.inclusiveCost, node.selfCost, node.calls, fields);
+        }
+
+        if (!statement.fileName.empty()) {
+            node.fileName = statement.fileName;
+        }
+
+        if (!statement.module.empty()) {
+            node.module = statement.module;
+
+            if (graph.modules.insert(statement.module).second) {
+                libraries.push(unescape(statement.module));
+            }
+        }
+    }
+
+    graph.failed = parser.failed() || graph.closed;
+    graph.closed = parser.isClosed();
+}
+
+CallGraph* StreamReader::read(const string& file) {
+    DEBUG cout << "DEBUG : Streaming the .dot file " << file << endl;
+
+    Timer timer;
+
+    int fd = file == "-" ? 0 : open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ERROR cout << "ERROR : Unable to open " << file << endl;
+        return NULL;
+    }
+
+    BoundedQueue<string> blocks(queueSize);
+    BoundedQueue<string> libraries(queueSize);
+
+    bool failed = false;
+    std::thread reader(readBlocks, fd, blockSize, std::ref(blocks), std::ref(failed));
+
+    //Stage 3 : Parse the ELF file of each new module
+    std::thread loader([this, &libraries](){
+        string library;
+        while (libraries.pop(library)) {
+            //The libraries are only necessary to complete the graph
+            if (complete) {
+                infos.loadLibrary(library);
+            }
+        }
+    });
+
+    StreamGraph graph;
+
+    string block;
+    while (blocks.pop(block)) {
+        //Once the stream is invalid, the remaining blocks are only consumed to release the reader
+        if (graph.failed) {
+            continue;
+        }
+
+        graph.blocks.push_back(string());
+        graph.blocks.back().swap(block);
+
+        parseBlock(graph, graph.blocks.back(), libraries, fields);
+    }
+
+    libraries.close();
+
+    reader.join();
+    loader.join();
+
+    if (fd != 0) {
+        close(fd);
+    }
+
+    if (failed) {
+        ERROR cout << "ERROR : " << file << " cannot be read" << endl;
+        return NULL;
+    }
+
+    if (graph.failed || !graph.closed) {
+        ERROR cout << "ERROR : " << file << " is not a valid dot graph" << endl;
+        return NULL;
+    }
+
+    PERF cout << "PERF : Stream parsed in " << timer.elapsed() << "ms" << endl;
+
+    //Number the vertices in the order of their names, like boost::read_graphviz
+    vector<unsigned int> order(graph.nodes.size());
+    for (unsigned int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(), [&graph](unsigned int lhs, unsigned int rhs){ return graph.nodes[lhs].name < graph.nodes[rhs].name; });
+
+    vector<Function> functions(order.size());
+
+    Graph* g = new Graph(order.size());
+
+    StringPool& strings = stringsOf(*g);
+    StringArena& arena = arenaOf(*g);
+
+    for (unsigned int i = 0; i < order.size(); ++i) {
+        const StreamNode& node = graph.nodes[order[i]];
+
+        functions[order[i]] = i;
+
+        vertex_info& function = (*g)[vertex(i, *g)];
+        char* name = arena.allocate(node.name.size() + 1);
+        size_t size = unescape(node.name, name);
+        name[size] = '\0';
+        function.name = StringRef(name, name + size);
+        function.module = strings.intern(unescape(node.module));
+        function.file_name = strings.intern(unescape(node.fileName));
+        function.inclusive_cost = node.inclusiveCost;
+        function.self_cost = node.selfCost;
+        function.calls = node.calls;
+    }
+
+    GraphBuilder builder(threads, memoryCap);
+    builder.reserve(graph.edges.size());
+
+    for (auto& edge : graph.edges) {
+        builder.addCall(functions[edge.source], functions[edge.target], edge.calls, edge.cost);
+    }
+
+    CallGraph* callGraph = builder.build(g);
+
+    //The blocks are released at the end of the reading, the labels are copied to decode the other fields later
+    if (fields != ALL_FIELDS) {
+        size_t characters = 0;
+        for (auto& node : graph.nodes) {
+            characters += node.label.size();
+        }
+
+        for (auto& edge : graph.edges) {
+            characters += edge.label.size();
+        }
+
+        bool map = memoryCap > 0 && characters + (order.size() + graph.edges.size()) * sizeof(RawLabel) > memoryCap;
+
+        Column<char> buffer;
+        Column<RawLabel> functionLabels;
+        Column<RawLabel> callSiteLabels;
+
+        buffer.allocate(characters, map);
+        functionLabels.allocate(order.size(), map);
+        callSiteLabels.allocate(graph.edges.size(), map);
+
+        //The written pages are released by blocks of labels
+        const size_t BLOCK = 1 << 16;
+
+        size_t offset = 0;
+        size_t first = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            const StringRef& label = graph.nodes[order[i]].label;
+
+            functionLabels[i] = {offset, label.size()};
+            std::copy(label.begin, label.end, buffer.data() + offset);
+            offset += label.size();
+
+            if ((i + 1) % BLOCK == 0 || i + 1 == order.size()) {
+                functionLabels.evict(i - i % BLOCK, i + 1);
+                buffer.evict(first, offset);
+                first = offset;
+            }
+        }
+
+        for (size_t i = 0; i < graph.edges.size(); ++i) {
+            const StringRef& label = graph.edges[i].label;
+
+            callSiteLabels[i] = {offset, label.size()};
+            std::copy(label.begin, label.end, buffer.data() + offset);
+            offset += label.size();
+
+            if ((i + 1) % BLOCK == 0 || i + 1 == graph.edges.size()) {
+                callSiteLabels.evict(i - i % BLOCK, i + 1);
+                buffer.evict(first, offset);
+                first = offset;
+            }
+        }
+
+        callGraph->setRawLabels(buffer, functionLabels, callSiteLabels);
+    }
+
+    callGraph->setDecodedFields(fields);
+
+    //The libraries have already been parsed by the third stage
+    completeGraph(*callGraph);
+
+    PERF cout << "PERF : Importation finished in " << timer.elapsed() << "ms" << endl;
+
+    return callGraph;
+}
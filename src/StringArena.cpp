@@ -0,0 +1,95 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include <cstring>
+#include <algorithm>
+
+#include "StringArena.hpp"
+
+using namespace inlining;
+
+namespace {
+
+//Large enough to make the allocation of the chunks negligible, small enough to not waste memory on small graphs
+const std::size_t CHUNK_SIZE = 64 * 1024;
+
+} //end of anonymous namespace
+
+StringArena::~StringArena() {
+    clear();
+}
+
+void StringArena::clear() {
+    for (auto chunk : chunks) {
+        delete[] chunk;
+    }
+
+    std::vector<char*>().swap(chunks);
+    position = NULL;
+    remaining = 0;
+    used = 0;
+    reserved = 0;
+}
+
+void StringArena::swap(StringArena& rhs) {
+    std::swap(chunks, rhs.chunks);
+    std::swap(position, rhs.position);
+    std::swap(remaining, rhs.remaining);
+    std::swap(used, rhs.used);
+    std::swap(reserved, rhs.reserved);
+}
+
+char* StringArena::allocate(std::size_t size) {
+    used += size;
+
+    if (size > remaining) {
+        //The large strings have their own chunk, the end of the current chunk is kept for the next strings
+        if (size > CHUNK_SIZE / 4) {
+            char* chunk = new char[size];
+            chunks.push_back(chunk);
+            reserved += size;
+
+            return chunk;
+        }
+
+        position = new char[CHUNK_SIZE];
+        remaining = CHUNK_SIZE;
+        chunks.push_back(position);
+        reserved += CHUNK_SIZE;
+    }
+
+    char* result = position;
+
+    position += size;
+    remaining -= size;
+
+    return result;
+}
+
+StringRef StringArena::store(const StringRef& value) {
+    char* copy = allocate(value.size() + 1);
+
+    if (!value.empty()) {
+        memcpy(copy, value.begin, value.size());
+    }
+
+    copy[value.size()] = '\0';
+
+    return StringRef(copy, copy + value.size());
+}
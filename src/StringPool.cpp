@@ -0,0 +1,58 @@
+/*
+Copyright (C) 2011 Baptiste Wicht
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "StringPool.hpp"
+
+using namespace inlining;
+
+StringPool::StringPool() {
+    intern(StringRef());
+}
+
+StringPool::StringPool(const StringPool& rhs) {
+    *this = rhs;
+}
+
+StringPool& StringPool::operator=(const StringPool& rhs) {
+    if (this != &rhs) {
+        strings.clear();
+        ids.clear();
+
+        for (auto& value : rhs.strings) {
+            intern(StringRef(value));
+        }
+    }
+
+    return *this;
+}
+
+StringId StringPool::intern(const StringRef& value) {
+    auto found = ids.find(value);
+
+    if (found != ids.end()) {
+        return found->second;
+    }
+
+    StringId id = strings.size();
+
+    strings.push_back(value.str());
+    ids.insert(std::make_pair(StringRef(strings.back()), id));
+
+    return id;
+}
@@ -79,7 +79,7 @@ int main(int argc, const char* argv[]) {
     //Print the declarations
     FunctionIterator first, last;
     for (boost::tie(first, last) = graph->functions(); first != last; ++first) {
-        string name = (*graph)[*first].name;
+        string name = (*graph)[*first].name.str();
 
         transform(name);
 
@@ -97,7 +97,7 @@ int main(int argc, const char* argv[]) {
 
     //Print the definitions
     for (boost::tie(first, last) = graph->functions(); first != last; ++first) {
-        string name = (*graph)[*first].name;
+        string name = (*graph)[*first].name.str();
 
         transform(name);
 
@@ -109,9 +109,10 @@ int main(int argc, const char* argv[]) {
         stream << "void FFF" << name << "() {" << endl;
         stream << "\tcout << \"I'm in " << name << "\" << endl;" << endl;
 
-        OutCallSiteIterator it, end;
-        for (boost::tie(it, end) = boost::out_edges(*first, *graph->getGraph()); it != end; ++it) {
-            string called = (*graph)[boost::target(*it, *graph->getGraph())].name;
+        const FrozenCallSite* it;
+        const FrozenCallSite* end;
+        for (boost::tie(it, end) = graph->callSites().outCallSites(*first); it != end; ++it) {
+            string called = (*graph)[graph->target(*it)].name.str();
 
             transform(called);
 
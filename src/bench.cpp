@@ -28,27 +28,43 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <boost/graph/adjacency_list.hpp>
 #include "boost/graph/breadth_first_search.hpp"
 #include <boost/graph/depth_first_search.hpp>
+#include <boost/graph/strong_components.hpp>
 
 #include "Timer.hpp"
 #include "Graph.hpp"
 #include "CallGraph.hpp"
+#include "FrozenGraph.hpp"
+#include "CompressedNames.hpp"
+#include "GraphBuilder.hpp"
+#include "Reordering.hpp"
 #include "Infos.hpp"
 #include "InfosOld.hpp"
 #include "Analyzer.hpp"
 #include "Parameters.hpp"
+#include "CallgrindReader.hpp"
+#include "SnapshotReader.hpp"
+#include "SnapshotWriter.hpp"
+#include "StreamReader.hpp"
+#include "DotParser.hpp"
+#include "Utils.hpp"
 
 #include <unistd.h>
 #include <ios>
+#include <cstdlib>
 
 #define BENCH
 #include "GraphReader.cpp"
+#include "ProfileReader.cpp"
 
 static const double GRAPHS = 5;
 
 static double reading = 0;
 static double extraction = 0;
+static double fastReading = 0;
 static double foreachVertices = 0;
 static double foreachEdges = 0;
+static double foreachColumnVertices = 0;
+static double foreachColumnEdges = 0;
 static double dfs = 0;
 static double bfs = 0;
 static double analyzeVertices = 0;
@@ -56,6 +72,11 @@ static double analyzeEdges = 0;
 static double clustering = 0;
 static double library = 0;
 static double circular = 0;
+static double freezing = 0;
+static double components = 0;
+static double frozenComponents = 0;
+static double serialBuilding = 0;
+static double building = 0;
 
 using std::vector;
 using std::cout;
@@ -69,11 +90,11 @@ void benchReading(Graph* graph, string file) {
     Timer timer;
 
     dynamic_properties dp;
-    dp.property("node_id", get(&vertex_info::name, *graph));
-    dp.property("label", get(&vertex_info::label, *graph));
-    dp.property("filename", get(&vertex_info::file_name, *graph));
-    dp.property("module", get(&vertex_info::module, *graph));
-    dp.property("label", get(&edge_info::label, *graph));
+    dp.property("node_id", arenaMap(*graph, &vertex_info::name));
+    dp.property("label", arenaMap(*graph, &vertex_info::label));
+    dp.property("filename", InternedPropertyMap(*graph, &vertex_info::file_name));
+    dp.property("module", InternedPropertyMap(*graph, &vertex_info::module));
+    dp.property("label", arenaMap(*graph, &edge_info::label));
 
     ref_property_map<Graph*, string> gname(get_property(*graph, graph_name));
     dp.property("name", gname);
@@ -88,6 +109,18 @@ void benchReading(Graph* graph, string file) {
     reading += timer.elapsed();
 }
 
+void benchFastReading(string file) {
+    Timer timer;
+
+    Infos infos;
+    GraphReader reader(infos);
+    CallGraph* graph = reader.read(file);
+
+    fastReading += timer.elapsed();
+
+    delete graph;
+}
+
 void benchExtraction(CallGraph* graph) {
     Timer timer;
 
@@ -100,33 +133,54 @@ void benchExtraction(CallGraph* graph) {
 
 static double fakeSum = 0;
 
-void benchForeachVertices(const CallGraph& graph) {
+//The same field is summed from the bundled properties and from the column of the frozen graph
+void benchForeachVertices(CallGraph& graph) {
     double sum = 0;
 
     Timer timer;
 
     FunctionIterator first, last;
     for (boost::tie(first, last) = graph.functions(); first != last; ++first) {
-        sum += graph[*first].temperature;
+        sum += graph[*first].frequency;
     }
 
     foreachVertices += timer.elapsed();
 
+    const FrozenGraph& frozen = graph.freeze();
+
+    Timer columnTimer;
+
+    for (Function function = 0; function < frozen.numberOfFunctions(); ++function) {
+        sum += frozen.frequency(function);
+    }
+
+    foreachColumnVertices += columnTimer.elapsed();
+
     fakeSum += sum;
 }
 
-void benchForeachEdges(const CallGraph& graph) {
+void benchForeachEdges(CallGraph& graph) {
     double sum = 0;
 
     Timer timer;
 
-    CallSiteIterator first, last;
-    for (boost::tie(first, last) = graph.callSites(); first != last; ++first) {
-        sum += graph[*first].temperature;
+    const CallSiteTable& table = graph.callSites();
+    for (FrozenCallSite site = 0; site < table.numberOfCallSites(); ++site) {
+        sum += table.frequency(site);
     }
 
     foreachEdges += timer.elapsed();
 
+    const FrozenGraph& frozen = graph.freeze();
+
+    Timer columnTimer;
+
+    for (FrozenCallSite site = 0; site < frozen.numberOfCallSites(); ++site) {
+        sum += frozen.callSiteFrequency(site);
+    }
+
+    foreachColumnEdges += columnTimer.elapsed();
+
     fakeSum += sum;
 }
 
@@ -135,7 +189,7 @@ class CountBFSVisitor : public default_bfs_visitor {
         unsigned int* count;
         explicit CountBFSVisitor(unsigned int* c) : default_bfs_visitor(), count(c) {}
         CountBFSVisitor(const CountBFSVisitor& vis) : default_bfs_visitor(), count(vis.count) {}
-        void discover_vertex(Function, const Graph&) {
+        void discover_vertex(Function, const FrozenGraph&) {
             (*count)++;
         }
 };
@@ -147,10 +201,10 @@ void benchBFS(CallGraph* graph) {
 
     CountBFSVisitor vis(&count);
 
-    FunctionIterator first, last;
-    boost::tie(first, last) = graph->functions();
+    //The call sites are only in the call site table, the search goes through the adapters of the frozen graph
+    const FrozenGraph& frozen = graph->freeze();
 
-    breadth_first_search(*graph->getGraph(), *first, visitor(vis));
+    breadth_first_search(frozen, 0, visitor(vis));
 
     bfs += timer.elapsed();
 }
@@ -160,7 +214,7 @@ class CountDFSVisitor : public default_dfs_visitor {
         unsigned int* count;
         explicit CountDFSVisitor(unsigned int* c) : default_dfs_visitor(), count(c) {}
         CountDFSVisitor(const CountDFSVisitor& vis) : default_dfs_visitor(), count(vis.count) {}
-        void discover_vertex(Function, const Graph&) {
+        void discover_vertex(Function, const FrozenGraph&) {
             (*count)++;
         }
 };
@@ -172,10 +226,9 @@ void benchDFS(CallGraph* graph) {
 
     CountDFSVisitor vis(&count);
 
-    FunctionIterator first, last;
-    boost::tie(first, last) = graph->functions();
+    const FrozenGraph& frozen = graph->freeze();
 
-    depth_first_search(*graph->getGraph(), boost::visitor(vis));
+    depth_first_search(frozen, boost::visitor(vis));
 
     dfs += timer.elapsed();
 }
@@ -200,9 +253,8 @@ void benchAnalyzingEdges(CallGraph& graph) {
 
     Timer timer;
 
-    CallSiteIterator cit, cend;
-    for (boost::tie(cit, cend) = graph.callSites(); cit != cend; ++cit) {
-        analyzer.computeCallSiteTemperature(*cit);
+    for (FrozenCallSite site = 0; site < graph.getFrozenGraph().numberOfCallSites(); ++site) {
+        analyzer.computeCallSiteTemperature(site);
     }
 
     analyzeEdges += timer.elapsed();
@@ -252,12 +304,86 @@ void benchHierarchy(CallGraph& graph) {
     cout << "\tHierarchy done in " << timer.elapsed() << "ms" << endl;
 }
 
+void benchFrozenGraph(CallGraph& graph) {
+    Timer timer;
+
+    FrozenGraph frozen(graph);
+
+    freezing += timer.elapsed();
+
+    //The same algorithm on an adjacency list of the call sites and on the frozen graph through the adapters
+    const CallSiteTable& table = graph.callSites();
+
+    Graph adjacency(graph.numberOfFunctions());
+    for (FrozenCallSite site = 0; site < table.numberOfCallSites(); ++site) {
+        add_edge(table.source(site), table.target(site), adjacency);
+    }
+
+    Timer graphTimer;
+
+    vector<size_t> graphComponents(graph.numberOfFunctions());
+    size_t count = strong_components(adjacency, make_iterator_property_map(graphComponents.begin(), get(vertex_index, adjacency)));
+
+    components += graphTimer.elapsed();
+
+    Timer frozenTimer;
+
+    vector<size_t> frozenGraphComponents(frozen.numberOfFunctions());
+    size_t frozenCount = strong_components(frozen, make_iterator_property_map(frozenGraphComponents.begin(), get(vertex_index, frozen)));
+
+    frozenComponents += frozenTimer.elapsed();
+
+    if (count != frozenCount) {
+        cout << "\tDifferent components " << count << " " << frozenCount << endl;
+    }
+}
+
+//The call sites of the graph added one by one and with the builder
+void benchBuilding(CallGraph& graph) {
+    vector<RawCall> calls;
+
+    const CallSiteTable& table = graph.callSites();
+    for (FrozenCallSite site = 0; site < table.numberOfCallSites(); ++site) {
+        RawCall call = {table.source(site), table.target(site), table.calls(site), table.cost(site)};
+        calls.push_back(call);
+    }
+
+    Timer serialTimer;
+
+    Graph serial(graph.numberOfFunctions());
+    for (auto& call : calls) {
+        edge_info& callSite = serial[add_edge(call.caller, call.callee, serial).first];
+
+        callSite.calls = call.calls;
+        callSite.cost = call.cost;
+    }
+
+    serialBuilding += serialTimer.elapsed();
+
+    Timer timer;
+
+    GraphBuilder builder(defaultThreads());
+    builder.reserve(calls.size());
+
+    for (auto& call : calls) {
+        builder.addCall(call.caller, call.callee, call.calls, call.cost);
+    }
+
+    CallSiteTable built;
+    builder.build(built, graph.numberOfFunctions());
+
+    building += timer.elapsed();
+}
+
 void displayResults() {
     cout << "Results" << endl;
     cout << "\tReading done in " << (reading / GRAPHS) << "ms" << endl;
     cout << "\tExtraction done in " << (extraction / GRAPHS) << "ms" << endl;
+    cout << "\tFast reading and extraction done in " << (fastReading / GRAPHS) << "ms" << endl;
     cout << "\tForeach vertices done in " << (foreachVertices / GRAPHS) << "ms" << endl;
     cout << "\tForeach edges done in " << (foreachEdges / GRAPHS) << "ms" << endl;
+    cout << "\tForeach vertices on the columns done in " << (foreachColumnVertices / GRAPHS) << "ms" << endl;
+    cout << "\tForeach edges on the columns done in " << (foreachColumnEdges / GRAPHS) << "ms" << endl;
     cout << "\tBFS done in " << (bfs / GRAPHS) << "ms" << endl;
     cout << "\tDFS done in " << (dfs / GRAPHS) << "ms" << endl;
     cout << "\tAnalyzing vertices done in " << (analyzeVertices / GRAPHS) << "ms" << endl;
@@ -265,13 +391,21 @@ void displayResults() {
     cout << "\tClustering done in " << (clustering / GRAPHS) << "ms" << endl;
     cout << "\tLibrary issues done in " << (library / GRAPHS) << "ms" << endl;
     cout << "\tCircular dependencies done in " << (circular / GRAPHS) << "ms" << endl;
+    cout << "\tFreezing done in " << (freezing / GRAPHS) << "ms" << endl;
+    cout << "\tStrong components done in " << (components / GRAPHS) << "ms" << endl;
+    cout << "\tStrong components on the frozen graph done in " << (frozenComponents / GRAPHS) << "ms" << endl;
+    cout << "\tCall sites added one by one in " << (serialBuilding / GRAPHS) << "ms" << endl;
+    cout << "\tCall sites added by the builder in " << (building / GRAPHS) << "ms" << endl;
 }
 
 void initResults() {
     reading = 0;
     extraction = 0;
+    fastReading = 0;
     foreachVertices = 0;
     foreachEdges = 0;
+    foreachColumnVertices = 0;
+    foreachColumnEdges = 0;
     dfs = 0;
     bfs = 0;
     analyzeVertices = 0;
@@ -279,6 +413,11 @@ void initResults() {
     clustering = 0;
     library = 0;
     circular = 0;
+    freezing = 0;
+    components = 0;
+    frozenComponents = 0;
+    serialBuilding = 0;
+    building = 0;
 }
 
 void benchGraph(int size) {
@@ -298,10 +437,13 @@ void benchGraph(int size) {
         string graphFile = file + "_" + out2.str();
 
         Graph* graph = new Graph();
-        CallGraph* callGraph = new CallGraph(graph);
 
         benchReading(graph, graphFile);
+
+        CallGraph* callGraph = new CallGraph(graph);
+
         benchExtraction(callGraph);
+        benchFastReading(graphFile);
         benchForeachVertices(*callGraph);
         benchForeachEdges(*callGraph);
         benchDFS(callGraph);
@@ -311,6 +453,8 @@ void benchGraph(int size) {
         benchClustering(*callGraph);
         benchLibraryIssues(*callGraph);
         benchCircularDependencies(*callGraph);
+        benchFrozenGraph(*callGraph);
+        benchBuilding(*callGraph);
         //benchHierarchy(*callGraph); Not interesting because Infos do not parse file
 
         delete callGraph;
@@ -362,11 +506,11 @@ void benchMemory(int size) {
     Graph* graph = new Graph();
 
     dynamic_properties dp;
-    dp.property("node_id", get(&vertex_info::name, *graph));
-    dp.property("label", get(&vertex_info::label, *graph));
-    dp.property("filename", get(&vertex_info::file_name, *graph));
-    dp.property("module", get(&vertex_info::module, *graph));
-    dp.property("label", get(&edge_info::label, *graph));
+    dp.property("node_id", arenaMap(*graph, &vertex_info::name));
+    dp.property("label", arenaMap(*graph, &vertex_info::label));
+    dp.property("filename", InternedPropertyMap(*graph, &vertex_info::file_name));
+    dp.property("module", InternedPropertyMap(*graph, &vertex_info::module));
+    dp.property("label", arenaMap(*graph, &edge_info::label));
 
     ref_property_map<Graph*, string> gname(get_property(*graph, graph_name));
     dp.property("name", gname);
@@ -385,7 +529,202 @@ void benchMemory(int size) {
 
     cout << "Graph of size " << size << " takes vm:" << (vm / 1024.0) << "MB rss:" << (rss / 1024.0) << "MB" << endl;
 
+    //The names and the labels as they were stored before the arena, one std::string each
+    vector<string> strings;
+    strings.reserve(2 * (num_vertices(*graph) + num_edges(*graph)));
+
+    FunctionIterator firstVertex, lastVertex;
+    for (boost::tie(firstVertex, lastVertex) = vertices(*graph); firstVertex != lastVertex; ++firstVertex) {
+        strings.push_back((*graph)[*firstVertex].name.str());
+        strings.push_back((*graph)[*firstVertex].label.str());
+    }
+
+    CallSiteIterator firstEdge, lastEdge;
+    for (boost::tie(firstEdge, lastEdge) = edges(*graph); firstEdge != lastEdge; ++firstEdge) {
+        strings.push_back((*graph)[*firstEdge].name.str());
+        strings.push_back((*graph)[*firstEdge].label.str());
+    }
+
+    double stringsVm, stringsRss;
+    process_mem_usage(stringsVm, stringsRss);
+
+    cout << "Strings of size " << size << " take arena:" << (arenaOf(*graph).capacity() / (1024.0 * 1024.0)) << "MB std::string rss:" << ((stringsRss - rss) / 1024.0) << "MB" << endl;
+
+    //The names alone, in the arena and in a front-coded name table
+    vector<StringRef> names;
+    names.reserve(num_vertices(*graph));
+
+    size_t namesSize = 0;
+    for (boost::tie(firstVertex, lastVertex) = vertices(*graph); firstVertex != lastVertex; ++firstVertex) {
+        names.push_back((*graph)[*firstVertex].name);
+        namesSize += names.back().size() + 1;
+    }
+
+    Timer compressionTimer;
+    CompressedNames table(names);
+    double compression = compressionTimer.elapsed();
+
+    Timer decodingTimer;
+    size_t decoded = 0;
+    for (size_t id = 0; id < table.size(); ++id) {
+        decoded += table[id].size();
+    }
+    double decoding = decodingTimer.elapsed();
+
+    cout << "Names of size " << size << " take arena:" << (namesSize / (1024.0 * 1024.0)) << "MB name table:" << (table.bytes() / (1024.0 * 1024.0))
+         << "MB compressed in " << compression << "ms decoded in " << decoding << "ms (" << decoded << " characters)" << endl;
+
+    Timer stringsTimer;
+    vector<string>().swap(strings);
+    double stringsRelease = stringsTimer.elapsed();
+
+    Timer graphTimer;
     delete graph;
+    double graphRelease = graphTimer.elapsed();
+
+    cout << "Strings of size " << size << " released in std::string:" << stringsRelease << "ms graph with its arena:" << graphRelease << "ms" << endl;
+}
+
+//Return the value in KB of a field of /proc/self/status (VmHWM for the peak RSS, VmRSS for the current one)
+static double memoryStatus(const string& field) {
+    ifstream status("/proc/self/status");
+
+    string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size() + 1, field + ":") == 0) {
+            return atof(line.c_str() + field.size() + 1);
+        }
+    }
+
+    return 0.0;
+}
+
+//The peak RSS of the process is reset to the current RSS
+static void resetPeakMemory() {
+    std::ofstream clear("/proc/self/clear_refs");
+    clear << "5" << endl;
+}
+
+void benchLeanMemory(int size, bool boost, bool lean) {
+    std::stringstream out;
+    out << size;
+
+    string file = "../graphs/sparse" + out.str() + "_1";
+
+    resetPeakMemory();
+    double before = memoryStatus("VmRSS");
+
+    Infos infos;
+    GraphReader reader(infos);
+    reader.setUseBoost(boost);
+    reader.setFields(Analyzer::requiredFields());
+    reader.setLean(lean);
+
+    CallGraph* graph = reader.read(file);
+
+    double peak = memoryStatus("VmHWM");
+    double steady = memoryStatus("VmRSS");
+
+    cout << "Graph of size " << size << (boost ? " (boost)" : " (fast)") << (lean ? " lean" : " with labels")
+         << " peak rss:" << ((peak - before) / 1024.0) << "MB steady rss:" << ((steady - before) / 1024.0) << "MB" << endl;
+
+    delete graph;
+}
+
+//The analysis passes on a frozen graph on the heap and on a frozen graph mapped from temporary files
+void benchOutOfCore(int size, bool mapped) {
+    std::stringstream out;
+    out << size;
+
+    string file = "../graphs/sparse" + out.str() + "_1";
+
+    Infos infos;
+    GraphReader reader(infos);
+    reader.setFields(Analyzer::requiredFields());
+
+    CallGraph* graph = reader.read(file);
+
+    //A cap of one byte maps any frozen graph
+    graph->setMemoryCap(mapped ? 1 : 0);
+
+    resetPeakMemory();
+    double before = memoryStatus("VmRSS");
+
+    Timer timer;
+
+    Analyzer analyzer(*graph, infos);
+
+    double freezing = timer.elapsed();
+
+    analyzer.analyze();
+    analyzer.findInterLibraryCalls();
+    analyzer.findCircularDependencies();
+
+    double passes = timer.elapsed() - freezing;
+
+    double peak = memoryStatus("VmHWM");
+
+    cout << "Graph of size " << size << (graph->getFrozenGraph().isMapped() ? " mapped" : " on the heap") << " frozen in " << freezing
+         << "ms analyzed in " << passes << "ms peak rss:" << ((peak - before) / 1024.0) << "MB" << endl;
+
+    size_t functions = graph->numberOfFunctions();
+    size_t callSites = graph->numberOfCallSites();
+
+    size_t bytes = CallSiteTable::footprint(functions, callSites) + FrozenGraph::footprint(functions, callSites);
+    size_t perCallSite = CallSiteTable::footprint(0, callSites) + FrozenGraph::footprint(0, callSites);
+
+    cout << "\tCall site table and frozen columns " << (bytes / (1024.0 * 1024.0)) << "MB, "
+         << (perCallSite / static_cast<double>(callSites)) << " bytes per call site" << endl;
+
+    delete graph;
+}
+
+//The analysis passes after each reordering of the functions
+void benchReordering(int size, VertexOrder order, const string& name) {
+    std::stringstream out;
+    out << size;
+
+    string file = "../graphs/sparse" + out.str() + "_1";
+
+    Infos infos;
+    GraphReader reader(infos);
+    reader.setFields(Analyzer::requiredFields());
+
+    CallGraph* graph = reader.read(file);
+
+    Timer orderTimer;
+    graph->reorder(computeOrder(*graph, order));
+    double ordering = orderTimer.elapsed();
+
+    Analyzer analyzer(*graph, infos);
+
+    Timer analyzeTimer;
+    analyzer.analyze();
+    double analyzing = analyzeTimer.elapsed();
+
+    Timer clusterTimer;
+    analyzer.findClusters();
+    double clusters = clusterTimer.elapsed();
+
+    Timer libraryTimer;
+    analyzer.findLibraryIssues();
+    double libraries = libraryTimer.elapsed();
+
+    Timer circularTimer;
+    analyzer.findCircularDependencies();
+    double dependencies = circularTimer.elapsed();
+
+    cout << "Graph of size " << size << " in " << name << " order: reordered in " << ordering << "ms analyzed in " << analyzing << "ms clusters in " << clusters
+         << "ms library issues in " << libraries << "ms circular dependencies in " << dependencies << "ms" << endl;
+
+    delete graph;
+}
+
+void benchReorderings(int size) {
+    benchReordering(size, ORIGINAL_ORDER, "original");
+    benchReordering(size, RCM_ORDER, "rcm");
+    benchReordering(size, BFS_ORDER, "bfs");
+    benchReordering(size, MODULE_ORDER, "module");
 }
 
 void benchInfos(string file) {
@@ -420,6 +759,252 @@ void benchInfos(string file) {
     cout << "ELF parsing done in " << mean << "ms" << endl;
 }
 
+void benchCallgrind(string file) {
+    cout << "Read callgrind profile " << file << endl;
+
+    string dotFile = file + ".dot";
+    string command = "python ../tools/converter.py --format=callgrind --output=" + dotFile + " " + file;
+
+    double conversion = 0;
+    double dotReading = 0;
+    double callgrindReading = 0;
+
+    for (int i = 0; i < GRAPHS; ++i) {
+        Timer timer;
+        if (system(command.c_str()) != 0) {
+            cout << "Conversion of " << file << " failed" << endl;
+            return;
+        }
+        conversion += timer.elapsed();
+
+        Infos infos;
+
+        Timer dotTimer;
+        GraphReader graphReader(infos);
+        delete graphReader.read(dotFile);
+        dotReading += dotTimer.elapsed();
+
+        Timer callgrindTimer;
+        CallgrindReader callgrindReader(infos);
+        delete callgrindReader.read(file);
+        callgrindReading += callgrindTimer.elapsed();
+    }
+
+    cout << "\tConversion done in " << (conversion / GRAPHS) << "ms" << endl;
+    cout << "\tDot reading done in " << (dotReading / GRAPHS) << "ms" << endl;
+    cout << "\tConverter pipeline done in " << ((conversion + dotReading) / GRAPHS) << "ms" << endl;
+    cout << "\tCallgrind reading done in " << (callgrindReading / GRAPHS) << "ms" << endl;
+}
+
+void benchParallelReading(int size) {
+    std::stringstream out;
+    out << size;
+
+    string file = "../graphs/sparse" + out.str() + "_1";
+
+    cout << "Parallel reading of graph of size " << size << endl;
+
+    double sequential = 0;
+
+    for (unsigned int threads = 1; threads <= defaultThreads(); threads *= 2) {
+        double time = 0;
+
+        for (int i = 0; i < GRAPHS; ++i) {
+            Timer timer;
+
+            Infos infos;
+            GraphReader reader(infos);
+            reader.setThreads(threads);
+            delete reader.read(file);
+
+            time += timer.elapsed();
+        }
+
+        time /= GRAPHS;
+
+        if (threads == 1) {
+            sequential = time;
+        }
+
+        cout << "\t" << threads << " threads : reading done in " << time << "ms (speedup " << (sequential / time) << ")" << endl;
+    }
+}
+
+void benchParallelReadings() {
+    benchParallelReading(10000);
+    benchParallelReading(100000);
+    benchParallelReading(1000000);
+}
+
+void benchCompressed(int size) {
+    std::stringstream out;
+    out << size;
+
+    string file = "../graphs/sparse" + out.str() + "_1";
+    string compressed = file + ".gz";
+
+    string command = "gzip -c " + file + " > " + compressed;
+    if (system(command.c_str()) != 0) {
+        cout << "Compression of " << file << " failed" << endl;
+        return;
+    }
+
+    ifstream stream(file.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    double megabytes = stream.tellg() / (1024.0 * 1024.0);
+    stream.close();
+
+    double plainReading = 0;
+    double compressedReading = 0;
+
+    for (int i = 0; i < GRAPHS; ++i) {
+        Timer plainTimer;
+        Infos plainInfos;
+        StreamReader plainReader(plainInfos);
+        delete plainReader.read(file);
+        plainReading += plainTimer.elapsed();
+
+        Timer compressedTimer;
+        Infos compressedInfos;
+        StreamReader compressedReader(compressedInfos);
+        delete compressedReader.read(compressed);
+        compressedReading += compressedTimer.elapsed();
+    }
+
+    plainReading /= GRAPHS;
+    compressedReading /= GRAPHS;
+
+    cout << "Stream graph of size " << size << " (" << megabytes << "MB)" << endl;
+    cout << "\tPlain reading done in " << plainReading << "ms (" << (megabytes * 1000.0 / plainReading) << "MB/s)" << endl;
+    cout << "\tGzip reading done in " << compressedReading << "ms (" << (megabytes * 1000.0 / compressedReading) << "MB/s)" << endl;
+}
+
+void benchCompressedFiles() {
+    benchCompressed(10000);
+    benchCompressed(100000);
+    benchCompressed(1000000);
+}
+
+void benchSnapshot(int size) {
+    std::stringstream out;
+    out << size;
+
+    string file = "../graphs/sparse" + out.str() + "_1";
+    string snapshot = file + ".snapshot";
+
+    {
+        Infos infos;
+        GraphReader reader(infos);
+        CallGraph* graph = reader.read(file);
+
+        SnapshotWriter writer(infos);
+        if (!writer.write(*graph, snapshot)) {
+            delete graph;
+            return;
+        }
+
+        delete graph;
+    }
+
+    double dotLoading = 0;
+    double snapshotLoading = 0;
+
+    for (int i = 0; i < GRAPHS; ++i) {
+        Timer dotTimer;
+        Infos dotInfos;
+        GraphReader graphReader(dotInfos);
+        delete graphReader.read(file);
+        dotLoading += dotTimer.elapsed();
+
+        Timer snapshotTimer;
+        Infos snapshotInfos;
+        SnapshotReader snapshotReader(snapshotInfos);
+        delete snapshotReader.read(snapshot);
+        snapshotLoading += snapshotTimer.elapsed();
+    }
+
+    cout << "Load graph of size " << size << endl;
+    cout << "\tDot loading done in " << (dotLoading / GRAPHS) << "ms" << endl;
+    cout << "\tSnapshot loading done in " << (snapshotLoading / GRAPHS) << "ms" << endl;
+}
+
+//The decoding of a function label with a stringstream per number, as done before the tokenizer
+static void decodeWithStreams(const string& label, double& inclusiveCost, double& selfCost, unsigned int& calls) {
+    string::size_type firstPos = label.find("\\n");
+    string::size_type secondPos = label.find("\\n", firstPos + 2);
+    string::size_type thirdPos = label.find("\\n", secondPos + 2);
+
+    inclusiveCost = toNumber<double>(label.substr(firstPos + 2, secondPos - firstPos - 3));
+    selfCost = toNumber<double>(label.substr(secondPos + 3, thirdPos - secondPos - 4));
+    calls = toNumber<unsigned int>(label.substr(thirdPos + 2, label.length() - thirdPos - 4));
+}
+
+void benchLabels() {
+    const unsigned int LABELS = 1000000;
+
+    //Labels of the same form as the generated graphs
+    vector<string> labels;
+    for (unsigned int i = 0; i < LABELS; ++i) {
+        std::ostringstream label;
+        label << "_ZN11GraphReader16parseVertices" << i << "Ej\\n" << (rand() * 2000.0 / RAND_MAX) << "%\\n(" << (rand() * 200.0 / RAND_MAX) << "%)\\n" << (rand() % 100000) << "×";
+        labels.push_back(label.str());
+    }
+
+    double inclusiveCost = 0;
+    double selfCost = 0;
+    unsigned int calls = 0;
+    double sum = 0;
+
+    Timer streamTimer;
+
+    for (auto& label : labels) {
+        decodeWithStreams(label, inclusiveCost, selfCost, calls);
+        sum += inclusiveCost + selfCost + calls;
+    }
+
+    double streams = streamTimer.elapsed();
+
+    Timer tokenizerTimer;
+
+    for (auto& label : labels) {
+        decodeFunctionLabel(StringRef(label), inclusiveCost, selfCost, calls);
+        sum -= inclusiveCost + selfCost + calls;
+    }
+
+    double tokenizer = tokenizerTimer.elapsed();
+
+    fakeSum += sum;
+
+    //Both decodings must give the same numbers
+    unsigned int differences = 0;
+    for (auto& label : labels) {
+        double streamInclusiveCost = 0;
+        double streamSelfCost = 0;
+        unsigned int streamCalls = 0;
+
+        decodeWithStreams(label, streamInclusiveCost, streamSelfCost, streamCalls);
+        decodeFunctionLabel(StringRef(label), inclusiveCost, selfCost, calls);
+
+        differences += streamInclusiveCost != inclusiveCost || streamSelfCost != selfCost || streamCalls != calls;
+    }
+
+    cout << "Decode " << LABELS << " function labels" << endl;
+    cout << "\tStreams : " << (streams * 1000000.0 / LABELS) << "ns per label" << endl;
+    cout << "\tTokenizer : " << (tokenizer * 1000000.0 / LABELS) << "ns per label (speedup " << (streams / tokenizer) << ")" << endl;
+    cout << "\tDifferent results : " << differences << endl;
+}
+
+void benchSnapshots() {
+    benchSnapshot(1000);
+    benchSnapshot(10000);
+    benchSnapshot(100000);
+    benchSnapshot(1000000);
+}
+
+void benchCallgrindFiles() {
+    benchCallgrind("/home/wichtounet/dev/lbl/bench-files/callgrind.out.eddic");
+    benchCallgrind("/home/wichtounet/dev/lbl/bench-files/callgrind.out.clang");
+}
+
 void benchGraphs() {
     benchGraph(100);
     benchGraph(1000);
@@ -429,6 +1014,12 @@ void benchGraphs() {
     benchGraph(1000000);
 }
 
+void benchReorderings() {
+    benchReorderings(10000);
+    benchReorderings(100000);
+    benchReorderings(1000000);
+}
+
 void benchMemory() {
     benchMemory(100);
     benchMemory(1000);
@@ -436,6 +1027,20 @@ void benchMemory() {
     benchMemory(40000);
     benchMemory(100000);
     benchMemory(1000000);
+
+    benchLeanMemory(100000, false, false);
+    benchLeanMemory(100000, false, true);
+    benchLeanMemory(100000, true, false);
+    benchLeanMemory(100000, true, true);
+    benchLeanMemory(1000000, false, false);
+    benchLeanMemory(1000000, false, true);
+    benchLeanMemory(1000000, true, false);
+    benchLeanMemory(1000000, true, true);
+
+    benchOutOfCore(100000, false);
+    benchOutOfCore(100000, true);
+    benchOutOfCore(1000000, false);
+    benchOutOfCore(1000000, true);
 }
 
 void benchFiles() {
@@ -460,7 +1065,13 @@ void benchFiles() {
 }
 
 int main(int, const char*[]) {
+    benchLabels();
     benchGraphs();
+    benchReorderings();
+    benchParallelReadings();
+    benchCallgrindFiles();
+    benchSnapshots();
+    benchCompressedFiles();
     benchFiles();
     benchMemory();
 
@@ -94,7 +94,7 @@ void generate(string file, int vertices, int edges) {
 
         string module = libraries[rand() % lib];
 
-        outFile << "\t\"" << functions[vertice] << "\" [label=\"" << name << "\\n" << inclusive_cost << "%\\n(" << self_cost << "%)\\n" << calls << "×\", module = \"" << module << "\"];" << endl;
+        outFile << "\t\"" << functions[vertice] << "\" [label=\"" << name.str() << "\\n" << inclusive_cost << "%\\n(" << self_cost << "%)\\n" << calls << "×\", module = \"" << module << "\"];" << endl;
     }
 
     for (int edge = 0; edge < edges; edge++) {
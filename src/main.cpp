@@ -37,7 +37,7 @@ bool parse_value_arg(const std::string& arg, Inlining& inlining);
 
 int main(int argc, const char* argv[]) {
     if (argc < 2) {
-        cout << "Not enough arguments. Provide at least the dot file to read" << endl;
+        cout << "Not enough arguments. Provide at least the call graph file to read" << endl;
 
         return 1;
     }
@@ -50,52 +50,63 @@ int main(int argc, const char* argv[]) {
         return 0;
     }
 
-    //There are command line options
-    if (argc > 2) {
-        //Process command line options
-        for (int i = 1; i < argc - 1; ++i) {
-            string arg = argv[i];
-
-            if (arg == "--demangled") {
-                inlining.setDemangled(true);
-            } else if (arg == "--no-issues") {
-                inlining.setDisplayIssues(false);
-            } else if (arg == "--no-statistic") {
-                inlining.setDisplayStatistic(false);
-            } else if (arg == "--filter-duplicates") {
-                inlining.setFilterDuplicates(true);
-            } else if (arg == "--default-filters") {
-                inlining.enableDefaultFilters();
-            } else if (arg == "--help") {
-                printUsage();
-                return 0;
-            } else {
-                //Try to parse it as a value arg (--x=value)
-                if(parse_value_arg(arg, inlining)){
-                    continue;
-                }
+    vector<string> files;
+
+    //Process command line options, the other arguments are the call graph files
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
 
-                cout << "Unrecognized option : " << arg << endl;
-                return 1;
+        if (arg.substr(0, 2) != "--") {
+            files.push_back(arg);
+        } else if (arg == "--demangled") {
+            inlining.setDemangled(true);
+        } else if (arg == "--no-issues") {
+            inlining.setDisplayIssues(false);
+        } else if (arg == "--no-statistic") {
+            inlining.setDisplayStatistic(false);
+        } else if (arg == "--filter-duplicates") {
+            inlining.setFilterDuplicates(true);
+        } else if (arg == "--default-filters") {
+            inlining.enableDefaultFilters();
+        } else if (arg == "--boost-reader") {
+            inlining.setUseBoostReader(true);
+        } else if (arg == "--lean") {
+            inlining.setLean(true);
+        } else if (arg == "--help") {
+            printUsage();
+            return 0;
+        } else {
+            //Try to parse it as a value arg (--x=value)
+            if(parse_value_arg(arg, inlining)){
+                continue;
             }
+
+            cout << "Unrecognized option : " << arg << endl;
+            return 1;
         }
     }
 
-    //Test for existence of the file before anything else
-    string file = argv[argc - 1];
-    if (!fexists(file)) {
-        cout << "The file \"" << file << "\" does not exist" << endl;
+    if (files.empty()) {
+        cout << "Not enough arguments. Provide at least the call graph file to read" << endl;
         return 1;
     }
 
-    //Launch the full analysis
-    inlining.analyze(file);
+    //Test for existence of the files before anything else
+    for (auto& file : files) {
+        if (file != "-" && !fexists(file)) {
+            cout << "The file \"" << file << "\" does not exist" << endl;
+            return 1;
+        }
+    }
+
+    //Launch the full analysis, the runs are merged if there are several files
+    inlining.analyze(files);
 
     return 0;
 }
 
 bool parse_value_arg(const std::string& arg, Inlining& inlining){
-    if (arg.substr(0, 2) == "--" && arg.find("=") != string::npos) {
+    if (arg.substr(0, 2) != "--" || arg.find("=") == string::npos) {
         return false;
     }
 
@@ -109,12 +120,77 @@ bool parse_value_arg(const std::string& arg, Inlining& inlining){
 
             inlining.addFilter(value);
 
+            return true;
+        } else if (key == "format") {
+            string value = parts[1];
+
+            if (value == "dot") {
+                inlining.setFormat(DOT_FORMAT);
+            } else if (value == "callgrind") {
+                inlining.setFormat(CALLGRIND_FORMAT);
+            } else if (value == "snapshot") {
+                inlining.setFormat(SNAPSHOT_FORMAT);
+            } else if (value == "folded") {
+                inlining.setFormat(FOLDED_FORMAT);
+            } else if (value == "gmon") {
+                inlining.setFormat(GMON_FORMAT);
+            } else if (value == "perf") {
+                inlining.setFormat(PERF_FORMAT);
+            } else if (value == "pprof") {
+                inlining.setFormat(PPROF_FORMAT);
+            } else {
+                cout << "Unrecognized format : " << value << endl;
+                return false;
+            }
+
+            return true;
+        } else if (key == "reorder") {
+            string value = parts[1];
+
+            if (value == "rcm") {
+                inlining.setVertexOrder(RCM_ORDER);
+            } else if (value == "bfs") {
+                inlining.setVertexOrder(BFS_ORDER);
+            } else if (value == "module") {
+                inlining.setVertexOrder(MODULE_ORDER);
+            } else {
+                cout << "Unrecognized order : " << value << endl;
+                return false;
+            }
+
+            return true;
+        } else if (key == "event") {
+            inlining.setEvent(parts[1]);
+
+            return true;
+        } else if (key == "executable") {
+            inlining.setExecutable(parts[1]);
+
+            return true;
+        } else if (key == "snapshot") {
+            inlining.setSnapshot(parts[1]);
+
+            return true;
+        } else if (key == "weights") {
+            vector<string> values = split(parts[1], ",");
+
+            vector<double> weights;
+            for (auto& value : values) {
+                weights.push_back(toNumber<double>(value));
+            }
+
+            inlining.setWeights(weights);
+
             return true;
         }
 
         double value = toNumber<double>(parts[1]);
 
-        if (key == "heavy-call-site") {
+        if (key == "threads") {
+            inlining.setThreads(value);
+        } else if (key == "memory-cap") {
+            inlining.setMemoryCap(value);
+        } else if (key == "heavy-call-site") {
             Parameters::set(HEAVY_CALL_SITE, value);
         } else if (key == "hot-call-site") {
             Parameters::set(HOT_CALL_SITE, value);
@@ -158,7 +234,12 @@ bool parse_value_arg(const std::string& arg, Inlining& inlining){
 }
 
 void printUsage() {
-    cout << "Usage: analyzer [options] call_graph_file" << endl;
+    cout << "Usage: analyzer [options] call_graph_file [call_graph_file...]" << endl;
+    cout << "The call graph file is either a .dot file produced by converter.py, a callgrind.out file, a snapshot, folded stacks (flamegraph), a gmon.out file, a perf.data file or a pprof profile" << endl;
+    cout << "Use - as call graph file to analyze a .dot file streamed on the standard input (converter.py | analyzer -)" << endl;
+    cout << "The profiles can be compressed with gzip or zstd" << endl;
+    cout << "The other formats on the standard input need --format=<format>" << endl;
+    cout << "Several call graph files are merged into a single call graph (functions are aligned by module and name)" << endl;
     cout << "Options:" << endl;
     cout << "  --help                                               display this information" << endl;
     cout << "  --demangled                                          use a call graph with demangled function names" << endl;
@@ -166,7 +247,17 @@ void printUsage() {
     cout << "  --no-statistic                                       do not display the statistics" << endl;
     cout << "  --filter-duplicates                                  do not display several times library issues with the same solution" << endl;
     cout << "  --default-filters                                    activate the default function filters" << endl;
-    cout << "  --filter=<value>                                     filter the function <value>" << endl;
+    cout << "  --boost-reader                                       read the .dot file with boost instead of the fast reader" << endl;
+    cout << "  --lean                                               release the labels once decoded and compress the names to reduce the memory usage" << endl;
+    cout << "  --filter=<value>                                     filter the function <value>, all the functions starting with <value> if it ends with *" << endl;
+    cout << "  --format=<name>                                      the format of the call graph file (dot, callgrind, snapshot, folded, gmon, perf or pprof), detected by default" << endl;
+    cout << "  --snapshot=<file>                                    save the call graph in a binary snapshot that can be analyzed later" << endl;
+    cout << "  --weights=<w1,w2,...>                                the weight of each merged call graph, in the order of the files" << endl;
+    cout << "  --threads=<value> [cores]                            the number of threads to use" << endl;
+    cout << "  --reorder=<name>                                     renumber the functions before the analysis (rcm, bfs or module), the order of the profile by default" << endl;
+    cout << "  --memory-cap=<MB> [0]                                the size of the calls, the call sites, the labels or the frozen graph after which they are built in temporary files, 0 for no limit" << endl;
+    cout << "  --event=<name>                                       the event to use for the costs of a callgrind profile (the first one by default) or the sample type of a pprof profile" << endl;
+    cout << "  --executable=<file>                                  the program that generated a gmon.out profile, a.out by default" << endl;
     cout << "  --heavy-call-site=<value> [10000]                    the number of calls after which a call site is considered as heavy" << endl;
     cout << "  --hot-call-site=<value> [0.001]                      the temperature after which a call site is considered as hot" << endl;
     cout << "  --cluster-max-size=<value> [10]                      the maximum size of a cluster" << endl;